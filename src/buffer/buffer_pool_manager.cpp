@@ -1,23 +1,63 @@
 #include "buffer/buffer_pool_manager.h"
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager* disk_manager)
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager* disk_manager, ReplacerType replacer_type)
   : pool_size_(pool_size), disk_manager_(disk_manager) {
   pages_ = new Page[pool_size_]; // pages (buffer pool) is empty
-  replacer_ = new LRUReplacer(pool_size_);
+  switch (replacer_type) {
+    case ReplacerType::kClock:
+      replacer_ = new ClockReplacer(pool_size_);
+      break;
+    case ReplacerType::kLRUK:
+      replacer_ = new LRUKReplacer(pool_size_);
+      break;
+    case ReplacerType::kLRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size_);
+      break;
+  }
   for (size_t i = 0; i < pool_size_; i++) {
     free_list_.emplace_back(i);
   } // all the pages are free
+  prefetched_.resize(pool_size_, false);
+  delete_pending_.resize(pool_size_, false);
+  flusher_ = std::thread(&BufferPoolManager::BackgroundFlush, this);
+  prefetcher_ = std::thread(&BufferPoolManager::BackgroundPrefetch, this);
 }
 
+BufferPoolManager::BufferPoolManager(DiskManager* disk_manager)
+  : pool_size_(0), pages_(nullptr), disk_manager_(disk_manager), replacer_(nullptr) {}
+
 BufferPoolManager::~BufferPoolManager() {
+  if (flusher_.joinable()) {
+    {
+      std::scoped_lock<std::mutex> lock(flusher_latch_);
+      flusher_stop_ = true;
+    }
+    flusher_cv_.notify_one();
+    flusher_.join();
+  }
+  if (prefetcher_.joinable()) {
+    {
+      std::scoped_lock<std::mutex> lock(prefetch_latch_);
+      prefetch_stop_ = true;
+    }
+    prefetch_cv_.notify_one();
+    prefetcher_.join();
+  }
   FlushAllPages();
   delete[] pages_;
   delete replacer_;
 }
 
 Page* BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   auto result = page_table_.find(page_id);
@@ -27,133 +67,152 @@ Page* BufferPoolManager::FetchPage(page_id_t page_id) {
     Page* p = pages_ + frame_id; // find the page
     p->pin_count_++;
     replacer_->Pin(frame_id); // pin the page, because it might be unpinned
+    hit_count_++;
+    if (prefetched_[frame_id]) {
+      prefetched_[frame_id] = false;
+      prefetch_hit_count_++;
+    }
     return p;
   }
 
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
   //        Note that pages are always found from the free list first.
-  frame_id_t frame_id = INVALID_FRAME_ID;
-  Page* r = nullptr;
-  // get it from free_list
-  if (!free_list_.empty()) {
-    frame_id = free_list_.back();
-    free_list_.pop_back();
-    assert(frame_id >= 0 && frame_id < static_cast<int>(pool_size_));
-  }
-  // get it from replacer
-  else {
-    bool isReplacer = replacer_->Victim(&frame_id); // that unpinned page in replacer has been deleted
-    if (!isReplacer) {
-      return nullptr;
-    }
-    assert(frame_id >= 0 && frame_id < static_cast<int>(pool_size_));
-  }
-  r = pages_ + frame_id;
-  r->pin_count_ = 0;
-
   // 2.     If R is dirty, write it back to the disk.
-  if (r->IsDirty()) {
-    disk_manager_->WritePage(r->GetPageId(), r->GetData());
-    r->is_dirty_ = false;
-  }
-
   // 3.     Delete R from the page table and insert P.
-  page_table_.erase(r->GetPageId());
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  if (!GetVictimFrame(&frame_id)) {
+    return nullptr;
+  }
   page_table_[page_id] = frame_id;
 
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  Page* p = r; // always operate that page address, with page_id changed, data restored
+  Page* p = pages_ + frame_id; // always operate that page address, with page_id changed, data restored
   p->page_id_ = page_id;
   p->ResetMemory();
+  WaitForWriteBack(page_id);
   disk_manager_->ReadPage(page_id, p->GetData());
   p->pin_count_++;
+  replacer_->Pin(frame_id); // let the replacer see the access
+  miss_count_++;
   return p;
 }
 
 Page* BufferPoolManager::NewPage(page_id_t& page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call AllocatePage!
   page_id_t page_id_allocate = AllocatePage();
+  Page* p = NewPageImpl(page_id_allocate);
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
-  bool isAllPinned = true;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].pin_count_ == 0) {
-      isAllPinned = false;
-      break;
-    }
-  }
-  if (isAllPinned) {
+  if (p == nullptr) {
     DeallocatePage(page_id_allocate);
     return nullptr;
   }
+  // 4.   Set the page ID output parameter. Return a pointer to P.
+  page_id = page_id_allocate;
+  return p;
+}
 
+Page* BufferPoolManager::NewPageImpl(page_id_t page_id_allocate) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   frame_id_t frame_id = INVALID_FRAME_ID;
-  Page* p = nullptr;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.back();
-    free_list_.pop_back();
-    assert(frame_id >= 0 && frame_id < static_cast<int>(pool_size_));
-  }
-  // get it from replacer
-  else {
-    bool isReplacer = replacer_->Victim(&frame_id);
-    if (!isReplacer) {
-      return nullptr;
-    }
-    assert(frame_id >= 0 && frame_id < static_cast<int>(pool_size_));
-  }
-  p = pages_ + frame_id;
-  p->pin_count_ = 0;
-  // If P is dirty, write it back to the disk.
-  if (p->IsDirty()) {
-    disk_manager_->WritePage(p->GetPageId(), p->GetData());
-    p->is_dirty_ = false;
+  if (!GetVictimFrame(&frame_id)) {
+    return nullptr;
   }
 
   // 3.   Update P's metadata, zero out memory and add P to the page table.
-  page_table_.erase(p->GetPageId());
+  Page* p = pages_ + frame_id;
   p->page_id_ = page_id_allocate;
   page_table_[page_id_allocate] = frame_id;
   p->ResetMemory();
   p->pin_count_++;
-
-  // 4.   Set the page ID output parameter. Return a pointer to P.
-  page_id = page_id_allocate;
+  replacer_->Pin(frame_id); // let the replacer see the access
   return p;
 }
 
+bool BufferPoolManager::GetVictimFrame(frame_id_t* frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.back();
+    free_list_.pop_back();
+    assert(*frame_id >= 0 && *frame_id < static_cast<int>(pool_size_));
+    return true;
+  }
+  // get it from replacer
+  if (!replacer_->Victim(frame_id)) {
+    return false;
+  }
+  assert(*frame_id >= 0 && *frame_id < static_cast<int>(pool_size_));
+  Page* r = pages_ + *frame_id;
+  r->pin_count_ = 0;
+  // If R is dirty, write it back to the disk.
+  if (r->IsDirty()) {
+    WriteBack(r);
+  }
+  if (prefetched_[*frame_id]) {
+    // read ahead for nothing
+    prefetched_[*frame_id] = false;
+    prefetch_miss_count_++;
+  }
+  page_table_.erase(r->GetPageId());
+  return true;
+}
+
+void BufferPoolManager::WriteBack(Page* page) {
+  // an older copy may still be on its way to disk
+  WaitForWriteBack(page->GetPageId());
+  disk_manager_->WritePage(page->GetPageId(), page->GetData());
+  auto prefetch = prefetch_in_flight_.find(page->GetPageId());
+  if (prefetch != prefetch_in_flight_.end()) {
+    prefetch->second = true;
+  }
+  SetClean(page);
+}
+
+void BufferPoolManager::WaitForWriteBack(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(write_back_latch_);
+  write_back_cv_.wait(lock, [&] { return write_back_in_flight_.find(page_id) == write_back_in_flight_.end(); });
+}
+
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-  // 0.   Make sure you call DeallocatePage!
-  DeallocatePage(page_id);
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  WaitForWriteBack(page_id);
   // 1.   Search the page table for the requested page (P).
-  //      If P does not exist, return true.
+  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page, P is deleted at its
+  //      last unpin, so its page id is not handed out again while it is still pinned.
   auto result = page_table_.find(page_id);
-  if (result == page_table_.end()) {
-    return true;
+  if (result != page_table_.end() && pages_[result->second].pin_count_ != 0) {
+    delete_pending_[result->second] = true;
+    return false;
+  }
+  // 0.   Make sure you call DeallocatePage!
+  DeallocatePage(page_id);
+  auto prefetch = prefetch_in_flight_.find(page_id);
+  if (prefetch != prefetch_in_flight_.end()) {
+    prefetch->second = true;
   }
-
-  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  else {
-    frame_id_t frame_id = result->second;
-    Page* p = pages_ + frame_id; // find the page
-    if (p->pin_count_ != 0) {
-      return false;
-    }
-    else {
-      page_table_.erase(page_id);
-      p->pin_count_ = 0;
-      p->is_dirty_ = false;
-      p->page_id_ = INVALID_PAGE_ID;
-      p->ResetMemory();
-      free_list_.push_back(frame_id);
-      return true;
-    }
+  if (result != page_table_.end()) {
+    FreeFrame(result->second);
   }
+  return true;
+}
+
+void BufferPoolManager::FreeFrame(frame_id_t frame_id) {
+  Page* p = pages_ + frame_id;
+  page_table_.erase(p->page_id_);
+  replacer_->Remove(frame_id); // the frame goes to the free list, it must not be victimized as well
+  p->pin_count_ = 0;
+  SetClean(p);
+  prefetched_[frame_id] = false;
+  delete_pending_[frame_id] = false;
+  p->page_id_ = INVALID_PAGE_ID;
+  p->ResetMemory();
+  free_list_.push_back(frame_id);
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-  // Process is_dirty lazily when that page be victimized by replacer
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  // Process is_dirty lazily, the page is written back by the flusher or when it is victimized by replacer
   auto result = page_table_.find(page_id);
   if (result == page_table_.end()) {
     return false;
@@ -162,13 +221,17 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
     frame_id_t frame_id = result->second;
     Page* p = pages_ + frame_id;
     if (p->pin_count_ > 0) p->pin_count_--;
+    if (is_dirty) {
+      SetDirty(p);
+    }
 
     // Only call replacer's unpin when pin_count = 0
     if (p->pin_count_ == 0) {
-      replacer_->Unpin(frame_id);
-      if (is_dirty) {
-        disk_manager_->WritePage(page_id, p->GetData());
-        p->is_dirty_ = false;
+      if (delete_pending_[frame_id]) {
+        DeallocatePage(page_id);
+        FreeFrame(frame_id);
+      } else {
+        replacer_->Unpin(frame_id);
       }
     }
     return true;
@@ -176,6 +239,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   auto result = page_table_.find(page_id);
   if (result == page_table_.end()) {
     return false;
@@ -183,11 +247,201 @@ bool BufferPoolManager::FlushPage(page_id_t page_id) {
   else {
     frame_id_t frame_id = result->second;
     Page* p = pages_ + frame_id;
-    disk_manager_->WritePage(page_id, p->GetData());
+    // a clean frame already matches the disk
+    if (p->IsDirty()) {
+      WriteBack(p);
+    }
     return true;
   }
 }
 
+void BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    if (page_table_.find(page_id) != page_table_.end()) {
+      return;
+    }
+  }
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_latch_);
+    // never queue more read ahead than a fraction of the pool can hold
+    if (prefetch_queue_.size() >= pool_size_ / 4) {
+      return;
+    }
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManager::BackgroundPrefetch() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return prefetch_stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_stop_) {
+      break;
+    }
+    // everything queued so far is read concurrently
+    std::vector<page_id_t> page_ids(prefetch_queue_.begin(), prefetch_queue_.end());
+    prefetch_queue_.clear();
+    lock.unlock();
+    LoadPrefetchedPages(page_ids);
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::LoadPrefetchedPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<page_id_t> reads;
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    for (auto page_id : page_ids) {
+      if (free_list_.empty() && replacer_->Size() == 0) {
+        break;
+      }
+      if (page_table_.find(page_id) != page_table_.end() ||
+          prefetch_in_flight_.find(page_id) != prefetch_in_flight_.end()) {
+        continue;
+      }
+      {
+        std::scoped_lock<std::mutex> write_back_lock(write_back_latch_);
+        if (write_back_in_flight_.find(page_id) != write_back_in_flight_.end()) {
+          continue;
+        }
+      }
+      prefetch_in_flight_[page_id] = false;
+      reads.push_back(page_id);
+    }
+  }
+  // read without holding the latch, foreground requests go on meanwhile
+  std::vector<char> data(reads.size() * PAGE_SIZE);
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i < reads.size(); i++) {
+    futures.push_back(disk_manager_->ReadPageAsync(reads[i], data.data() + i * PAGE_SIZE));
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  for (size_t i = 0; i < reads.size(); i++) {
+    page_id_t page_id = reads[i];
+    bool stale = prefetch_in_flight_[page_id];
+    prefetch_in_flight_.erase(page_id);
+    // someone fetched the page meanwhile, or a write back made our copy stale
+    if (stale || page_table_.find(page_id) != page_table_.end()) {
+      continue;
+    }
+    frame_id_t frame_id = INVALID_FRAME_ID;
+    if (!GetVictimFrame(&frame_id)) {
+      continue;
+    }
+    Page* p = pages_ + frame_id;
+    p->page_id_ = page_id;
+    p->pin_count_ = 0;
+    memcpy(p->GetData(), data.data() + i * PAGE_SIZE, PAGE_SIZE);
+    page_table_[page_id] = frame_id;
+    // the read ahead counts as an access, otherwise LRU-K would rank the page older than every page in the pool
+    replacer_->Pin(frame_id);
+    replacer_->Unpin(frame_id);
+    prefetched_[frame_id] = true;
+  }
+}
+
+void BufferPoolManager::SetDirtyWatermarks(double low_watermark, double high_watermark) {
+  ASSERT(low_watermark <= high_watermark, "Low watermark must not exceed high watermark.");
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  low_watermark_ = low_watermark;
+  high_watermark_ = high_watermark;
+}
+
+size_t BufferPoolManager::GetDirtyCount() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  std::scoped_lock<std::mutex> write_back_lock(write_back_latch_);
+  // pages being written back are not on disk yet either
+  return dirty_count_ + write_back_in_flight_.size();
+}
+
+void BufferPoolManager::SetDirty(Page* page) {
+  if (!page->is_dirty_) {
+    page->is_dirty_ = true;
+    dirty_count_++;
+    if (dirty_count_ > high_watermark_ * pool_size_) {
+      flusher_cv_.notify_one();
+    }
+  }
+}
+
+void BufferPoolManager::SetClean(Page* page) {
+  if (page->is_dirty_) {
+    page->is_dirty_ = false;
+    dirty_count_--;
+  }
+}
+
+void BufferPoolManager::BackgroundFlush() {
+  std::unique_lock<std::mutex> lock(flusher_latch_);
+  while (!flusher_stop_) {
+    flusher_cv_.wait_for(lock, std::chrono::milliseconds(BACKGROUND_FLUSH_INTERVAL_MS));
+    if (flusher_stop_) {
+      break;
+    }
+    size_t target;
+    {
+      std::scoped_lock<std::recursive_mutex> pool_lock(latch_);
+      if (dirty_count_ <= high_watermark_ * pool_size_) {
+        continue;
+      }
+      target = static_cast<size_t>(low_watermark_ * pool_size_);
+    }
+    lock.unlock();
+    FlushDirtyPages(target);
+    lock.lock();
+  }
+}
+
+void BufferPoolManager::FlushDirtyPages(size_t target) {
+  std::vector<page_id_t> page_ids;
+  std::vector<char> data;
+  {
+    std::scoped_lock<std::recursive_mutex> lock(latch_);
+    std::vector<std::pair<page_id_t, frame_id_t>> dirty_pages;
+    for (auto &entry : page_table_) {
+      Page* p = pages_ + entry.second;
+      if (p->is_dirty_ && p->pin_count_ == 0) {
+        dirty_pages.emplace_back(entry);
+      }
+    }
+    // write in page id order so the disk sees mostly sequential writes
+    std::sort(dirty_pages.begin(), dirty_pages.end());
+    // pages are written from copies, so the frames can be reused before the writes complete
+    for (auto &entry : dirty_pages) {
+      if (dirty_count_ <= target) {
+        break;
+      }
+      Page* p = pages_ + entry.second;
+      page_ids.push_back(entry.first);
+      data.insert(data.end(), p->GetData(), p->GetData() + PAGE_SIZE);
+      auto prefetch = prefetch_in_flight_.find(entry.first);
+      if (prefetch != prefetch_in_flight_.end()) {
+        prefetch->second = true;
+      }
+      SetClean(p);
+    }
+    std::scoped_lock<std::mutex> write_back_lock(write_back_latch_);
+    write_back_in_flight_.insert(page_ids.begin(), page_ids.end());
+  }
+  // keep all the writes in flight at once, later fetches of these pages wait in WaitForWriteBack
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    page_id_t page_id = page_ids[i];
+    disk_manager_->WritePageAsync(page_id, data.data() + i * PAGE_SIZE, [this, page_id] {
+      std::scoped_lock<std::mutex> lock(write_back_latch_);
+      write_back_in_flight_.erase(page_id);
+      write_back_cv_.notify_all();
+    });
+  }
+  for (auto page_id : page_ids) {
+    WaitForWriteBack(page_id);
+  }
+}
+
 page_id_t BufferPoolManager::AllocatePage() {
   int next_page_id = disk_manager_->AllocatePage();
   return next_page_id;
@@ -203,6 +457,7 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 
 // Only used for debug and test
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -214,7 +469,17 @@ bool BufferPoolManager::CheckAllUnpinned() {
 }
 
 bool BufferPoolManager::FlushAllPages() {
+  bool res = FlushAllPagesImpl();
+  // durability point: page writes themselves are not synced
+  disk_manager_->Sync();
+  return res;
+}
+
+bool BufferPoolManager::FlushAllPagesImpl() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
+  bool res = true;
   for (auto page : page_table_) {
-    FlushPage(page.first);
+    res = FlushPage(page.first) && res;
   }
+  return res;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "buffer/clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_pages) : flags_(num_pages, 0) {}
+
+ClockReplacer::~ClockReplacer() = default;
+
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  if (size_ == 0) {
+    return false;
+  }
+  // at most one full sweep clears every reference bit, the second one must find a victim
+  while (true) {
+    uint8_t &flag = flags_[hand_];
+    size_t cur = hand_;
+    hand_ = hand_ + 1 == flags_.size() ? 0 : hand_ + 1;
+    if (flag & IN_CLOCK) {
+      if (flag & REFERENCED) {
+        flag &= ~REFERENCED;
+      } else {
+        flag = 0;
+        size_--;
+        *frame_id = static_cast<frame_id_t>(cur);
+        return true;
+      }
+    }
+  }
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  uint8_t &flag = flags_[frame_id];
+  if (flag & IN_CLOCK) {
+    flag = 0;
+    size_--;
+  }
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  uint8_t &flag = flags_[frame_id];
+  if (!(flag & IN_CLOCK)) {
+    size_++;
+  }
+  flag = IN_CLOCK | REFERENCED;
+}
+
+size_t ClockReplacer::Size() {
+  return size_;
+}
@@ -0,0 +1,69 @@
+#include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : k_(k), history_(num_pages * k, 0), access_count_(num_pages, 0), evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  if (evict_set_.empty()) {
+    return false;
+  }
+  auto victim = evict_set_.begin();
+  *frame_id = std::get<2>(*victim);
+  evict_set_.erase(victim);
+  evictable_[*frame_id] = false;
+  ClearHistory(*frame_id);
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evict_set_.erase(GetEvictKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  // record the access, keeping the K most recent timestamps ordered from oldest to newest
+  uint64_t *history = &history_[frame_id * k_];
+  if (access_count_[frame_id] < k_) {
+    history[access_count_[frame_id]++] = current_timestamp_++;
+  } else {
+    for (size_t i = 0; i + 1 < k_; i++) {
+      history[i] = history[i + 1];
+    }
+    history[k_ - 1] = current_timestamp_++;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    return;
+  }
+  evictable_[frame_id] = true;
+  evict_set_.insert(GetEvictKey(frame_id));
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evict_set_.erase(GetEvictKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  ClearHistory(frame_id);
+}
+
+size_t LRUKReplacer::Size() {
+  return evict_set_.size();
+}
+
+LRUKReplacer::EvictKey LRUKReplacer::GetEvictKey(frame_id_t frame_id) const {
+  // frames with fewer than K accesses have infinite K-distance and go first, ordered by their first access;
+  // otherwise the oldest of the K most recent accesses has the largest K-distance
+  return EvictKey(access_count_[frame_id] >= k_, history_[frame_id * k_], frame_id);
+}
+
+void LRUKReplacer::ClearHistory(frame_id_t frame_id) {
+  // the next page in the frame must not be ranked by the accesses of the previous one
+  std::fill(history_.begin() + frame_id * k_, history_.begin() + (frame_id + 1) * k_, 0);
+  access_count_[frame_id] = 0;
+}
@@ -0,0 +1,120 @@
+#include "buffer/parallel_buffer_pool_manager.h"
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, ReplacerType replacer_type)
+    : BufferPoolManager(disk_manager) {
+  ASSERT(num_instances > 0, "Need at least one buffer pool instance.");
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.push_back(new BufferPoolManager(pool_size, disk_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto instance : instances_) {
+    delete instance;
+  }
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPage(page_id_t &page_id) {
+  // the disk manager decides the page id, which decides the instance holding it
+  page_id_t page_id_allocate = disk_manager_->AllocatePage();
+  Page *p = GetBufferPoolManager(page_id_allocate)->NewPageImpl(page_id_allocate);
+  if (p == nullptr) {
+    disk_manager_->DeAllocatePage(page_id_allocate);
+    return nullptr;
+  }
+  page_id = page_id_allocate;
+  return p;
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::PrefetchPage(page_id_t page_id) {
+  GetBufferPoolManager(page_id)->PrefetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::CheckAllUnpinned() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->CheckAllUnpinned() && res;
+  }
+  return res;
+}
+
+bool ParallelBufferPoolManager::FlushAllPages() {
+  bool res = true;
+  for (auto instance : instances_) {
+    res = instance->FlushAllPagesImpl() && res;
+  }
+  // the instances share one disk manager, a single sync covers them all
+  disk_manager_->Sync();
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetPoolSize();
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetHitCount() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetHitCount();
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetMissCount() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetMissCount();
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetPrefetchHitCount() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetPrefetchHitCount();
+  }
+  return res;
+}
+
+size_t ParallelBufferPoolManager::GetPrefetchMissCount() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetPrefetchMissCount();
+  }
+  return res;
+}
+
+void ParallelBufferPoolManager::SetDirtyWatermarks(double low_watermark, double high_watermark) {
+  for (auto instance : instances_) {
+    instance->SetDirtyWatermarks(low_watermark, high_watermark);
+  }
+}
+
+size_t ParallelBufferPoolManager::GetDirtyCount() {
+  size_t res = 0;
+  for (auto instance : instances_) {
+    res += instance->GetDirtyCount();
+  }
+  return res;
+}
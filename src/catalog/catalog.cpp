@@ -1,5 +1,10 @@
 #include "catalog/catalog.h"
 
+#include <algorithm>
+#include <thread>
+
+#include "storage/table_heap.h"
+
 // serialize map by writing map's size then map's every pair of key and value 
 template <class T, class V>
 uint32_t map_serialize(char *buf, std::map<T, V> mapA){
@@ -139,7 +144,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     
     page_id_t this_table_heap_page = tp->GetFirstPageId();
     TableMetadata *tm;
-    tm = tm->Create(this_table_id, table_name, this_table_heap_page, schema, heap_);
+    tm = tm->Create(this_table_id, table_name, this_table_heap_page, schema, heap_, tp->GetFreeSpaceMapPageId());
     table_info = table_info->Create(heap_);
     table_info->Init(tm, tp);
     tables_[this_table_id] = table_info;
@@ -180,7 +185,7 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) 
+                                    IndexInfo *&index_info, IndexType index_type) 
 {
   auto it_table = index_names_.find(table_name);
   if(it_table == index_names_.end())
@@ -214,10 +219,26 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
         }
       }
       uint32_t this_index_id = next_index_id_.load();
-      it_table->second[index_name] = this_index_id;
-      im = IndexMetadata::Create(this_index_id, index_name, table_names_.find(table_name)->second, this_key_map_, heap_);
+      im = IndexMetadata::Create(this_index_id, index_name, table_names_.find(table_name)->second, this_key_map_, heap_,
+                                 index_type);
       index_info = index_info->Create(heap_);
       index_info->Init(im, ti, buffer_pool_manager_);
+      // build the index from the rows already in the table, with a worker per core
+      size_t num_threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), MAX_INDEX_BUILD_THREADS);
+      dberr_t load_status = index_info->GetIndex()->BulkLoad(ti->GetTableHeap(), this_key_map_, DEFAULT_INDEX_FILL_FACTOR,
+                                                             num_threads, txn);
+      if(load_status != DB_SUCCESS)
+      {
+        // release the pages of the partly built index and its metadata, the index was never registered
+        index_info->GetIndex()->Destroy();
+        index_info->~IndexInfo();
+        heap_->Free(index_info);
+        index_info = nullptr;
+        im->~IndexMetadata();
+        heap_->Free(im);
+        return load_status;
+      }
+      it_table->second[index_name] = this_index_id;
       indexes_[this_index_id] = index_info;
       next_index_id_++;
       page_id_t this_index_page;
@@ -336,7 +357,8 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const
 {
   Page *p = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
   catalog_meta_->SerializeTo(p->GetData());
-  buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID);    
+  buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, true);
+  buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID);
   return DB_SUCCESS;
 }
 
@@ -348,7 +370,15 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
 
 
   TableHeap *th;
-  th = th->Create(buffer_pool_manager_, tm->GetFirstPageId(), tm->GetSchema(), log_manager_, lock_manager_, heap_);
+  th = th->Create(buffer_pool_manager_, tm->GetFirstPageId(), tm->GetFreeSpaceMapPageId(), tm->GetSchema(),
+                  log_manager_, lock_manager_, heap_);
+  if (tm->GetFreeSpaceMapPageId() == INVALID_PAGE_ID) {
+    // legacy metadata, remember the rebuilt free space map so it is loaded next time
+    tm = tm->Create(table_id, tm->GetTableName(), tm->GetFirstPageId(), tm->GetSchema(), heap_,
+                    th->GetFreeSpaceMapPageId());
+    tm->SerializeTo(p->GetData());
+    buffer_pool_manager_->UnpinPage(page_id, true);
+  }
 
   TableInfo *ti;
   ti = ti->Create(heap_);
@@ -22,6 +22,10 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   MACH_WRITE_TO(page_id_t, buf + offset, root_page_id_);
   offset += sizeof(page_id_t);
 
+  //write free space map page_id
+  MACH_WRITE_TO(page_id_t, buf + offset, free_space_map_page_id_);
+  offset += sizeof(page_id_t);
+
   //write schema
   offset += schema_->SerializeTo(buf+offset);
 
@@ -29,7 +33,7 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
 }
 
 uint32_t TableMetadata::GetSerializedSize() const {
-  return sizeof(table_id_t) + sizeof(page_id_t) + sizeof(uint32_t) * 2
+  return sizeof(table_id_t) + sizeof(page_id_t) * 2 + sizeof(uint32_t) * 2
   + table_name_.size() * sizeof(char) + schema_->GetSerializedSize();
 }
 
@@ -59,12 +63,20 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   page_id_t temp_root_page_id_ = MACH_READ_FROM(page_id_t, buf + offset);
   offset += sizeof(page_id_t);
 
+  //read free space map page_id
+  page_id_t temp_free_space_map_page_id_ = INVALID_PAGE_ID;
+  if (temp_magic_num != TABLE_METADATA_MAGIC_NUM_LEGACY) {
+    temp_free_space_map_page_id_ = MACH_READ_FROM(page_id_t, buf + offset);
+    offset += sizeof(page_id_t);
+  }
+
   //read schema
   Schema *schema = nullptr;
   offset += schema->DeserializeFrom(buf + offset, schema, heap);
 
   void *mem = heap->Allocate(sizeof(TableMetadata));
-  table_meta = new(mem)TableMetadata(temp_table_id_, temp_table_name_, temp_root_page_id_, schema);
+  table_meta = new(mem)TableMetadata(temp_table_id_, temp_table_name_, temp_root_page_id_, schema,
+                                     temp_free_space_map_page_id_);
 
   return offset;
 }
@@ -75,11 +87,14 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name,
-                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap) {
+                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap,
+                                     page_id_t free_space_map_page_id) {
   // allocate space for table metadata
   void *buf = heap->Allocate(sizeof(TableMetadata));
-  return new(buf)TableMetadata(table_id, table_name, root_page_id, schema);
+  return new(buf)TableMetadata(table_id, table_name, root_page_id, schema, free_space_map_page_id);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                             page_id_t free_space_map_page_id)
+        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id),
+          free_space_map_page_id_(free_space_map_page_id), schema_(schema) {}
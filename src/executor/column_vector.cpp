@@ -0,0 +1,100 @@
+#include "executor/column_vector.h"
+
+/**
+ * ColumnVector
+ */
+void ColumnVector::Clear() {
+  size_ = 0;
+  null_count_ = 0;
+  ints_.clear();
+  floats_.clear();
+  chars_.clear();
+  offsets_.resize(1);
+  nulls_.clear();
+}
+
+void ColumnVector::AppendNull(bool is_null) {
+  if ((size_ & 63) == 0) {
+    nulls_.push_back(0);
+  }
+  if (is_null) {
+    nulls_.back() |= uint64_t(1) << (size_ & 63);
+    null_count_++;
+  }
+}
+
+void ColumnVector::Append(const Field &field) {
+  ASSERT(field.type_id_ == type_, "Column type mismatch.");
+  bool is_null = field.IsNull();
+  AppendNull(is_null);
+  switch (type_) {
+    case TypeId::kTypeInt:
+      ints_.push_back(is_null ? 0 : field.value_.integer_);
+      break;
+    case TypeId::kTypeFloat:
+      floats_.push_back(is_null ? 0 : field.value_.float_);
+      break;
+    default:
+      if (!is_null) {
+        chars_.append(field.value_.chars_, field.len_);
+      }
+      offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+      break;
+  }
+  size_++;
+}
+
+void ColumnVector::Append(const RowView &row, uint32_t column_index) {
+  bool is_null = row.IsNull(column_index);
+  AppendNull(is_null);
+  switch (type_) {
+    case TypeId::kTypeInt:
+      ints_.push_back(is_null ? 0 : row.GetInt(column_index));
+      break;
+    case TypeId::kTypeFloat:
+      floats_.push_back(is_null ? 0 : row.GetFloat(column_index));
+      break;
+    default:
+      if (!is_null) {
+        chars_.append(row.GetChars(column_index));
+      }
+      offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+      break;
+  }
+  size_++;
+}
+
+/**
+ * RowBatch
+ */
+RowBatch::RowBatch(const Schema *schema) {
+  for (auto column : schema->GetColumns()) {
+    columns_.emplace_back(column->GetType());
+  }
+}
+
+void RowBatch::Clear() {
+  for (auto &column : columns_) {
+    column.Clear();
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void RowBatch::Append(const Row &row) {
+  ASSERT(row.GetFieldCount() == columns_.size(), "Row does not match the batch schema.");
+  selection_.push_back(GetSize());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(*row.GetField(i));
+  }
+  rids_.push_back(row.GetRowId());
+}
+
+void RowBatch::Append(const RowView &row) {
+  ASSERT(row.GetFieldCount() == columns_.size(), "Row does not match the batch schema.");
+  selection_.push_back(GetSize());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(row, i);
+  }
+  rids_.push_back(row.GetRowId());
+}
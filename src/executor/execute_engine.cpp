@@ -55,15 +55,6 @@ ExecuteEngine::ExecuteEngine()
 }
 
 
-bool RowId_compare(RowId x, RowId y){
-  //对RowId进行比较
-  if(x.GetPageId() < y.GetPageId())return true;
-  else if(x.GetPageId() == y.GetPageId()){
-    if(x.GetSlotNum() < y.GetSlotNum())return true;
-  }
-  return false;
-}
-
 dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
   if (ast == nullptr) {
     return DB_FAILED;
@@ -421,37 +412,53 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   std::vector<std::string> keys;
   pSyntaxNode childpointer = NodePointer->child_;
   while(childpointer != NULL){
-    //only unique key can create index
     uint32_t idx;
-    table_info->GetSchema()->GetColumnIndex((std::string)childpointer->val_,idx);
-    if(!table_info->GetSchema()->GetColumn(idx)->IsUnique()){
-      cout<<"Error: Index can only be create on unique keys."<<endl;
+    if(table_info->GetSchema()->GetColumnIndex((std::string)childpointer->val_,idx) != DB_SUCCESS){
+      cout<<"Error: Column not exists."<<endl;
       return DB_FAILED;
     }
     keys.push_back((std::string)childpointer->val_);
     childpointer = childpointer->next_;
   }
 
-  // 创建Index
-  IndexInfo* New_index_info = NULL;
-  db->catalog_mgr_->CreateIndex(table_name, index_name, keys, NULL, New_index_info);
-  vector<uint32_t>index_column_num;
-  for(auto i = keys.begin(); i != keys.end(); i++){
-    uint32_t idx;
-    table_info->GetSchema()->GetColumnIndex(*i, idx);
-    index_column_num.push_back(idx);
+// 获取Index类型，默认为B+树
+  IndexType index_type = IndexType::kBPlusTree;
+  NodePointer = NodePointer->next_;
+  if(NodePointer != NULL && NodePointer->type_ == kNodeIndexType){
+    std::string type_name = (std::string)NodePointer->child_->val_;
+    std::transform(type_name.begin(), type_name.end(), type_name.begin(), ::tolower);
+    if(type_name == "hash"){
+      index_type = IndexType::kHash;
+    }
+    else if(type_name != "btree"){
+      cout<<"Error: Unknown index type."<<endl;
+      return DB_FAILED;
+    }
   }
-
-  // 把当前表中数据传入Index
-  for(auto i = table_info->GetTableHeap()->Begin(NULL); i != table_info->GetTableHeap()->End(); i++){
-    vector<Field> index_fields;
-    Row *temp_row = new Row(i->GetRowId());
-    table_info->GetTableHeap()->GetTuple(temp_row, NULL);
-    for(auto j=index_column_num.begin(); j != index_column_num.end(); j++){
-      index_fields.push_back(*(temp_row->GetField(*j)));
+  // hash索引不区分重复的键，只能建立在unique的键上
+  if(index_type == IndexType::kHash){
+    bool unique = false;
+    for(auto key : keys){
+      uint32_t idx;
+      table_info->GetSchema()->GetColumnIndex(key, idx);
+      unique = unique || table_info->GetSchema()->GetColumn(idx)->IsUnique();
+    }
+    if(!unique){
+      cout<<"Error: Hash index can only be created on unique keys."<<endl;
+      return DB_FAILED;
     }
-    Row index_row(index_fields);
-    New_index_info->GetIndex()->InsertEntry(index_row, i->GetRowId(), NULL);
+  }
+
+  // 创建Index，并由CatalogManager把当前表中数据并行地批量导入Index
+  IndexInfo* New_index_info = NULL;
+  dberr_t status = db->catalog_mgr_->CreateIndex(table_name, index_name, keys, NULL, New_index_info, index_type);
+  if(status == DB_KEY_ALREADY_EXIST){
+    cout<<"Error: Duplicate key in existing rows, unique index cannot be built."<<endl;
+    return status;
+  }
+  if(status != DB_SUCCESS){
+    cout<<"Error: Failed to build index on existing rows."<<endl;
+    return status;
   }
 
   std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
@@ -495,6 +502,27 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_SUCCESS;
 }
 
+/**
+ * @brief 按 Field::GetData 的格式输出 column 中的第 i 个值
+ */
+static void PrintValue(const ColumnVector &column, uint32_t i) {
+  if(column.IsNull(i)){
+    cout<<"null";
+    return;
+  }
+  if(column.GetType() == kTypeInt){
+    cout<<column.GetInts()[i];
+  }
+  else if(column.GetType() == kTypeFloat){
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%f", column.GetFloats()[i]);
+    cout<<buf;
+  }
+  else{
+    cout<<column.GetString(i);
+  }
+}
+
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   std::chrono::high_resolution_clock::time_point beginTime = std::chrono::high_resolution_clock::now();
 #ifdef ENABLE_EXECUTE_DEBUG
@@ -502,65 +530,67 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
 #endif
   DBStorageEngine* db = dbs_.find(current_db_)->second;
   pSyntaxNode NodePointer = ast->child_;
-  std::vector<std::string> columnList;
+  pSyntaxNode ColumnPointer = NodePointer;
+  NodePointer = NodePointer->next_;
+  std::string table_name = (std::string)NodePointer->val_;
   TableInfo* table_info = NULL;
-  std::string table_name;
-
-  // 获取需要选取的Column名称
-  if(NodePointer->type_ == kNodeAllColumns){
-    //LOG(INFO) << "ExecuteSelect check0.1" << std::endl;
-    NodePointer = NodePointer->next_;
-    table_name = (std::string)NodePointer->val_;
-    db->catalog_mgr_->GetTable(table_name, table_info);
-    if(table_info == NULL)
-    {
-      cout << "table not exist" << endl;
-      return DB_TABLE_NOT_EXIST;
-    }
+  db->catalog_mgr_->GetTable(table_name, table_info);
+  if(table_info == NULL)
+  {
+    cout << "table not exist" << endl;
+    return DB_TABLE_NOT_EXIST;
+  }
+
+  // 获取需要选取的Column下标
+  std::vector<uint32_t> column_indexes;
+  if(ColumnPointer->type_ == kNodeAllColumns){
     uint32_t cnt = table_info->GetSchema()->GetColumnCount();
     for(uint32_t i = 0; i < cnt; i++){
-      columnList.push_back(table_info->GetSchema()->GetColumn(i)->GetName());
+      column_indexes.push_back(i);
     }
   }
   else{
-    pSyntaxNode childs = NodePointer->child_;
-    while(childs!=NULL){
-      columnList.push_back((std::string)childs->val_);
-      childs = childs->next_;
-    }  
-    NodePointer = NodePointer->next_;
-    table_name = (std::string)NodePointer->val_;
-    db->catalog_mgr_->GetTable(table_name, table_info);
+    for(pSyntaxNode childs = ColumnPointer->child_; childs != NULL; childs = childs->next_){
+      uint32_t idx;
+      if(table_info->GetSchema()->GetColumnIndex(childs->val_, idx) != DB_SUCCESS){
+        cout << "column not exist" << endl;
+        return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      column_indexes.push_back(idx);
+    }
   }
 
-  // 根据条件筛选对应Row
-  std::vector<RowId> res;
-  NodePointer = NodePointer->next_;
-  if(NodePointer != NULL){
-    res = Condition(NodePointer->child_, table_name);
+  // 有可用的索引时按批执行 IndexScan -> Filter，否则按批执行 SeqScan -> Filter，一边执行一边输出；
+  // 两种扫描都直接从页中的字节解码出批，不构造 Row
+  pSyntaxNode condition = NodePointer->next_;
+  Predicate *predicate = NULL;
+  if(condition != NULL){
+    predicate = Predicate::Create(condition->child_, table_info->GetSchema());
+    if(predicate == NULL){
+      cout << "column not exist" << endl;
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
   }
-  else{
-    TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-    TableIterator End = table_info->GetTableHeap()->End();
-    while(Iterator != End){
-      res.push_back(Iterator->GetRowId());
-      ++Iterator;
+  IndexScanExecutor *index_scan = condition == NULL ? NULL : PlanIndexScan(condition->child_, table_info, context->txn_);
+  VectorizedExecutor *plan;
+  if(index_scan != NULL)plan = new VectorizedIndexScanExecutor(index_scan, context->txn_);
+  else plan = new VectorizedSeqScanExecutor(table_info, context->txn_);
+  if(predicate != NULL)plan = new VectorizedFilterExecutor(plan, predicate);
+  int i = 0;
+  plan->Open();
+  for(RowBatch *batch = plan->Next(); batch != NULL; batch = plan->Next()){
+    for(auto row : batch->GetSelection()){
+      for(auto idx : column_indexes){
+        cout<<" ";
+        PrintValue(batch->GetColumn(idx), row);
+        cout<<" ";
       }
-  }
-
-  // 输出每个Row的内容
-  int i;
-  for(i = 0; i < (int)res.size(); i++){
-    if(res[i].GetPageId() == -1)break;
-    Row* row = new Row(res[i]);
-    table_info->GetTableHeap()->GetTuple(row, NULL);
-    for(int j = 0; j < (int)columnList.size(); j++){
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(columnList[j], idx);
-      cout<<" "<<row->GetField(idx)->GetData()<<" ";
+      cout<<endl;
+      i++;
     }
-    cout<<endl;
   }
+  plan->Close();
+  delete plan;
 
   cout<<"Selected Row Number : "<<i<<endl;
   std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
@@ -580,73 +610,51 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
   std::string table_name = (std::string)NodePointer->val_;
   TableInfo *table_info = NULL;
   db->catalog_mgr_->GetTable(table_name,table_info);
+  if(table_info == NULL)
+  {
+    cout << "table not exist" << endl;
+    return DB_TABLE_NOT_EXIST;
+  }
   std::vector<Column*> columns = table_info->GetSchema()->GetColumns();
 
   // 获取插入的Value，创建每个Field
   NodePointer = NodePointer->next_;
   NodePointer = NodePointer->child_;
   std::vector<Field> fields;
-  int cnt = 0;
-  while(NodePointer != NULL){
-    // 如果是Unique，检查是否重复
-    if(columns[cnt]->IsUnique()){
-      IndexInfo* index_info;
-      db->catalog_mgr_->GetIndex(table_name, "Unique_"+columns[cnt]->GetName(), index_info);
-      std::vector<Field> fields;
-      if(columns[cnt]->GetType() == kTypeChar)fields.push_back(Field(columns[cnt]->GetType(), NodePointer->val_, std::string(NodePointer->val_).size(), false));
-      else if(columns[cnt]->GetType() == kTypeInt)fields.push_back(Field(columns[cnt]->GetType(), atoi(NodePointer->val_)));
-      else if(columns[cnt]->GetType() == kTypeFloat)fields.push_back(Field(columns[cnt]->GetType(), (float)atof((const char*)NodePointer->val_)));
-      Row key(fields);
-      std::vector<RowId> result;
-      result.clear();
-      index_info->GetIndex()->ScanKey(key, result, NULL);
-      if(!result.empty()){
-        cout<<"Error: Unique Constraints Conflict!"<<endl;
-        return DB_FAILED;
-      }
-    }
-
-    if(NodePointer->type_ == kNodeNumber){
-      if(columns[cnt]->GetType() == kTypeInt)fields.push_back(Field(kTypeInt, atoi(NodePointer->val_)));
-      else if(columns[cnt]->GetType() == kTypeFloat)fields.push_back(Field(kTypeFloat, (float)atof((const char*)NodePointer->val_)));
-      else return DB_FAILED;
-    }
-    else if(NodePointer->type_ == kNodeString){
-      if(columns[cnt]->GetType() == kTypeChar)fields.push_back(Field((kTypeChar), (char*)NodePointer->val_, std::string(NodePointer->val_).size(), true));
-      else return DB_FAILED;
+  for(size_t cnt = 0; NodePointer != NULL; cnt++, NodePointer = NodePointer->next_){
+    if(cnt == columns.size()){
+      cout<<"Error: too many values."<<endl;
+      return DB_FAILED;
     }
-    else if(NodePointer->type_ == kNodeNull){
+    if(NodePointer->type_ == kNodeNull){
       if(!columns[cnt]->IsNullable()){
         cout<<"Error: this column not Nullable."<<endl;
+        return DB_FAILED;
       }
       fields.push_back(Field(columns[cnt]->GetType()));
+      continue;
+    }
+    bool is_number = columns[cnt]->GetType() == kTypeInt || columns[cnt]->GetType() == kTypeFloat;
+    if(is_number != (NodePointer->type_ == kNodeNumber)){
+      return DB_FAILED;
     }
-    cnt++;
-    NodePointer = NodePointer->next_;
+    Field *field = NewLiteralField(columns[cnt]->GetType(), NodePointer->val_);
+    fields.push_back(*field);
+    delete field;
   }
 
-  // 创建并插入Row
-  Row row(fields);
-  table_info->GetTableHeap()->InsertTuple(row,NULL);
-  RowId rid(row.GetRowId());
-  
-  // 在该表的每个Index插入Entry
+  // 插入Row，并在该表的每个Index插入Entry，唯一索引中已有该键时失败
   vector<IndexInfo*> index_infos;
   db->catalog_mgr_->GetTableIndexes(table_name, index_infos);
-  for(auto i = index_infos.begin(); i != index_infos.end(); i++){
-    vector<Column*> key_columns = (*i)->GetIndexKeySchema()->GetColumns();
-    vector<uint32_t> column_indexes;
-    for(auto j = key_columns.begin(); j != key_columns.end();j++){
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex((*j)->GetName(), idx);
-      column_indexes.push_back(idx);
-    }
-    vector<Field> index_fields;
-    for(auto j=column_indexes.begin(); j != column_indexes.end(); j++){
-      index_fields.push_back(*(row.GetField(*j)));
-    }
-    Row index_row(index_fields);
-    (*i)->GetIndex()->InsertEntry(index_row, row.GetRowId(), NULL);
+  std::vector<std::vector<Field>> values;
+  values.push_back(std::move(fields));
+  InsertExecutor plan(table_info, index_infos, std::move(values), context->txn_);
+  plan.Open();
+  while(plan.Next() != NULL);
+  plan.Close();
+  if(plan.Failed()){
+    cout<<"Error: Unique Constraints Conflict!"<<endl;
+    return DB_FAILED;
   }
 
   std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
@@ -672,53 +680,20 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
     return DB_TABLE_NOT_EXIST;
   }
 
-  // 根据条件筛选对应的Row
-  NodePointer = NodePointer->next_;
-  std::vector<RowId> res;
-  if(NodePointer!=NULL)res = Condition(NodePointer->child_, table_name);
-  else{
-    TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-    while(Iterator != table_info->GetTableHeap()->End()){
-      res.push_back(Iterator->GetRowId());
-      ++Iterator;
-      }
+  // 扫描到符合条件的Row就删除，同时删除该表所有Index中对应的Entry
+  AbstractExecutor *scan = PlanScan(NodePointer->next_, table_info, context->txn_);
+  if(scan == NULL){
+    cout << "column not exist" << endl;
+    return DB_COLUMN_NAME_NOT_EXIST;
   }
-  cout<<"Deleted Row Num : "<<res.size()<<endl;
-
-  // 在该表的所有Index中删除对应的Entry
   vector<IndexInfo*> index_infos;
   db->catalog_mgr_->GetTableIndexes(table_name, index_infos);
-  vector<Row> rows;
-  for(auto i = res.begin(); i!= res.end(); i++){
-    Row *temp_row = new Row((*i));
-    table_info->GetTableHeap()->GetTuple(temp_row, NULL);
-    temp_row->SetRowId(*i);
-    rows.push_back(*temp_row);
-  }
-  for(auto i = index_infos.begin(); i != index_infos.end(); i++){
-    vector<Column*> key_columns = (*i)->GetIndexKeySchema()->GetColumns();
-    vector<uint32_t> column_indexes;
-    for(auto j = key_columns.begin(); j != key_columns.end();j++){
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex((*j)->GetName(), idx);
-      column_indexes.push_back(idx);
-    }
-    for(auto m = rows.begin(); m!= rows.end(); m++){
-      Row *row = new Row(*m);
-      vector<Field> index_fields;
-      table_info->GetTableHeap()->GetTuple(row, NULL);
-      row->SetRowId((*m).GetRowId());
-      for(auto j=column_indexes.begin(); j != column_indexes.end(); j++){
-        index_fields.push_back(*(row->GetField(*j)));
-      }
-      Row index_row(index_fields);
-      (*i)->GetIndex()->RemoveEntry(index_row, row->GetRowId(), NULL);
-    }
-    
-  }
-
-  // 删除表中的记录
-  for(int i = 0; i < (int)res.size(); i++)table_info->GetTableHeap()->ApplyDelete(res[i], NULL);
+  DeleteExecutor plan(table_info, index_infos, scan, context->txn_);
+  plan.Open();
+  int i = 0;
+  while(plan.Next() != NULL)i++;
+  plan.Close();
+  cout<<"Deleted Row Num : "<<i<<endl;
 
   std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
   std::chrono::microseconds timeInterval = std::chrono::duration_cast <std::chrono::microseconds>(endTime - beginTime);
@@ -745,50 +720,51 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
 
   // 获取要更新的Column和value
   NodePointer = NodePointer->next_;
-  pSyntaxNode ChildPointer = NodePointer->child_;
-  std::vector<std::string> value_names;
-  std::vector<std::string> values;
-  while(ChildPointer != NULL){
-    value_names.push_back((std::string)ChildPointer->child_->val_);
-    values.push_back((std::string)ChildPointer->child_->next_->val_);
-    ChildPointer = ChildPointer->next_;
+  std::vector<uint32_t> column_indexes;
+  std::vector<Field> values;
+  for(pSyntaxNode ChildPointer = NodePointer->child_; ChildPointer != NULL; ChildPointer = ChildPointer->next_){
+    uint32_t idx;
+    if(table_info->GetSchema()->GetColumnIndex(ChildPointer->child_->val_, idx) != DB_SUCCESS){
+      cout << "column not exist" << endl;
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
+    const Column *column = table_info->GetSchema()->GetColumn(idx);
+    column_indexes.push_back(idx);
+    if(ChildPointer->child_->next_->type_ == kNodeNull){
+      if(!column->IsNullable()){
+        cout<<"Error: this column not Nullable."<<endl;
+        return DB_FAILED;
+      }
+      values.push_back(Field(column->GetType()));
+      continue;
+    }
+    Field *field = NewLiteralField(column->GetType(), ChildPointer->child_->next_->val_);
+    values.push_back(*field);
+    delete field;
   }
 
-  // 根据条件筛选对应Row
-  NodePointer = NodePointer->next_;
-  std::vector<RowId> res;
-  if(NodePointer != NULL)res = Condition(NodePointer->child_, table_name);
-  else{
-    TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-    while(Iterator != table_info->GetTableHeap()->End()){
-      res.push_back(Iterator->GetRowId());
-      ++Iterator;
-      }
+  // 扫描到符合条件的Row就更新，同时维护该表的Index
+  AbstractExecutor *scan = PlanScan(NodePointer->next_, table_info, context->txn_);
+  if(scan == NULL){
+    cout << "column not exist" << endl;
+    return DB_COLUMN_NAME_NOT_EXIST;
   }
-  cout<<"Updated Row Num : "<<res.size()<<endl;
-
-  // 更新每个Row的值
-  for(int i = 0; i < (int)res.size(); i++){
-    Row *row = new Row(res[i]);
-    table_info->GetTableHeap()->GetTuple(row, NULL);
-    for(int j = 0; j < (int)values.size(); j++){
-      std::string value_name = value_names[j];
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(value_name, idx);
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *field;
-      if(type == kTypeInt)field = new Field(type, atoi(values[j].c_str()));
-      else if(type == kTypeFloat)field = new Field(type, (float)atof(values[j].c_str()));
-      else if(type == kTypeChar)field = new Field(type, (char*)values[j].c_str(), (uint32_t)values[j].size(), false);
-      row->GetField(idx)->operator= (*field);
-    }
-    table_info->GetTableHeap()->UpdateTuple(*row, res[i], NULL);
+  vector<IndexInfo*> index_infos;
+  db->catalog_mgr_->GetTableIndexes(table_name, index_infos);
+  UpdateExecutor plan(table_info, index_infos, scan, column_indexes, std::move(values), context->txn_);
+  plan.Open();
+  int i = 0;
+  while(plan.Next() != NULL)i++;
+  plan.Close();
+  if(plan.Failed()){
+    cout<<"Error: Unique Constraints Conflict!"<<endl;
   }
+  cout<<"Updated Row Num : "<<i<<endl;
 
   std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
   std::chrono::microseconds timeInterval = std::chrono::duration_cast <std::chrono::microseconds>(endTime - beginTime);
   std::cout << "Time: " << timeInterval.count() << "us" << endl;
-  return DB_SUCCESS;
+  return plan.Failed() ? DB_FAILED : DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context) {
@@ -898,315 +874,116 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
 }
 
 
-std::vector<RowId> ExecuteEngine::Condition(pSyntaxNode ast, std::string table_name){
+IndexInfo *ExecuteEngine::GetColumnIndex(const std::string &table_name, const std::string &column_name, bool range) {
   DBStorageEngine* db = dbs_.find(current_db_)->second;
-  pSyntaxNode pointer = ast;
-  std::vector<RowId> res;
-  if(ast->type_ == kNodeConnector){
-    if((std::string)ast->val_ == "and"){
-      // 分别获取and两边条件符合的Row
-      pointer = pointer->child_;
-      std::vector<RowId> Rows1 = Condition(pointer, table_name);
-      pointer = pointer->next_;
-      std::vector<RowId> Rows2 = Condition(pointer, table_name);
-      //取交集
-      sort (Rows1.begin(),Rows1.end(), RowId_compare);
-      sort (Rows2.begin(),Rows2.end(), RowId_compare);
-      res.resize(min(Rows1.size(), Rows2.size()));
-      set_intersection(Rows1.begin(), Rows1.end(), Rows2.begin(), Rows2.end(), res.begin(), RowId_compare);
-      // 确保res的size正确
-      int i = res.size()-1;
-      while(res[i].GetPageId() == -1)i--;
-      res.resize(i+1);
-    }
-    else if((std::string)ast->val_ == "or"){
-      // 分别获取or两边条件符合的Row
-      pointer = pointer->child_;
-      std::vector<RowId> Rows1 = Condition(pointer, table_name);
-      pointer = pointer->next_;
-      std::vector<RowId> Rows2 = Condition(pointer, table_name);
-      //取并集
-      sort (Rows1.begin(),Rows1.end(), RowId_compare);
-      sort (Rows2.begin(),Rows2.end(), RowId_compare);
-      res.resize(Rows1.size()+Rows2.size());
-      set_union(Rows1.begin(), Rows1.end(), Rows2.begin(), Rows2.end(), res.begin(), RowId_compare);
-      // 确保res的size正确
-      int i = res.size()-1;
-      while(res[i].GetPageId() == -1)i--;
-      res.resize(i+1);
-    }
-  }
-  else if(ast->type_ == kNodeCompareOperator){
-    if((std::string)ast->val_ == "="){
-      // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-
-      //检查有无可用的Index
-      std::vector<IndexInfo*> indexes;
-      IndexInfo* chosen_index = NULL;
-      db->catalog_mgr_->GetTableIndexes(table_name, indexes);
-      for(auto i = indexes.begin(); i!=indexes.end(); i++){
-        std::vector<Column*> columns = (*i)->GetIndexKeySchema()->GetColumns();
-        for(auto j = columns.begin(); j != columns.end(); j++){
-          if((*j)->GetName() == column_name && columns.size() == 1)chosen_index = (*i);
-        }
-        if(chosen_index != NULL)break;
-      }
-      // 若有Index可用，则用Index搜索
-      if(chosen_index != NULL){
-        std::vector<Field> fields;
-        if(type == kTypeChar)fields.push_back(Field(type, pointer->val_, ((std::string)pointer->val_).size(), 0));
-        else if(type == kTypeInt)fields.push_back(Field(type, atoi(pointer->val_)));
-        else if(type == kTypeFloat)fields.push_back(Field(type, (float)atof(pointer->val_)));
-        Row key(fields);
-        std::vector<RowId> result;
-        chosen_index->GetIndex()->ScanKey(key, result, NULL);
-        return result;
-      }
-      // 若无Index可用，则用TableHeap逐条轮询
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(type == kTypeFloat){
-          Field field(type, (float)atof(pointer->val_));
-          if(row->GetField(idx)->CompareEquals(field))res.push_back(Iterator->GetRowId());
-        }
-        else if(type == kTypeInt){
-          Field field(type, atoi(pointer->val_));
-          if(row->GetField(idx)->CompareEquals(field))res.push_back(Iterator->GetRowId());
-        }
-        else if(type == kTypeChar){
-          Field field(type, pointer->val_, ((std::string)pointer->val_).size(), false);
-          if(row->GetField(idx)->CompareEquals(field))res.push_back(Iterator->GetRowId());
-        }
-        ++Iterator;
-        delete row;
-      }
+  std::vector<IndexInfo*> indexes;
+  db->catalog_mgr_->GetTableIndexes(table_name, indexes);
+  IndexInfo *chosen = nullptr;
+  for (auto index_info : indexes) {
+    std::vector<Column*> columns = index_info->GetIndexKeySchema()->GetColumns();
+    if (columns.size() != 1 || columns[0]->GetName() != column_name) {
+      continue;
     }
-    else if((std::string)ast->val_ == "not"){
-      // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(! row->GetField(idx)->IsNull())res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
+    bool is_hash = index_info->GetIndexType() == IndexType::kHash;
+    if (range && is_hash) {
+      continue;
     }
-    else if((std::string)ast->val_ == "is"){  //is NULL
-    // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(Iterator->GetField(idx)->IsNull())res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
+    // 等值查询时 hash 索引一次定位到桶，不必从根走到叶
+    if (is_hash || chosen == nullptr) {
+      chosen = index_info;
     }
-    else if((std::string)ast->val_ == "<>"){
-      // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *f;
-      if(type == kTypeInt)
-      {
-        f = new Field(kTypeInt, atoi(pointer->val_));
-      }
-      else if(type == kTypeFloat)
-      {
-        f = new Field(kTypeFloat, float(atof(pointer->val_)));
-      }
-      else
-      {
-        f = new Field(kTypeChar, pointer->val_, string(pointer->val_).size(), false); 
-      }
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(row->GetField(idx)->CompareNotEquals(*f) == kTrue)res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
-      delete f;
+  }
+  return chosen;
+}
+
+AbstractExecutor *ExecuteEngine::PlanScan(pSyntaxNode condition, TableInfo *table_info, Transaction *txn) {
+  if (condition == nullptr) {
+    return new SeqScanExecutor(table_info, txn);
+  }
+  Predicate *predicate = Predicate::Create(condition->child_, table_info->GetSchema());
+  if (predicate == nullptr) {
+    return nullptr;
+  }
+  AbstractExecutor *scan = PlanIndexScan(condition->child_, table_info, txn);
+  if (scan == nullptr) {
+    scan = new SeqScanExecutor(table_info, txn);
+  }
+  // 索引只求解了条件的一部分，其余的条件逐行检查
+  return new FilterExecutor(scan, predicate);
+}
+
+IndexScanExecutor *ExecuteEngine::PlanIndexScan(pSyntaxNode ast, TableInfo *table_info, Transaction *txn) {
+  const std::string table_name = table_info->GetTableName();
+  if (ast->type_ == kNodeCompareOperator && (std::string)ast->val_ == "=") {
+    std::string column_name = ast->child_->val_;
+    IndexInfo *index_info = GetColumnIndex(table_name, column_name, false);
+    if (index_info == nullptr) return nullptr;
+    uint32_t idx;
+    table_info->GetSchema()->GetColumnIndex(column_name, idx);
+    Field *key = NewLiteralField(table_info->GetSchema()->GetColumn(idx)->GetType(), ast->child_->next_->val_);
+    auto scan = new IndexScanExecutor(table_info, index_info, *key, txn);
+    delete key;
+    return scan;
+  }
+
+  // 单个比较，或者 and 两边的比较
+  std::vector<pSyntaxNode> predicates{ast};
+  if (ast->type_ == kNodeConnector && (std::string)ast->val_ == "and") {
+    predicates = {ast->child_, ast->child_->next_};
+  }
+  std::string column_name;
+  bool range = true;
+  for (auto predicate : predicates) {
+    if (predicate->type_ != kNodeCompareOperator) {
+      range = false;
+      break;
     }
-    else if((std::string)ast->val_ == ">"){
-      // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *f;
-      if(type == kTypeInt)
-      {
-        f = new Field(kTypeInt, atoi(pointer->val_));
-      }
-      else if(type == kTypeFloat)
-      {
-        f = new Field(kTypeFloat, float(atof(pointer->val_)));
-      }
-      else
-      {
-        f = new Field(kTypeChar, pointer->val_, string(pointer->val_).size(), false); 
-      }
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(row->GetField(idx)->CompareGreaterThan(*f) == kTrue)res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
-      delete f;
+    std::string op = predicate->val_;
+    std::string column = predicate->child_->val_;
+    if ((op != "<" && op != "<=" && op != ">" && op != ">=") || (!column_name.empty() && column != column_name)) {
+      range = false;
+      break;
     }
-    else if((std::string)ast->val_ == "<"){
-       // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *f;
-      if(type == kTypeInt)
-      {
-        f = new Field(kTypeInt, atoi(pointer->val_));
-      }
-      else if(type == kTypeFloat)
-      {
-        f = new Field(kTypeFloat, float(atof(pointer->val_)));
-      }
-      else
-      {
-        f = new Field(kTypeChar, pointer->val_, string(pointer->val_).size(), false); 
-      }
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(row->GetField(idx)->CompareLessThan(*f) == kTrue)res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
-      delete f;
+    column_name = column;
+  }
+  IndexInfo *index_info = range ? GetColumnIndex(table_name, column_name, true) : nullptr;
+  if (index_info == nullptr) {
+    if (ast->type_ != kNodeConnector || (std::string)ast->val_ != "and") {
+      return nullptr;
     }
-    else if((std::string)ast->val_ == ">="){
-       // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *f;
-      if(type == kTypeInt)
-      {
-        f = new Field(kTypeInt, atoi(pointer->val_));
-      }
-      else if(type == kTypeFloat)
-      {
-        f = new Field(kTypeFloat, float(atof(pointer->val_)));
-      }
-      else
-      {
-        f = new Field(kTypeChar, pointer->val_, string(pointer->val_).size(), false); 
-      }
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(row->GetField(idx)->CompareGreaterThanEquals(*f) == kTrue)res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
+    IndexScanExecutor *scan = PlanIndexScan(ast->child_, table_info, txn);
+    return scan != nullptr ? scan : PlanIndexScan(ast->child_->next_, table_info, txn);
+  }
+
+  uint32_t idx;
+  table_info->GetSchema()->GetColumnIndex(column_name, idx);
+  TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
+
+  // 两个条件取更紧的上下界
+  std::vector<Field*> values;
+  Field *lo = nullptr, *hi = nullptr;
+  bool lo_inclusive = false, hi_inclusive = false;
+  for (auto predicate : predicates) {
+    std::string op = predicate->val_;
+    Field *value = NewLiteralField(type, predicate->child_->next_->val_);
+    values.push_back(value);
+    bool inclusive = op.size() == 2;
+    if (op[0] == '>') {
+      if (lo == nullptr || value->CompareGreaterThan(*lo) == kTrue ||
+          (value->CompareEquals(*lo) == kTrue && !inclusive)) {
+        lo = value;
+        lo_inclusive = inclusive;
       }
-      delete f;
     }
-    else if((std::string)ast->val_ == "<="){
-       // 获取要筛选的属性名和值、数据类型
-      pointer = pointer->child_;
-      std::string column_name = (std::string)pointer->val_;
-      pointer = pointer->next_;
-      TableInfo *table_info = NULL;
-      db->catalog_mgr_->GetTable(table_name, table_info);
-      uint32_t idx;
-      table_info->GetSchema()->GetColumnIndex(column_name, idx);
-      // 轮询寻找符合条件的Row
-      TableIterator Iterator = table_info->GetTableHeap()->Begin(NULL);
-      TableIterator End = table_info->GetTableHeap()->End();
-      TypeId type = table_info->GetSchema()->GetColumn(idx)->GetType();
-      Field *f;
-      if(type == kTypeInt)
-      {
-        f = new Field(kTypeInt, atoi(pointer->val_));
-      }
-      else if(type == kTypeFloat)
-      {
-        f = new Field(kTypeFloat, float(atof(pointer->val_)));
-      }
-      else
-      {
-        f = new Field(kTypeChar, pointer->val_, string(pointer->val_).size(), false); 
-      }
-      while(Iterator != End){
-        Row* row = new Row(*Iterator);
-        table_info->GetTableHeap()->GetTuple(row, NULL);
-        if(row->GetField(idx)->CompareLessThanEquals(*f) == kTrue)res.push_back(Iterator->GetRowId());
-        ++Iterator;
-        delete row;
-      }
-      delete f;
+    else if (hi == nullptr || value->CompareLessThan(*hi) == kTrue ||
+             (value->CompareEquals(*hi) == kTrue && !inclusive)) {
+      hi = value;
+      hi_inclusive = inclusive;
     }
   }
-  return res;
+  auto scan = new IndexScanExecutor(table_info, index_info, lo, lo_inclusive, hi, hi_inclusive, txn);
+  for (auto value : values) {
+    delete value;
+  }
+  return scan;
 }
@@ -0,0 +1,279 @@
+#include "executor/executors.h"
+
+/**
+ * SeqScanExecutor
+ */
+void SeqScanExecutor::Open() {
+  page_index_ = 0;
+  rows_.clear();
+  row_index_ = 0;
+}
+
+Row *SeqScanExecutor::Next() {
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  while (row_index_ == rows_.size()) {
+    rows_.clear();
+    row_index_ = 0;
+    // pages appended while scanning are scanned too
+    const FreeSpaceMap &free_space_map = table_heap->GetFreeSpaceMap();
+    if (page_index_ >= free_space_map.GetHeapPageCount()) {
+      return nullptr;
+    }
+    read_ahead_.Access(page_index_);
+    table_heap->ScanPage(free_space_map.GetHeapPage(page_index_++), [this](Row &row) { rows_.emplace_back(row); },
+                         txn_);
+  }
+  return &rows_[row_index_++];
+}
+
+void SeqScanExecutor::Close() {
+  rows_.clear();
+  row_index_ = 0;
+}
+
+/**
+ * IndexScanExecutor
+ */
+IndexScanExecutor::IndexScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field &key,
+                                     Transaction *txn)
+        : table_info_(table_info), index_info_(index_info), txn_(txn), point_(true) {
+  lo_.emplace_back(key);
+}
+
+IndexScanExecutor::IndexScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field *lo,
+                                     bool lo_inclusive, const Field *hi, bool hi_inclusive, Transaction *txn)
+        : table_info_(table_info), index_info_(index_info), txn_(txn), point_(false), lo_inclusive_(lo_inclusive),
+          hi_inclusive_(hi_inclusive) {
+  if (lo != nullptr) {
+    lo_.emplace_back(*lo);
+  }
+  if (hi != nullptr) {
+    hi_.emplace_back(*hi);
+  }
+}
+
+void IndexScanExecutor::Open() {
+  rids_.clear();
+  rid_index_ = 0;
+  Row lo_key(lo_), hi_key(hi_);
+  if (point_) {
+    // DB_KEY_NOT_FOUND leaves rids_ empty
+    index_info_->GetIndex()->ScanKey(lo_key, rids_, txn_);
+  } else {
+    index_info_->GetIndex()->ScanRange(lo_.empty() ? nullptr : &lo_key, lo_inclusive_,
+                                       hi_.empty() ? nullptr : &hi_key, hi_inclusive_, rids_, txn_);
+  }
+}
+
+Row *IndexScanExecutor::Next() {
+  while (rid_index_ < rids_.size()) {
+    delete row_;
+    row_ = new Row(rids_[rid_index_++]);
+    if (table_info_->GetTableHeap()->GetTuple(row_, txn_)) {
+      return row_;
+    }
+  }
+  return nullptr;
+}
+
+void IndexScanExecutor::Close() {
+  rids_.clear();
+  rid_index_ = 0;
+  delete row_;
+  row_ = nullptr;
+}
+
+/**
+ * FilterExecutor
+ */
+Row *FilterExecutor::Next() {
+  Row *row;
+  while ((row = child_->Next()) != nullptr) {
+    if (predicate_->Evaluate(*row)) {
+      return row;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * ProjectionExecutor
+ */
+Row *ProjectionExecutor::Next() {
+  Row *row = child_->Next();
+  if (row == nullptr) {
+    return nullptr;
+  }
+  std::vector<Field> fields;
+  fields.reserve(column_indexes_.size());
+  for (auto column_index : column_indexes_) {
+    fields.emplace_back(*row->GetField(column_index));
+  }
+  delete row_;
+  row_ = new Row(fields);
+  row_->SetRowId(row->GetRowId());
+  return row_;
+}
+
+void ProjectionExecutor::Close() {
+  child_->Close();
+  delete row_;
+  row_ = nullptr;
+}
+
+/**
+ * ModifyExecutor
+ */
+ModifyExecutor::ModifyExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, Transaction *txn)
+        : table_info_(table_info), indexes_(std::move(indexes)), txn_(txn) {
+  for (auto index_info : indexes_) {
+    std::vector<uint32_t> key_columns;
+    bool unique = false;
+    for (auto column : index_info->GetIndexKeySchema()->GetColumns()) {
+      uint32_t column_index;
+      table_info_->GetSchema()->GetColumnIndex(column->GetName(), column_index);
+      key_columns.push_back(column_index);
+      unique = unique || column->IsUnique();
+    }
+    key_columns_.push_back(std::move(key_columns));
+    unique_.push_back(unique);
+  }
+}
+
+Row ModifyExecutor::KeyOf(const Row &row, size_t index) const {
+  std::vector<Field> fields;
+  fields.reserve(key_columns_[index].size());
+  for (auto column_index : key_columns_[index]) {
+    fields.emplace_back(*row.GetField(column_index));
+  }
+  return Row(fields);
+}
+
+bool ModifyExecutor::Conflicts(size_t index, const Row &key, const RowId &self) const {
+  if (!unique_[index]) {
+    return false;
+  }
+  std::vector<RowId> result;
+  indexes_[index]->GetIndex()->ScanKey(key, result, txn_);
+  for (auto &rid : result) {
+    if (!(rid == self)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * InsertExecutor
+ */
+Row *InsertExecutor::Next() {
+  if (failed_ || value_index_ == values_.size()) {
+    return nullptr;
+  }
+  delete row_;
+  row_ = new Row(values_[value_index_++]);
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    if (Conflicts(i, KeyOf(*row_, i), RowId())) {
+      failed_ = true;
+      return nullptr;
+    }
+  }
+  if (!table_info_->GetTableHeap()->InsertTuple(*row_, txn_)) {
+    failed_ = true;
+    return nullptr;
+  }
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    indexes_[i]->GetIndex()->InsertEntry(KeyOf(*row_, i), row_->GetRowId(), txn_);
+  }
+  return row_;
+}
+
+/**
+ * DeleteExecutor
+ */
+Row *DeleteExecutor::Next() {
+  // the child has buffered the row, so the tuple can go before the scan moves on
+  Row *row = child_->Next();
+  if (row == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    indexes_[i]->GetIndex()->RemoveEntry(KeyOf(*row, i), row->GetRowId(), txn_);
+  }
+  table_info_->GetTableHeap()->ApplyDelete(row->GetRowId(), txn_);
+  return row;
+}
+
+/**
+ * UpdateExecutor
+ */
+Row *UpdateExecutor::Next() {
+  if (failed_) {
+    return nullptr;
+  }
+  Row *old_row;
+  do {
+    old_row = child_->Next();
+  } while (old_row != nullptr && moved_.count(old_row->GetRowId().Get()) > 0);
+  if (old_row == nullptr) {
+    return nullptr;
+  }
+  RowId old_rid = old_row->GetRowId();
+
+  std::vector<Field> fields;
+  fields.reserve(old_row->GetFieldCount());
+  for (uint32_t i = 0; i < old_row->GetFieldCount(); i++) {
+    const Field *field = old_row->GetField(i);
+    for (size_t j = 0; j < column_indexes_.size(); j++) {
+      if (column_indexes_[j] == i) {
+        field = &values_[j];
+      }
+    }
+    fields.emplace_back(*field);
+  }
+  delete row_;
+  row_ = new Row(fields);
+  row_->SetRowId(old_rid);
+
+  // check every unique index before touching anything
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    if (Conflicts(i, KeyOf(*row_, i), old_rid)) {
+      failed_ = true;
+      return nullptr;
+    }
+  }
+  if (!table_info_->GetTableHeap()->UpdateTuple(*row_, old_rid, txn_)) {
+    failed_ = true;
+    return nullptr;
+  }
+  // a row too big for its page is deleted and inserted again, InsertTuple sets its new row id
+  RowId new_rid = row_->GetRowId();
+  if (!(new_rid == old_rid)) {
+    moved_.insert(new_rid.Get());
+  }
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    Row old_key = KeyOf(*old_row, i);
+    Row new_key = KeyOf(*row_, i);
+    bool same_key = true;
+    for (uint32_t j = 0; j < old_key.GetFieldCount(); j++) {
+      const Field *old_field = old_key.GetField(j), *new_field = new_key.GetField(j);
+      if (old_field->IsNull() != new_field->IsNull() ||
+          (!old_field->IsNull() && old_field->CompareEquals(*new_field) != kTrue)) {
+        same_key = false;
+      }
+    }
+    if (same_key && new_rid == old_rid) {
+      continue;
+    }
+    indexes_[i]->GetIndex()->RemoveEntry(old_key, old_rid, txn_);
+    indexes_[i]->GetIndex()->InsertEntry(new_key, new_rid, txn_);
+  }
+  return row_;
+}
+
+void UpdateExecutor::Close() {
+  child_->Close();
+  moved_.clear();
+  delete row_;
+  row_ = nullptr;
+}
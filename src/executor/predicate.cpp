@@ -0,0 +1,239 @@
+#include "executor/predicate.h"
+#include "executor/predicate_kernels.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+Field *NewLiteralField(TypeId type, char *val) {
+  if (type == kTypeInt) {
+    return new Field(kTypeInt, atoi(val));
+  }
+  if (type == kTypeFloat) {
+    return new Field(kTypeFloat, float(atof(val)));
+  }
+  return new Field(kTypeChar, val, std::string(val).size(), true);
+}
+
+Predicate *Predicate::Create(pSyntaxNode ast, Schema *schema) {
+  if (ast == nullptr || ast->val_ == nullptr) {
+    return nullptr;
+  }
+  std::string op = ast->val_;
+  if (ast->type_ == kNodeConnector) {
+    if (op != "and" && op != "or") {
+      return nullptr;
+    }
+    Predicate *left = Create(ast->child_, schema);
+    Predicate *right = left == nullptr ? nullptr : Create(ast->child_->next_, schema);
+    if (right == nullptr) {
+      delete left;
+      return nullptr;
+    }
+    return op == "and" ? And(left, right) : Or(left, right);
+  }
+  if (ast->type_ != kNodeCompareOperator) {
+    return nullptr;
+  }
+  uint32_t column_index;
+  if (ast->child_ == nullptr || schema->GetColumnIndex(ast->child_->val_, column_index) != DB_SUCCESS) {
+    return nullptr;
+  }
+  if (op == "is") {
+    return IsNull(column_index);
+  }
+  if (op == "not") {
+    return NotNull(column_index);
+  }
+  CompareOp compare_op;
+  if (op == "=") {
+    compare_op = CompareOp::kEqual;
+  } else if (op == "<>") {
+    compare_op = CompareOp::kNotEqual;
+  } else if (op == "<") {
+    compare_op = CompareOp::kLess;
+  } else if (op == "<=") {
+    compare_op = CompareOp::kLessEqual;
+  } else if (op == ">") {
+    compare_op = CompareOp::kGreater;
+  } else if (op == ">=") {
+    compare_op = CompareOp::kGreaterEqual;
+  } else {
+    return nullptr;
+  }
+  pSyntaxNode literal = ast->child_->next_;
+  if (literal == nullptr || literal->val_ == nullptr) {
+    return nullptr;
+  }
+  Field *value = NewLiteralField(schema->GetColumn(column_index)->GetType(), literal->val_);
+  Predicate *predicate = Compare(column_index, compare_op, *value);
+  delete value;
+  return predicate;
+}
+
+Predicate *Predicate::Compare(uint32_t column_index, CompareOp op, const Field &value) {
+  auto predicate = new Predicate(Kind::kCompare);
+  predicate->op_ = op;
+  predicate->column_index_ = column_index;
+  predicate->value_ = new Field(value);
+  return predicate;
+}
+
+Predicate *Predicate::IsNull(uint32_t column_index) {
+  auto predicate = new Predicate(Kind::kIsNull);
+  predicate->column_index_ = column_index;
+  return predicate;
+}
+
+Predicate *Predicate::NotNull(uint32_t column_index) {
+  auto predicate = new Predicate(Kind::kNotNull);
+  predicate->column_index_ = column_index;
+  return predicate;
+}
+
+Predicate *Predicate::And(Predicate *left, Predicate *right) {
+  auto predicate = new Predicate(Kind::kAnd);
+  predicate->left_ = left;
+  predicate->right_ = right;
+  return predicate;
+}
+
+Predicate *Predicate::Or(Predicate *left, Predicate *right) {
+  auto predicate = new Predicate(Kind::kOr);
+  predicate->left_ = left;
+  predicate->right_ = right;
+  return predicate;
+}
+
+Predicate::~Predicate() {
+  delete value_;
+  delete left_;
+  delete right_;
+}
+
+bool Predicate::Evaluate(const Row &row) const {
+  switch (kind_) {
+    case Kind::kAnd:
+      return left_->Evaluate(row) && right_->Evaluate(row);
+    case Kind::kOr:
+      return left_->Evaluate(row) || right_->Evaluate(row);
+    case Kind::kIsNull:
+      return row.GetField(column_index_)->IsNull();
+    case Kind::kNotNull:
+      return !row.GetField(column_index_)->IsNull();
+    case Kind::kCompare:
+      break;
+  }
+  const Field *field = row.GetField(column_index_);
+  switch (op_) {
+    case CompareOp::kEqual:
+      return field->CompareEquals(*value_) == kTrue;
+    case CompareOp::kNotEqual:
+      return field->CompareNotEquals(*value_) == kTrue;
+    case CompareOp::kLess:
+      return field->CompareLessThan(*value_) == kTrue;
+    case CompareOp::kLessEqual:
+      return field->CompareLessThanEquals(*value_) == kTrue;
+    case CompareOp::kGreater:
+      return field->CompareGreaterThan(*value_) == kTrue;
+    case CompareOp::kGreaterEqual:
+      return field->CompareGreaterThanEquals(*value_) == kTrue;
+  }
+  return false;
+}
+
+/**
+ * Keeps the selected rows whose bit is set. Every selected row is written and the output only advances when
+ * the bit is set, so the loop has no branch on the data, and writes never overtake reads, which lets the output
+ * overwrite the selection.
+ */
+static uint32_t SelectFromBitmap(const uint64_t *bitmap, const uint32_t *selection, uint32_t count,
+                                 uint32_t *result) {
+  uint32_t selected = 0;
+  for (uint32_t j = 0; j < count; j++) {
+    uint32_t i = selection[j];
+    result[selected] = i;
+    selected += (bitmap[i >> 6] >> (i & 63)) & 1;
+  }
+  return selected;
+}
+
+template<typename Compare>
+static uint32_t SelectCompareString(const ColumnVector &column, const std::string_view &value, Compare compare,
+                                    const uint32_t *selection, uint32_t count, uint32_t *result) {
+  uint32_t selected = 0;
+  for (uint32_t j = 0; j < count; j++) {
+    uint32_t i = selection[j];
+    result[selected] = i;
+    selected += !column.IsNull(i) && compare(column.GetString(i).compare(value), 0);
+  }
+  return selected;
+}
+
+uint32_t Predicate::Select(const RowBatch &batch, const uint32_t *selection, uint32_t count,
+                           uint32_t *result) const {
+  switch (kind_) {
+    case Kind::kAnd: {
+      uint32_t selected = left_->Select(batch, selection, count, result);
+      return right_->Select(batch, result, selected, result);
+    }
+    case Kind::kOr: {
+      // union of both sides, both are in selection order
+      std::vector<uint32_t> left(count), right(count);
+      uint32_t left_count = left_->Select(batch, selection, count, left.data());
+      uint32_t right_count = right_->Select(batch, selection, count, right.data());
+      return std::set_union(left.begin(), left.begin() + left_count, right.begin(), right.begin() + right_count,
+                            result) - result;
+    }
+    case Kind::kIsNull:
+    case Kind::kNotNull: {
+      const ColumnVector &column = batch.GetColumn(column_index_);
+      std::vector<uint64_t> bitmap((column.GetSize() + 63) / 64);
+      if (kind_ == Kind::kIsNull) {
+        PredicateKernels::IsNull(column.GetNullBitmap(), column.GetSize(), bitmap.data());
+      } else {
+        PredicateKernels::NotNull(column.GetNullBitmap(), column.GetSize(), bitmap.data());
+      }
+      return SelectFromBitmap(bitmap.data(), selection, count, result);
+    }
+    case Kind::kCompare:
+      break;
+  }
+  if (value_->IsNull()) {
+    return 0;
+  }
+  const ColumnVector &column = batch.GetColumn(column_index_);
+  if (column.GetType() == TypeId::kTypeInt || column.GetType() == TypeId::kTypeFloat) {
+    // the kernel compares the whole column at once, the null rows hold placeholders and are cleared after
+    const auto &kernels = PredicateKernels::Get();
+    std::vector<uint64_t> bitmap((column.GetSize() + 63) / 64);
+    if (column.GetType() == TypeId::kTypeInt) {
+      kernels.GetIntKernel(op_)(column.GetInts(), column.GetSize(), value_->value_.integer_, bitmap.data());
+    } else {
+      kernels.GetFloatKernel(op_)(column.GetFloats(), column.GetSize(), value_->value_.float_, bitmap.data());
+    }
+    if (column.HasNull()) {
+      const uint64_t *nulls = column.GetNullBitmap();
+      for (size_t i = 0; i < bitmap.size(); i++) {
+        bitmap[i] &= ~nulls[i];
+      }
+    }
+    return SelectFromBitmap(bitmap.data(), selection, count, result);
+  }
+  std::string_view value(value_->value_.chars_, value_->len_);
+  switch (op_) {
+    case CompareOp::kEqual:
+      return SelectCompareString(column, value, std::equal_to<int>(), selection, count, result);
+    case CompareOp::kNotEqual:
+      return SelectCompareString(column, value, std::not_equal_to<int>(), selection, count, result);
+    case CompareOp::kLess:
+      return SelectCompareString(column, value, std::less<int>(), selection, count, result);
+    case CompareOp::kLessEqual:
+      return SelectCompareString(column, value, std::less_equal<int>(), selection, count, result);
+    case CompareOp::kGreater:
+      return SelectCompareString(column, value, std::greater<int>(), selection, count, result);
+    case CompareOp::kGreaterEqual:
+      return SelectCompareString(column, value, std::greater_equal<int>(), selection, count, result);
+  }
+  return 0;
+}
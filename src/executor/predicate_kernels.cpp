@@ -0,0 +1,235 @@
+#include "executor/predicate_kernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PREDICATE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using CompareOp = Predicate::CompareOp;
+
+template<CompareOp op, typename T>
+static inline bool CompareScalar(T a, T b) {
+  if constexpr (op == CompareOp::kEqual) {
+    return a == b;
+  } else if constexpr (op == CompareOp::kNotEqual) {
+    return a != b;
+  } else if constexpr (op == CompareOp::kLess) {
+    return a < b;
+  } else if constexpr (op == CompareOp::kLessEqual) {
+    return a <= b;
+  } else if constexpr (op == CompareOp::kGreater) {
+    return a > b;
+  } else {
+    return a >= b;
+  }
+}
+
+/**
+ * @brief 从第 begin 个值开始逐个比较，begin 必须是 64 的倍数
+ */
+template<CompareOp op, typename T>
+static void CompareScalarFrom(const T *values, uint32_t begin, uint32_t n, T value, uint64_t *bitmap) {
+  for (uint32_t word_begin = begin; word_begin < n; word_begin += 64) {
+    uint32_t end = std::min(n - word_begin, 64u);
+    uint64_t word = 0;
+    for (uint32_t j = 0; j < end; j++) {
+      word |= uint64_t(CompareScalar<op>(values[word_begin + j], value)) << j;
+    }
+    bitmap[word_begin / 64] = word;
+  }
+}
+
+template<CompareOp op, typename T>
+static void CompareScalarKernel(const T *values, uint32_t n, T value, uint64_t *bitmap) {
+  CompareScalarFrom<op>(values, 0, n, value, bitmap);
+}
+
+#ifdef PREDICATE_KERNELS_X86
+
+/**
+ * SSE: 4 values per compare, SSE2 instructions only
+ */
+__attribute__((target("sse2"))) static inline __m128i BroadcastSSE(int32_t value) { return _mm_set1_epi32(value); }
+
+__attribute__((target("sse2"))) static inline __m128 BroadcastSSE(float value) { return _mm_set1_ps(value); }
+
+template<CompareOp op>
+__attribute__((target("sse2"))) static inline uint32_t MaskSSE(const int32_t *values, __m128i value) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+  __m128i mask;
+  if constexpr (op == CompareOp::kEqual || op == CompareOp::kNotEqual) {
+    mask = _mm_cmpeq_epi32(v, value);
+  } else if constexpr (op == CompareOp::kLess || op == CompareOp::kGreaterEqual) {
+    mask = _mm_cmplt_epi32(v, value);
+  } else {
+    mask = _mm_cmpgt_epi32(v, value);
+  }
+  uint32_t bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+  // <>, >= and <= are the complements of =, < and >
+  if constexpr (op == CompareOp::kNotEqual || op == CompareOp::kGreaterEqual || op == CompareOp::kLessEqual) {
+    bits ^= 0xf;
+  }
+  return bits;
+}
+
+template<CompareOp op>
+__attribute__((target("sse2"))) static inline uint32_t MaskSSE(const float *values, __m128 value) {
+  __m128 v = _mm_loadu_ps(values);
+  __m128 mask;
+  if constexpr (op == CompareOp::kEqual) {
+    mask = _mm_cmpeq_ps(v, value);
+  } else if constexpr (op == CompareOp::kNotEqual) {
+    mask = _mm_cmpneq_ps(v, value);
+  } else if constexpr (op == CompareOp::kLess) {
+    mask = _mm_cmplt_ps(v, value);
+  } else if constexpr (op == CompareOp::kLessEqual) {
+    mask = _mm_cmple_ps(v, value);
+  } else if constexpr (op == CompareOp::kGreater) {
+    mask = _mm_cmpgt_ps(v, value);
+  } else {
+    mask = _mm_cmpge_ps(v, value);
+  }
+  return _mm_movemask_ps(mask);
+}
+
+template<CompareOp op, typename T>
+__attribute__((target("sse2"))) static void CompareSSEKernel(const T *values, uint32_t n, T value,
+                                                             uint64_t *bitmap) {
+  auto value_vec = BroadcastSSE(value);
+  uint32_t full = n / 64 * 64;
+  for (uint32_t word_begin = 0; word_begin < full; word_begin += 64) {
+    uint64_t word = 0;
+    for (uint32_t j = 0; j < 64; j += 4) {
+      word |= uint64_t(MaskSSE<op>(values + word_begin + j, value_vec)) << j;
+    }
+    bitmap[word_begin / 64] = word;
+  }
+  CompareScalarFrom<op>(values, full, n, value, bitmap);
+}
+
+/**
+ * AVX2: 8 values per compare
+ */
+__attribute__((target("avx2"))) static inline __m256i BroadcastAVX2(int32_t value) {
+  return _mm256_set1_epi32(value);
+}
+
+__attribute__((target("avx2"))) static inline __m256 BroadcastAVX2(float value) { return _mm256_set1_ps(value); }
+
+template<CompareOp op>
+__attribute__((target("avx2"))) static inline uint32_t MaskAVX2(const int32_t *values, __m256i value) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+  __m256i mask;
+  if constexpr (op == CompareOp::kEqual || op == CompareOp::kNotEqual) {
+    mask = _mm256_cmpeq_epi32(v, value);
+  } else if constexpr (op == CompareOp::kLess || op == CompareOp::kGreaterEqual) {
+    mask = _mm256_cmpgt_epi32(value, v);
+  } else {
+    mask = _mm256_cmpgt_epi32(v, value);
+  }
+  uint32_t bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+  if constexpr (op == CompareOp::kNotEqual || op == CompareOp::kGreaterEqual || op == CompareOp::kLessEqual) {
+    bits ^= 0xff;
+  }
+  return bits;
+}
+
+template<CompareOp op>
+__attribute__((target("avx2"))) static inline uint32_t MaskAVX2(const float *values, __m256 value) {
+  __m256 v = _mm256_loadu_ps(values);
+  __m256 mask;
+  if constexpr (op == CompareOp::kEqual) {
+    mask = _mm256_cmp_ps(v, value, _CMP_EQ_OQ);
+  } else if constexpr (op == CompareOp::kNotEqual) {
+    mask = _mm256_cmp_ps(v, value, _CMP_NEQ_UQ);
+  } else if constexpr (op == CompareOp::kLess) {
+    mask = _mm256_cmp_ps(v, value, _CMP_LT_OQ);
+  } else if constexpr (op == CompareOp::kLessEqual) {
+    mask = _mm256_cmp_ps(v, value, _CMP_LE_OQ);
+  } else if constexpr (op == CompareOp::kGreater) {
+    mask = _mm256_cmp_ps(v, value, _CMP_GT_OQ);
+  } else {
+    mask = _mm256_cmp_ps(v, value, _CMP_GE_OQ);
+  }
+  return _mm256_movemask_ps(mask);
+}
+
+template<CompareOp op, typename T>
+__attribute__((target("avx2"))) static void CompareAVX2Kernel(const T *values, uint32_t n, T value,
+                                                              uint64_t *bitmap) {
+  auto value_vec = BroadcastAVX2(value);
+  uint32_t full = n / 64 * 64;
+  for (uint32_t word_begin = 0; word_begin < full; word_begin += 64) {
+    uint64_t word = 0;
+    for (uint32_t j = 0; j < 64; j += 8) {
+      word |= uint64_t(MaskAVX2<op>(values + word_begin + j, value_vec)) << j;
+    }
+    bitmap[word_begin / 64] = word;
+  }
+  CompareScalarFrom<op>(values, full, n, value, bitmap);
+}
+
+#endif  // PREDICATE_KERNELS_X86
+
+/**
+ * Fills the kernel table of one instruction set, Kernel<op, T> is the kernel template of that set
+ */
+#define PREDICATE_KERNELS_TABLE(Kernel)                                                                        \
+  PredicateKernels {                                                                                           \
+    {Kernel<CompareOp::kEqual, int32_t>, Kernel<CompareOp::kNotEqual, int32_t>,                                \
+     Kernel<CompareOp::kLess, int32_t>, Kernel<CompareOp::kLessEqual, int32_t>,                                \
+     Kernel<CompareOp::kGreater, int32_t>, Kernel<CompareOp::kGreaterEqual, int32_t>},                         \
+    {Kernel<CompareOp::kEqual, float>, Kernel<CompareOp::kNotEqual, float>, Kernel<CompareOp::kLess, float>,  \
+     Kernel<CompareOp::kLessEqual, float>, Kernel<CompareOp::kGreater, float>,                                 \
+     Kernel<CompareOp::kGreaterEqual, float>}                                                                  \
+  }
+
+const PredicateKernels &PredicateKernels::Get(SimdLevel level) {
+  static const PredicateKernels scalar = PREDICATE_KERNELS_TABLE(CompareScalarKernel);
+#ifdef PREDICATE_KERNELS_X86
+  static const PredicateKernels sse = PREDICATE_KERNELS_TABLE(CompareSSEKernel);
+  static const PredicateKernels avx2 = PREDICATE_KERNELS_TABLE(CompareAVX2Kernel);
+  ASSERT(level <= DetectLevel(), "Instruction set not supported by this CPU.");
+  if (level == SimdLevel::kAVX2) {
+    return avx2;
+  }
+  if (level == SimdLevel::kSSE) {
+    return sse;
+  }
+#endif
+  return scalar;
+}
+
+const PredicateKernels &PredicateKernels::Get() {
+  static const PredicateKernels &best = Get(DetectLevel());
+  return best;
+}
+
+SimdLevel PredicateKernels::DetectLevel() {
+#ifdef PREDICATE_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SimdLevel::kSSE;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+void PredicateKernels::IsNull(const uint64_t *nulls, uint32_t n, uint64_t *bitmap) {
+  std::copy(nulls, nulls + (n + 63) / 64, bitmap);
+}
+
+void PredicateKernels::NotNull(const uint64_t *nulls, uint32_t n, uint64_t *bitmap) {
+  uint32_t words = (n + 63) / 64;
+  for (uint32_t i = 0; i < words; i++) {
+    bitmap[i] = ~nulls[i];
+  }
+  if (n % 64 != 0) {
+    bitmap[words - 1] &= (uint64_t(1) << (n % 64)) - 1;
+  }
+}
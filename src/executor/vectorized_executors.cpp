@@ -0,0 +1,45 @@
+#include "executor/vectorized_executors.h"
+
+/**
+ * VectorizedSeqScanExecutor
+ */
+RowBatch *VectorizedSeqScanExecutor::Next() {
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  const FreeSpaceMap &free_space_map = table_heap->GetFreeSpaceMap();
+  batch_.Clear();
+  while (batch_.GetSize() < VECTOR_SIZE && page_index_ < free_space_map.GetHeapPageCount()) {
+    read_ahead_.Access(page_index_);
+    table_heap->ScanPageViews(free_space_map.GetHeapPage(page_index_++),
+                              [this](const RowView &row) { batch_.Append(row); }, txn_);
+  }
+  return batch_.GetSize() == 0 ? nullptr : &batch_;
+}
+
+/**
+ * VectorizedIndexScanExecutor
+ */
+RowBatch *VectorizedIndexScanExecutor::Next() {
+  TableHeap *table_heap = index_scan_->GetTableInfo()->GetTableHeap();
+  const auto &rids = index_scan_->GetRowIds();
+  batch_.Clear();
+  while (batch_.GetSize() < VECTOR_SIZE && rid_index_ < rids.size()) {
+    table_heap->GetTupleView(rids[rid_index_++], [this](const RowView &row) { batch_.Append(row); });
+  }
+  return batch_.GetSize() == 0 ? nullptr : &batch_;
+}
+
+/**
+ * VectorizedFilterExecutor
+ */
+RowBatch *VectorizedFilterExecutor::Next() {
+  RowBatch *batch;
+  while ((batch = child_->Next()) != nullptr) {
+    auto &selection = batch->GetSelection();
+    uint32_t count = predicate_->Select(*batch, selection.data(), selection.size(), selection.data());
+    selection.resize(count);
+    if (count > 0) {
+      return batch;
+    }
+  }
+  return nullptr;
+}
@@ -1,10 +1,17 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
 #include "page/page.h"
 #include "page/disk_file_meta_page.h"
@@ -13,10 +20,13 @@
 using namespace std;
 
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
 public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             ReplacerType replacer_type = ReplacerType::kLRU);
 
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /**
    * @brief 根据逻辑页号(page_id)获取对应的数据页，如果该数据页不在内存(buffer pool)中，则需要从disk读取到buffer pool
@@ -25,22 +35,22 @@ public:
    * @param page_id 
    * @return Page* 
    */
-  Page *FetchPage(page_id_t page_id);
+  virtual Page *FetchPage(page_id_t page_id);
 
   /**
-   * @brief 取消固定一个数据页
+   * @brief 取消固定一个数据页，is_dirty 只标记该页为脏页，由后台刷盘线程或替换时写回磁盘
    * 
    * @param page_id 
    * @param is_dirty 
    */
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty);
 
   /**
    * @brief 将数据页转储到磁盘中，无论其是否被固定。
    * 
    * @param page_id
    */
-  bool FlushPage(page_id_t page_id);
+  virtual bool FlushPage(page_id_t page_id);
 
   /**
    * @brief 分配一个新的数据页，并将逻辑页号于page_id中返回
@@ -48,25 +58,126 @@ public:
    * @param page_id 
    * @return Page* 
    */
-  Page *NewPage(page_id_t &page_id);
+  virtual Page *NewPage(page_id_t &page_id);
 
   /**
-   * @brief 释放一个数据页
+   * @brief 释放一个数据页；若该页仍被固定，则在最后一次 UnpinPage 时才释放
    * 
    * @param page_id 
+   * @return false 该页仍被固定
    */
-  bool DeletePage(page_id_t page_id);
+  virtual bool DeletePage(page_id_t page_id);
 
-  bool IsPageFree(page_id_t page_id);
+  virtual bool IsPageFree(page_id_t page_id);
 
-  bool CheckAllUnpinned();
+  virtual bool CheckAllUnpinned();
 
   /**
    * @brief 将所有的页面都转储到磁盘中
    */
-  bool FlushAllPages();
+  virtual bool FlushAllPages();
+
+  /**
+   * @brief 缓冲池中页帧的数量
+   */
+  virtual size_t GetPoolSize() { return pool_size_; }
+
+  /**
+   * @brief FetchPage 命中缓冲池的次数，用于统计命中率
+   */
+  virtual size_t GetHitCount() { return hit_count_; }
+
+  /**
+   * @brief FetchPage 需要从磁盘读取的次数
+   */
+  virtual size_t GetMissCount() { return miss_count_; }
+
+  /**
+   * @brief 预读：异步地将数据页读入缓冲池（不固定），已在缓冲池中或请求队列已满时直接忽略
+   *
+   * @param page_id
+   */
+  virtual void PrefetchPage(page_id_t page_id);
+
+  /**
+   * @brief 预读的数据页在被替换前被 FetchPage 访问到的次数
+   */
+  virtual size_t GetPrefetchHitCount() { return prefetch_hit_count_; }
+
+  /**
+   * @brief 预读的数据页未被访问就被替换的次数
+   */
+  virtual size_t GetPrefetchMissCount() { return prefetch_miss_count_; }
+
+  /**
+   * @brief 设置后台刷盘的脏页比例水位：脏页比例超过 high_watermark 时唤醒刷盘线程，
+   * 按 page_id 顺序写回未被固定的脏页，直到比例降到 low_watermark 以下
+   */
+  virtual void SetDirtyWatermarks(double low_watermark, double high_watermark);
+
+  /**
+   * @brief 当前缓冲池中尚未写回磁盘的脏页数量，包括正在异步写回的页
+   */
+  virtual size_t GetDirtyCount();
+
+protected:
+  /**
+   * Used by buffer pools that only dispatch to other instances and own no frames
+   */
+  explicit BufferPoolManager(DiskManager *disk_manager);
 
 private:
+  /**
+   * @brief 将已分配的 page_id 放入一个新的数据页帧中，缓冲池已满时返回 nullptr
+   */
+  Page *NewPageImpl(page_id_t page_id);
+
+  /**
+   * @brief 写回所有页面但不 Sync，ParallelBufferPoolManager 写回全部实例后只 Sync 一次
+   */
+  bool FlushAllPagesImpl();
+
+  /**
+   * @brief 后台刷盘线程主循环
+   */
+  void BackgroundFlush();
+
+  /**
+   * @brief 按 page_id 顺序写回未被固定的脏页，直到脏页数量不超过 target
+   */
+  void FlushDirtyPages(size_t target);
+
+  /**
+   * @brief 后台预读线程主循环
+   */
+  void BackgroundPrefetch();
+
+  /**
+   * @brief 异步地并发读取一批预读页，全部完成后放入空闲的页帧
+   */
+  void LoadPrefetchedPages(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * @brief 等待该页正在进行的异步写回完成，之后才能从磁盘重新读取或再次写回该页
+   */
+  void WaitForWriteBack(page_id_t page_id);
+
+  /**
+   * @brief 从 free list 或 replacer 中取得一个页帧，必要时写回脏页并移除原页的映射
+   */
+  bool GetVictimFrame(frame_id_t *frame_id);
+
+  /**
+   * @brief 移除页帧的映射并放回空闲页列表，页帧中的数据被丢弃
+   */
+  void FreeFrame(frame_id_t frame_id);
+
+  void WriteBack(Page *page);
+
+  void SetDirty(Page *page);
+
+  void SetClean(Page *page);
+
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
@@ -86,6 +197,28 @@ private:
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
   recursive_mutex latch_;                                   // to protect shared data structure
+  size_t hit_count_{0};                                     // fetches served from the buffer pool
+  size_t miss_count_{0};                                    // fetches read from disk
+  size_t dirty_count_{0};                                   // number of frames with is_dirty_ set
+  double low_watermark_{DEFAULT_DIRTY_LOW_WATERMARK};
+  double high_watermark_{DEFAULT_DIRTY_HIGH_WATERMARK};
+  std::thread flusher_;                                     // background dirty page writer
+  std::mutex flusher_latch_;
+  std::condition_variable flusher_cv_;
+  bool flusher_stop_{false};
+  std::vector<bool> prefetched_;                            // frames read ahead and not fetched since
+  std::vector<bool> delete_pending_;                        // frames deleted while pinned, freed at their last unpin
+  size_t prefetch_hit_count_{0};
+  size_t prefetch_miss_count_{0};
+  std::unordered_map<page_id_t, bool> prefetch_in_flight_; // read-ahead being read, set to true if written meanwhile
+  std::thread prefetcher_;                                  // background read-ahead reader
+  std::deque<page_id_t> prefetch_queue_;
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  bool prefetch_stop_{false};
+  std::unordered_set<page_id_t> write_back_in_flight_;      // pages written back asynchronously by the flusher
+  std::mutex write_back_latch_;
+  std::condition_variable write_back_cv_;
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,45 @@
+#ifndef MINISQL_CLOCK_REPLACER_H
+#define MINISQL_CLOCK_REPLACER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * @brief ClockReplacer implements the CLOCK (second chance) replacement policy.
+ * 每个页帧对应一个固定位置的标志位（是否可被替换、引用位），Pin/Unpin 只修改标志位，不分配内存也不做哈希；
+ * Victim 时时钟指针循环扫描，清除引用位，淘汰第一个引用位为 0 的可替换页帧。
+ */
+class ClockReplacer : public Replacer {
+public:
+  /**
+   * @brief Create a new ClockReplacer.
+   * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   */
+  explicit ClockReplacer(size_t num_pages);
+
+  ~ClockReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  /**
+   * @brief 将页帧放入时钟中，并设置其引用位
+   */
+  void Unpin(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  static constexpr uint8_t IN_CLOCK = 1;
+  static constexpr uint8_t REFERENCED = 2;
+
+  std::vector<uint8_t> flags_;  /** IN_CLOCK | REFERENCED bits of each frame */
+  size_t hand_{0};
+  size_t size_{0};
+};
+
+#endif  // MINISQL_CLOCK_REPLACER_H
@@ -0,0 +1,64 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <cstdint>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+/**
+ * @brief LRUKReplacer implements the LRU-K replacement policy.
+ * 每次 Pin 视为对该页帧的一次访问，记录最近 K 次访问的时间戳；Victim 时淘汰 backward K-distance
+ * （当前时间与倒数第 K 次访问时间之差）最大的页帧。访问不足 K 次的页帧距离视为无穷大，它们之间按最早访问时间淘汰，
+ * 因此只被扫描过一次的页面会先于被反复访问的索引页被替换。
+ */
+class LRUKReplacer : public Replacer {
+public:
+  /**
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = 2);
+
+  ~LRUKReplacer() override;
+
+  /**
+   * @brief 淘汰 backward K-distance 最大的页帧，并清空其访问历史
+   */
+  bool Victim(frame_id_t *frame_id) override;
+
+  /**
+   * @brief 固定页帧，并记录一次访问
+   */
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  /**
+   * @brief 移出页帧并清空其访问历史
+   */
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+private:
+  /** (has K accesses, K-th most recent access or first access, frame), smallest is evicted first */
+  using EvictKey = std::tuple<bool, uint64_t, frame_id_t>;
+
+  EvictKey GetEvictKey(frame_id_t frame_id) const;
+
+  void ClearHistory(frame_id_t frame_id);
+
+private:
+  size_t k_;
+  uint64_t current_timestamp_{0};
+  std::vector<uint64_t> history_;     /** K most recent access timestamps per frame, history_[frame * k_] is oldest */
+  std::vector<uint32_t> access_count_;
+  std::vector<bool> evictable_;
+  std::set<EvictKey> evict_set_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
@@ -0,0 +1,68 @@
+#ifndef MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+#define MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * @brief ParallelBufferPoolManager 将 page_id 哈希到多个独立的 BufferPoolManager 实例上，
+ * 每个实例拥有自己的 latch、free list 与 replacer，不同分片上的操作互不阻塞。
+ * 对外接口与 BufferPoolManager 相同，可以直接替换使用。
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+public:
+  /**
+   * @param num_instances number of buffer pool instances
+   * @param pool_size number of frames of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            ReplacerType replacer_type = ReplacerType::kLRU);
+
+  ~ParallelBufferPoolManager() override;
+
+  Page *FetchPage(page_id_t page_id) override;
+
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  bool FlushPage(page_id_t page_id) override;
+
+  /**
+   * @brief 分配一个新的数据页，该页所属的实例已满时返回 nullptr
+   */
+  Page *NewPage(page_id_t &page_id) override;
+
+  bool DeletePage(page_id_t page_id) override;
+
+  void PrefetchPage(page_id_t page_id) override;
+
+  bool CheckAllUnpinned() override;
+
+  bool FlushAllPages() override;
+
+  size_t GetPoolSize() override;
+
+  size_t GetHitCount() override;
+
+  size_t GetMissCount() override;
+
+  size_t GetPrefetchHitCount() override;
+
+  size_t GetPrefetchMissCount() override;
+
+  void SetDirtyWatermarks(double low_watermark, double high_watermark) override;
+
+  size_t GetDirtyCount() override;
+
+  inline size_t GetNumInstances() const { return instances_.size(); }
+
+private:
+  BufferPoolManager *GetBufferPoolManager(page_id_t page_id) {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()];
+  }
+
+private:
+  std::vector<BufferPoolManager *> instances_;
+};
+
+#endif  // MINISQL_PARALLEL_BUFFER_POOL_MANAGER_H
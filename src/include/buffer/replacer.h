@@ -4,6 +4,11 @@
 #include <cstdio>
 #include "common/config.h"
 
+/**
+ * Replacement policies a BufferPoolManager can be constructed with.
+ */
+enum class ReplacerType { kLRU, kClock, kLRUK };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -32,6 +37,12 @@ public:
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame whose page was deleted, it goes back to the free list and must not be victimized.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -6,6 +6,8 @@
 #include "catalog/table.h"
 #include "index/generic_key.h"
 #include "index/b_plus_tree_index.h"
+#include "index/fixed_key.h"
+#include "index/hash_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
@@ -14,7 +16,7 @@ class IndexMetadata {
 public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name,
                                const table_id_t table_id, const std::vector<uint32_t> &key_map,
-                               MemHeap *heap);
+                               MemHeap *heap, IndexType index_type = IndexType::kBPlusTree);
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -32,16 +34,20 @@ public:
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline IndexType GetIndexType() const { return index_type_; }
+
 private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map)
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map,
+                         IndexType index_type = IndexType::kBPlusTree)
   {
     index_id_ = index_id;
     index_name_ = index_name;
     table_id_ = table_id;
     key_map_ = key_map;
+    index_type_ = index_type;
   }
 
 private:
@@ -50,6 +56,7 @@ private:
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_;  /** The mapping of index key to tuple key */
+  IndexType index_type_;
 };
 
 /**
@@ -80,6 +87,8 @@ public:
 
   inline std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
+  inline IndexType GetIndexType() const { return meta_data_->GetIndexType(); }
+
   inline IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
   inline MemHeap *GetMemHeap() const { return heap_; }
@@ -92,37 +101,67 @@ private:
 
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
     Index *ind = nullptr;
-    // fixed length to serialize row: rowid and count
-    uint32_t index_total_len = 12;
-    // max length to corresponding column
+    bool unique = false;
+    for(auto column : key_schema_->GetColumns())
+    {
+      unique = unique || column->IsUnique();
+    }
+    // a single unique not null int or float column is keyed on its native value
+    if(key_schema_->GetColumnCount() == 1 && unique && !key_schema_->GetColumn(0)->IsNullable())
+    {
+      if(key_schema_->GetColumn(0)->GetType() == kTypeInt)
+      {
+        return CreateIndex<FixedKey<int32_t>,RowId,FixedComparator<int32_t>>(buffer_pool_manager);
+      }
+      if(key_schema_->GetColumn(0)->GetType() == kTypeFloat)
+      {
+        return CreateIndex<FixedKey<float_t>,RowId,FixedComparator<float_t>>(buffer_pool_manager);
+      }
+    }
+    // rowid suffix of non-unique keys, see GenericKey
+    uint32_t index_total_len = unique ? 0 : sizeof(uint64_t);
+    // max length to corresponding column: null flag, value and the terminator of char
     for(uint32_t i = 0; i < key_schema_->GetColumnCount(); i++)
     {
       index_total_len += 1;
       index_total_len += key_schema_->GetColumn(i)->GetLength();
+      if(key_schema_->GetColumn(i)->GetType() == kTypeChar)index_total_len += 1;
     }
     if(index_total_len <= 4)
     {
-      ind = new BPlusTreeIndex<GenericKey<4>,RowId,GenericComparator<4>>(meta_data_->GetIndexId() ,key_schema_, buffer_pool_manager);
+      ind = CreateIndex<GenericKey<4>,RowId,GenericComparator<4>>(buffer_pool_manager);
     }
     else if(index_total_len <= 8)
     {
-      ind = new BPlusTreeIndex<GenericKey<8>,RowId,GenericComparator<8>>(meta_data_->GetIndexId() ,key_schema_, buffer_pool_manager);
+      ind = CreateIndex<GenericKey<8>,RowId,GenericComparator<8>>(buffer_pool_manager);
     }
     else if(index_total_len <= 16)
     {
-      ind = new BPlusTreeIndex<GenericKey<16>,RowId,GenericComparator<16>>(meta_data_->GetIndexId() ,key_schema_, buffer_pool_manager);
+      ind = CreateIndex<GenericKey<16>,RowId,GenericComparator<16>>(buffer_pool_manager);
     }
     else if(index_total_len <= 32)
     {
-      ind = new BPlusTreeIndex<GenericKey<32>,RowId,GenericComparator<32>>(meta_data_->GetIndexId() ,key_schema_, buffer_pool_manager);
+      ind = CreateIndex<GenericKey<32>,RowId,GenericComparator<32>>(buffer_pool_manager);
     }
     else
     {
-      ind = new BPlusTreeIndex<GenericKey<64>,RowId,GenericComparator<64>>(meta_data_->GetIndexId() ,key_schema_, buffer_pool_manager);
+      ind = CreateIndex<GenericKey<64>,RowId,GenericComparator<64>>(buffer_pool_manager);
     }
     return ind;
   }
 
+  /**
+   * @brief 按元数据中的索引类型创建对应键长的索引
+   */
+  template<typename KeyType, typename ValueType, typename KeyComparator>
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
+    if(meta_data_->GetIndexType() == IndexType::kHash)
+    {
+      return new HashIndex<KeyType,ValueType,KeyComparator>(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager);
+    }
+    return new BPlusTreeIndex<KeyType,ValueType,KeyComparator>(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager);
+  }
+
 private:
   IndexMetadata *meta_data_;
   Index *index_;
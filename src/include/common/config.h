@@ -15,6 +15,15 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;        // logical page id of the i
 
 static constexpr int PAGE_SIZE = 4096;               // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer pool
+static constexpr double DEFAULT_DIRTY_LOW_WATERMARK = 0.25;  // background flusher writes back down to this dirty ratio
+static constexpr double DEFAULT_DIRTY_HIGH_WATERMARK = 0.5;  // background flusher is woken above this dirty ratio
+static constexpr int BACKGROUND_FLUSH_INTERVAL_MS = 100;     // period of background flusher checks
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 64;      // max asynchronous disk requests in flight
+static constexpr int ASYNC_IO_THREADS = 4;           // workers of the thread pool used when io_uring is unavailable
+static constexpr double DEFAULT_INDEX_FILL_FACTOR = 0.9;    // fraction of each page filled by index bulk loading
+static constexpr size_t DEFAULT_SORT_BUFFER_SIZE = 64 << 20; // memory of external sort before spilling runs to disk
+static constexpr size_t MAX_INDEX_BUILD_THREADS = 16;        // workers scanning the table when building an index
+static constexpr uint32_t VECTOR_SIZE = 1024;        // rows of a batch in vectorized execution
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
@@ -12,8 +13,12 @@
 
 class DBStorageEngine {
 public:
+  /**
+   * @param buffer_pool_instances buffer_pool_size frames are split across this many buffer pool instances
+   */
   explicit DBStorageEngine(std::string db_name, bool init = true,
-                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE)
+                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = 1)
           : db_file_name_(std::move(db_name)), init_(init) {
     // Init database file if needed
     if (init_) {
@@ -21,7 +26,11 @@ public:
     }
     // Initialize components
     disk_mgr_ = new DiskManager(db_file_name_);
-    bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+    if (buffer_pool_instances > 1) {
+      bpm_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size / buffer_pool_instances, disk_mgr_);
+    } else {
+      bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+    }
     catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
     // Allocate static page for db storage engine
     if (init) {
@@ -36,6 +36,19 @@ public:
     }
   }
 
+  /**
+   * Try to acquire a write latch without blocking.
+   * @return true if the latch is acquired
+   */
+  bool TryWLock() {
+    std::lock_guard<mutex_t> guard(mutex_);
+    if (writer_entered_ || reader_count_ > 0) {
+      return false;
+    }
+    writer_entered_ = true;
+    return true;
+  }
+
   /**
    * Release a write latch.
    */
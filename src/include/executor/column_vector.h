@@ -0,0 +1,111 @@
+#ifndef MINISQL_COLUMN_VECTOR_H
+#define MINISQL_COLUMN_VECTOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+
+/**
+ * Values of one column for a batch of rows, stored as a typed array.
+ *
+ * int and float values are kept in int32_t and float arrays, chars are packed into one buffer and read back
+ * as string views. A null value takes a placeholder slot in the array and its bit in the null bitmap.
+ */
+class ColumnVector {
+public:
+  explicit ColumnVector(TypeId type) : type_(type) {}
+
+  void Clear();
+
+  /**
+   * @brief 追加一个值，field 的类型必须和列的类型一致
+   */
+  void Append(const Field &field);
+
+  /**
+   * @brief 追加 row 的第 column_index 个字段，直接从行的字节解码，不经过 Field
+   */
+  void Append(const RowView &row, uint32_t column_index);
+
+  inline TypeId GetType() const { return type_; }
+
+  inline uint32_t GetSize() const { return size_; }
+
+  inline const int32_t *GetInts() const { return ints_.data(); }
+
+  inline const float *GetFloats() const { return floats_.data(); }
+
+  inline std::string_view GetString(uint32_t i) const {
+    return std::string_view(chars_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+  }
+
+  /**
+   * @brief 第 i 个值为 null 时第 i 位为 1
+   */
+  inline const uint64_t *GetNullBitmap() const { return nulls_.data(); }
+
+  inline bool IsNull(uint32_t i) const { return (nulls_[i >> 6] >> (i & 63)) & 1; }
+
+  inline bool HasNull() const { return null_count_ > 0; }
+
+private:
+  /**
+   * @brief 为下一个值准备 null bitmap 中的位，is_null 时置位
+   */
+  void AppendNull(bool is_null);
+
+  TypeId type_;
+  uint32_t size_{0};
+  uint32_t null_count_{0};
+  std::vector<int32_t> ints_;
+  std::vector<float> floats_;
+  std::string chars_;                     /** chars of all values, back to back */
+  std::vector<uint32_t> offsets_{0};      /** value i is chars_[offsets_[i], offsets_[i + 1]) */
+  std::vector<uint64_t> nulls_;
+};
+
+/**
+ * A batch of rows stored column by column, with the row ids of the rows and a selection vector.
+ *
+ * The selection vector lists the positions of the rows still qualifying, in increasing order; a scan selects
+ * every row and each filter narrows it down, so filters never move column data.
+ */
+class RowBatch {
+public:
+  explicit RowBatch(const Schema *schema);
+
+  void Clear();
+
+  /**
+   * @brief 追加一行并选中它
+   */
+  void Append(const Row &row);
+
+  void Append(const RowView &row);
+
+  inline uint32_t GetSize() const { return static_cast<uint32_t>(rids_.size()); }
+
+  inline const ColumnVector &GetColumn(uint32_t column_index) const { return columns_[column_index]; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline const RowId &GetRowId(uint32_t i) const { return rids_[i]; }
+
+  inline std::vector<uint32_t> &GetSelection() { return selection_; }
+
+  inline const std::vector<uint32_t> &GetSelection() const { return selection_; }
+
+private:
+  std::vector<ColumnVector> columns_;
+  std::vector<RowId> rids_;
+  std::vector<uint32_t> selection_;
+};
+
+#endif  // MINISQL_COLUMN_VECTOR_H
@@ -5,6 +5,8 @@
 #include <unordered_map>
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "executor/executors.h"
+#include "executor/vectorized_executors.h"
 #include "transaction/transaction.h"
 
 extern "C" {
@@ -82,7 +84,29 @@ private:
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database */
-  std::vector<RowId> Condition(pSyntaxNode ast, std::string table_name);
+
+  /**
+   * @brief 表上只包含 column_name 一列的索引，没有时返回 nullptr
+   *
+   * @param range 用于范围查询时只选择 B+ 树索引，否则优先选择 hash 索引
+   */
+  IndexInfo *GetColumnIndex(const std::string &table_name, const std::string &column_name, bool range);
+
+  /**
+   * @brief WHERE 条件的扫描计划：能用索引时用 IndexScan，否则用 SeqScan，其上的 Filter 求完整的条件
+   *
+   * @param condition kNodeConditions 节点，没有 WHERE 时为 nullptr
+   * @return 条件中有不存在的列时返回 nullptr
+   */
+  AbstractExecutor *PlanScan(pSyntaxNode condition, TableInfo *table_info, Transaction *txn);
+
+  /**
+   * @brief 用索引求解条件 ast 的 IndexScan：某列上的 =，<, <=, >, >=，以及同一列上两个这样的条件的 and（如 BETWEEN）；
+   * 其他的 and 在两边的条件中找
+   *
+   * @return 没有可以用索引求解的条件时返回 nullptr
+   */
+  IndexScanExecutor *PlanIndexScan(pSyntaxNode ast, TableInfo *table_info, Transaction *txn);
 };
 
 #endif //MINISQL_EXECUTE_ENGINE_H
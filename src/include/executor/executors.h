@@ -0,0 +1,261 @@
+#ifndef MINISQL_EXECUTORS_H
+#define MINISQL_EXECUTORS_H
+
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "catalog/table.h"
+#include "executor/predicate.h"
+#include "record/row.h"
+#include "transaction/transaction.h"
+
+/**
+ * Pull based (volcano) operators.
+ *
+ * A plan is a tree of executors, the root is driven by Open(), Next() until it returns nullptr, then Close().
+ * Every Next() pulls just enough rows from the children to produce one row, so results stream and a plan
+ * over a whole table only holds one heap page of rows at a time. A parent owns its children.
+ */
+class AbstractExecutor {
+public:
+  virtual ~AbstractExecutor() = default;
+
+  virtual void Open() = 0;
+
+  /**
+   * @return 下一行，没有更多的行时返回 nullptr。返回的行归执行器所有，下一次 Next 或 Close 之前有效
+   */
+  virtual Row *Next() = 0;
+
+  virtual void Close() = 0;
+};
+
+/**
+ * Scans the heap page by page. All tuples of a page are deserialized under one page latch and buffered,
+ * so each tuple is read once, and rows the parent changes on the current page are not seen again.
+ */
+class SeqScanExecutor : public AbstractExecutor {
+public:
+  SeqScanExecutor(TableInfo *table_info, Transaction *txn)
+          : table_info_(table_info), txn_(txn), read_ahead_(table_info->GetTableHeap()->NewReadAhead()) {}
+
+  void Open() override;
+
+  Row *Next() override;
+
+  void Close() override;
+
+private:
+  TableInfo *table_info_;
+  Transaction *txn_;
+  uint32_t page_index_{0};    /** next heap page to scan, in heap chain order */
+  ReadAhead read_ahead_;      /** prefetches the pages after page_index_ */
+  std::deque<Row> rows_;      /** rows of the current page */
+  size_t row_index_{0};
+};
+
+/**
+ * Looks up one key or scans a key range of an index, then fetches the matching tuples one by one.
+ * The index only returns row ids in bulk, so the matching row ids are collected on Open().
+ */
+class IndexScanExecutor : public AbstractExecutor {
+public:
+  /**
+   * @brief 等值查询 key
+   */
+  IndexScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field &key, Transaction *txn);
+
+  /**
+   * @brief 范围查询，lo 或者 hi 为 nullptr 表示该侧没有边界
+   */
+  IndexScanExecutor(TableInfo *table_info, IndexInfo *index_info, const Field *lo, bool lo_inclusive,
+                    const Field *hi, bool hi_inclusive, Transaction *txn);
+
+  void Open() override;
+
+  Row *Next() override;
+
+  void Close() override;
+
+  /**
+   * @brief Open 之后为索引找到的所有 RowId，按索引键的顺序
+   */
+  inline const std::vector<RowId> &GetRowIds() const { return rids_; }
+
+  inline TableInfo *GetTableInfo() const { return table_info_; }
+
+private:
+  TableInfo *table_info_;
+  IndexInfo *index_info_;
+  Transaction *txn_;
+  bool point_;
+  std::vector<Field> lo_;     /** key of a point lookup, or the lower bound, empty if unbounded */
+  bool lo_inclusive_{false};
+  std::vector<Field> hi_;     /** upper bound, empty if unbounded */
+  bool hi_inclusive_{false};
+  std::vector<RowId> rids_;
+  size_t rid_index_{0};
+  Row *row_{nullptr};
+};
+
+class FilterExecutor : public AbstractExecutor {
+public:
+  /**
+   * @brief child 和 predicate 归 FilterExecutor 所有
+   */
+  FilterExecutor(AbstractExecutor *child, Predicate *predicate) : child_(child), predicate_(predicate) {}
+
+  ~FilterExecutor() override {
+    delete child_;
+    delete predicate_;
+  }
+
+  void Open() override { child_->Open(); }
+
+  Row *Next() override;
+
+  void Close() override { child_->Close(); }
+
+private:
+  AbstractExecutor *child_;
+  Predicate *predicate_;
+};
+
+/**
+ * Outputs the given columns of the child rows, in the given order.
+ */
+class ProjectionExecutor : public AbstractExecutor {
+public:
+  ProjectionExecutor(AbstractExecutor *child, std::vector<uint32_t> column_indexes)
+          : child_(child), column_indexes_(std::move(column_indexes)) {}
+
+  ~ProjectionExecutor() override {
+    delete child_;
+    delete row_;
+  }
+
+  void Open() override { child_->Open(); }
+
+  Row *Next() override;
+
+  void Close() override;
+
+private:
+  AbstractExecutor *child_;
+  std::vector<uint32_t> column_indexes_;
+  Row *row_{nullptr};
+};
+
+/**
+ * Base of the operators that change a table, keeps the indexes of the table in step with the heap.
+ * A DML executor handles one row per Next() and outputs it, the caller counts the affected rows.
+ * Failed() tells a constraint violation apart from the end of the input.
+ */
+class ModifyExecutor : public AbstractExecutor {
+public:
+  bool Failed() const { return failed_; }
+
+protected:
+  ModifyExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, Transaction *txn);
+
+  /**
+   * @brief row 中 index 键列组成的键
+   */
+  Row KeyOf(const Row &row, size_t index) const;
+
+  /**
+   * @brief 唯一索引中已经有 key 对应的其他行时返回 true
+   */
+  bool Conflicts(size_t index, const Row &key, const RowId &self) const;
+
+protected:
+  TableInfo *table_info_;
+  std::vector<IndexInfo *> indexes_;
+  std::vector<std::vector<uint32_t>> key_columns_;  /** column indexes in the table of every index key */
+  std::vector<bool> unique_;
+  Transaction *txn_;
+  bool failed_{false};
+};
+
+class InsertExecutor : public ModifyExecutor {
+public:
+  /**
+   * @param values 每个元素是要插入的一行
+   */
+  InsertExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, std::vector<std::vector<Field>> values,
+                 Transaction *txn)
+          : ModifyExecutor(table_info, std::move(indexes), txn), values_(std::move(values)) {}
+
+  ~InsertExecutor() override { delete row_; }
+
+  void Open() override { value_index_ = 0; }
+
+  Row *Next() override;
+
+  void Close() override {}
+
+private:
+  std::vector<std::vector<Field>> values_;
+  size_t value_index_{0};
+  Row *row_{nullptr};
+};
+
+/**
+ * Deletes the rows of the child, which must come from a scan of the same table.
+ */
+class DeleteExecutor : public ModifyExecutor {
+public:
+  DeleteExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, AbstractExecutor *child, Transaction *txn)
+          : ModifyExecutor(table_info, std::move(indexes), txn), child_(child) {}
+
+  ~DeleteExecutor() override { delete child_; }
+
+  void Open() override { child_->Open(); }
+
+  Row *Next() override;
+
+  void Close() override { child_->Close(); }
+
+private:
+  AbstractExecutor *child_;
+};
+
+/**
+ * Sets columns of the rows of the child, which must come from a scan of the same table.
+ *
+ * A row that grows out of its page moves to another page, possibly one the scan has not reached yet, so
+ * the new row ids are remembered and skipped when the scan reaches them (the Halloween problem).
+ */
+class UpdateExecutor : public ModifyExecutor {
+public:
+  /**
+   * @param column_indexes 要更新的列
+   * @param values 对应列的新值
+   */
+  UpdateExecutor(TableInfo *table_info, std::vector<IndexInfo *> indexes, AbstractExecutor *child,
+                 std::vector<uint32_t> column_indexes, std::vector<Field> values, Transaction *txn)
+          : ModifyExecutor(table_info, std::move(indexes), txn), child_(child),
+            column_indexes_(std::move(column_indexes)), values_(std::move(values)) {}
+
+  ~UpdateExecutor() override {
+    delete child_;
+    delete row_;
+  }
+
+  void Open() override { child_->Open(); }
+
+  Row *Next() override;
+
+  void Close() override;
+
+private:
+  AbstractExecutor *child_;
+  std::vector<uint32_t> column_indexes_;
+  std::vector<Field> values_;
+  std::unordered_set<int64_t> moved_;   /** RowId::Get() of the rows moved by this update */
+  Row *row_{nullptr};
+};
+
+#endif  // MINISQL_EXECUTORS_H
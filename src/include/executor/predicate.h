@@ -0,0 +1,90 @@
+#ifndef MINISQL_PREDICATE_H
+#define MINISQL_PREDICATE_H
+
+#include "executor/column_vector.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+extern "C" {
+#include "parser/syntax_tree.h"
+};
+
+/**
+ * @brief 将条件或者 VALUES 中的字面量转换为 type 类型的 Field，返回的 Field 由调用者 delete
+ */
+Field *NewLiteralField(TypeId type, char *val);
+
+/**
+ * Predicate tree compiled from a WHERE clause.
+ *
+ * Column names are resolved to column indexes of the table schema once, and literals are converted to the
+ * column type once, so evaluating a row does no lookups. A comparison is true only when it compares kTrue,
+ * comparisons with null are false.
+ */
+class Predicate {
+public:
+  enum class Kind { kAnd, kOr, kCompare, kIsNull, kNotNull };
+
+  enum class CompareOp { kEqual, kNotEqual, kLess, kLessEqual, kGreater, kGreaterEqual };
+
+  /**
+   * @brief 从 kNodeConditions 的子节点编译谓词树
+   *
+   * @return 条件中的列不存在或者条件形式不支持时返回 nullptr
+   */
+  static Predicate *Create(pSyntaxNode ast, Schema *schema);
+
+  static Predicate *Compare(uint32_t column_index, CompareOp op, const Field &value);
+
+  static Predicate *IsNull(uint32_t column_index);
+
+  static Predicate *NotNull(uint32_t column_index);
+
+  /**
+   * @brief left 和 right 归新节点所有
+   */
+  static Predicate *And(Predicate *left, Predicate *right);
+
+  static Predicate *Or(Predicate *left, Predicate *right);
+
+  ~Predicate();
+
+  bool Evaluate(const Row &row) const;
+
+  /**
+   * @brief 在 batch 中 selection 列出的 count 行上求值，满足条件的行按原来的顺序写入 result
+   *
+   * @return 满足条件的行数。result 可以就是 selection
+   */
+  uint32_t Select(const RowBatch &batch, const uint32_t *selection, uint32_t count, uint32_t *result) const;
+
+  inline Kind GetKind() const { return kind_; }
+
+  inline CompareOp GetCompareOp() const { return op_; }
+
+  inline uint32_t GetColumnIndex() const { return column_index_; }
+
+  inline const Field *GetValue() const { return value_; }
+
+  inline const Predicate *GetLeft() const { return left_; }
+
+  inline const Predicate *GetRight() const { return right_; }
+
+private:
+  explicit Predicate(Kind kind) : kind_(kind) {}
+
+  Predicate(const Predicate &other) = delete;
+
+  Predicate &operator=(const Predicate &other) = delete;
+
+private:
+  Kind kind_;
+  CompareOp op_{CompareOp::kEqual};
+  uint32_t column_index_{0};
+  Field *value_{nullptr};         /** literal of kCompare, owned */
+  Predicate *left_{nullptr};      /** children of kAnd and kOr, owned */
+  Predicate *right_{nullptr};
+};
+
+#endif  // MINISQL_PREDICATE_H
@@ -0,0 +1,64 @@
+#ifndef MINISQL_PREDICATE_KERNELS_H
+#define MINISQL_PREDICATE_KERNELS_H
+
+#include <cstdint>
+
+#include "executor/predicate.h"
+
+/**
+ * Instruction sets the predicate kernels are built for, in increasing order of width
+ */
+enum class SimdLevel { kScalar, kSSE, kAVX2 };
+
+/**
+ * Kernels comparing a column vector against a constant, one bit per value in an output selection bitmap.
+ *
+ * Each kernel exists as a portable scalar loop and, on x86-64, as SSE (4 lanes) and AVX2 (8 lanes) code
+ * compiled with function level target attributes. The widest set the CPU supports is picked once at runtime
+ * through CPU feature detection rather than taken from the compiler flags.
+ * Float comparisons follow the scalar operators, <> is true and every other comparison false for NaN.
+ */
+class PredicateKernels {
+public:
+  /**
+   * @brief bitmap 的第 i 位为 values[i] op value，bitmap 有 (n + 63) / 64 个字，最后一个字中 n 之后的位为 0
+   */
+  using IntKernel = void (*)(const int32_t *values, uint32_t n, int32_t value, uint64_t *bitmap);
+
+  using FloatKernel = void (*)(const float *values, uint32_t n, float value, uint64_t *bitmap);
+
+  /**
+   * @brief 当前 CPU 上最快的 kernels
+   */
+  static const PredicateKernels &Get();
+
+  /**
+   * @brief 指定指令集的 kernels，level 必须不高于 DetectLevel()
+   */
+  static const PredicateKernels &Get(SimdLevel level);
+
+  /**
+   * @brief CPU 支持的最高指令集，不是 x86-64 时为 kScalar
+   */
+  static SimdLevel DetectLevel();
+
+  inline IntKernel GetIntKernel(Predicate::CompareOp op) const { return int_kernels_[static_cast<int>(op)]; }
+
+  inline FloatKernel GetFloatKernel(Predicate::CompareOp op) const {
+    return float_kernels_[static_cast<int>(op)];
+  }
+
+  /**
+   * @brief IS NULL 的 bitmap 就是 null bitmap 本身，NOT NULL 取反并清掉 n 之后的位；按 64 位的字处理，不需要 SIMD
+   */
+  static void IsNull(const uint64_t *nulls, uint32_t n, uint64_t *bitmap);
+
+  static void NotNull(const uint64_t *nulls, uint32_t n, uint64_t *bitmap);
+
+  static constexpr int kCompareOps = 6;
+
+  IntKernel int_kernels_[kCompareOps];
+  FloatKernel float_kernels_[kCompareOps];
+};
+
+#endif  // MINISQL_PREDICATE_KERNELS_H
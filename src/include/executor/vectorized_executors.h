@@ -0,0 +1,116 @@
+#ifndef MINISQL_VECTORIZED_EXECUTORS_H
+#define MINISQL_VECTORIZED_EXECUTORS_H
+
+#include "catalog/table.h"
+#include "executor/column_vector.h"
+#include "executor/executors.h"
+#include "executor/predicate.h"
+#include "transaction/transaction.h"
+
+/**
+ * Vectorized operators, the batch at a time counterpart of AbstractExecutor.
+ *
+ * Next() returns a batch of about VECTOR_SIZE rows in column vectors, only the rows in the selection vector of
+ * the batch are part of the result. Operators work on whole columns in tight loops instead of calling through
+ * Field and Type once per row and value.
+ */
+class VectorizedExecutor {
+public:
+  virtual ~VectorizedExecutor() = default;
+
+  virtual void Open() = 0;
+
+  /**
+   * @return 下一批行，没有更多的行时返回 nullptr。返回的批归执行器所有，下一次 Next 或 Close 之前有效
+   */
+  virtual RowBatch *Next() = 0;
+
+  virtual void Close() = 0;
+};
+
+/**
+ * Scans the heap into batches. A batch is filled page by page and ends at the first page boundary after
+ * VECTOR_SIZE rows, so a batch holds at most VECTOR_SIZE rows plus one page of rows.
+ */
+class VectorizedSeqScanExecutor : public VectorizedExecutor {
+public:
+  VectorizedSeqScanExecutor(TableInfo *table_info, Transaction *txn)
+          : table_info_(table_info), txn_(txn), read_ahead_(table_info->GetTableHeap()->NewReadAhead()),
+            batch_(table_info->GetSchema()) {}
+
+  void Open() override { page_index_ = 0; }
+
+  RowBatch *Next() override;
+
+  void Close() override { batch_.Clear(); }
+
+private:
+  TableInfo *table_info_;
+  Transaction *txn_;
+  uint32_t page_index_{0};
+  ReadAhead read_ahead_;
+  RowBatch batch_;
+};
+
+/**
+ * Reads the rows an IndexScanExecutor finds into batches of VECTOR_SIZE rows, in index order. Only the row ids
+ * of the index scan are used, the tuples are decoded from the pages into the batch without building rows.
+ */
+class VectorizedIndexScanExecutor : public VectorizedExecutor {
+public:
+  /**
+   * @brief index_scan 归 VectorizedIndexScanExecutor 所有
+   */
+  VectorizedIndexScanExecutor(IndexScanExecutor *index_scan, Transaction *txn)
+          : index_scan_(index_scan), txn_(txn), batch_(index_scan->GetTableInfo()->GetSchema()) {}
+
+  ~VectorizedIndexScanExecutor() override { delete index_scan_; }
+
+  void Open() override {
+    index_scan_->Open();
+    rid_index_ = 0;
+  }
+
+  RowBatch *Next() override;
+
+  void Close() override {
+    index_scan_->Close();
+    batch_.Clear();
+  }
+
+private:
+  IndexScanExecutor *index_scan_;
+  Transaction *txn_;
+  size_t rid_index_{0};
+  RowBatch batch_;
+};
+
+/**
+ * Narrows the selection vector of the child batches down to the rows satisfying the predicate, batches
+ * without any such row are skipped.
+ */
+class VectorizedFilterExecutor : public VectorizedExecutor {
+public:
+  /**
+   * @brief child 和 predicate 归 VectorizedFilterExecutor 所有
+   */
+  VectorizedFilterExecutor(VectorizedExecutor *child, Predicate *predicate)
+          : child_(child), predicate_(predicate) {}
+
+  ~VectorizedFilterExecutor() override {
+    delete child_;
+    delete predicate_;
+  }
+
+  void Open() override { child_->Open(); }
+
+  RowBatch *Next() override;
+
+  void Close() override { child_->Close(); }
+
+private:
+  VectorizedExecutor *child_;
+  Predicate *predicate_;
+};
+
+#endif  // MINISQL_VECTORIZED_EXECUTORS_H
@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <functional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -8,6 +9,7 @@
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
+#include "common/rwlatch.h"
 #include "transaction/transaction.h"
 #include "index/index_iterator.h"
 #include "page/index_roots_page.h"
@@ -23,6 +25,9 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Thread safe by latch crabbing: writers first read latch down the tree and
+ *     write latch only the leaf, and retry with write latches along the path if
+ *     the leaf may split or underflow
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -45,13 +50,28 @@ public:
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
+  /**
+   * @brief 自底向上地批量建立空的 B+ 树：按 fill_factor 填满叶子页，再逐层建立内部页
+   *
+   * @param count 条目数量
+   * @param next 按键严格递增的顺序依次给出 count 个条目，没有更多条目时返回 false
+   * @return 树不为空、条目不足或键不严格递增时返回 false，此时树保持为空
+   */
+  bool BulkLoad(size_t count, const std::function<bool(MappingType &)> &next,
+                double fill_factor = DEFAULT_INDEX_FILL_FACTOR);
+
+  /**
+   * @brief 树的页数，用于统计，不能与修改并发
+   */
+  size_t GetPageCount();
+
   INDEXITERATOR_TYPE Begin();
 
   INDEXITERATOR_TYPE Begin(const KeyType &key);
 
   INDEXITERATOR_TYPE End();
 
-  // expose for test purpose
+  // expose for test purpose, the returned leaf is pinned but not latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
   // used to check whether all pages are unpinned
@@ -83,27 +103,82 @@ public:
   }
 
 private:
+  enum class Operation { kInsert, kRemove };
+
+  /**
+   * @brief 悲观路径上持有写锁的页（每页由 context 持有一次 pin），释放锁之后才能删除的页，以及是否持有 root_latch_
+   */
+  struct LatchContext {
+    std::vector<Page *> latched_pages_;
+    std::vector<page_id_t> deleted_pages_;
+    bool root_latched_{false};
+  };
+
+  /**
+   * @brief 乐观下降：内部节点加读锁逐层交接，叶子页按 exclusive 加写锁或读锁
+   * @return 加锁并固定的叶子页，树为空时返回 nullptr
+   */
+  Page *CrabToLeaf(const KeyType &key, bool leftMost, bool exclusive);
+
+  /**
+   * @brief 悲观下降：逐层加写锁，遇到对 op 安全的节点时释放其所有祖先（以及 root_latch_）
+   * @return 叶子页，树为空时返回 nullptr，此时仍持有 root_latch_ 的写锁
+   */
+  Page *CrabToLeafPessimistic(const KeyType &key, Operation op, LatchContext &context);
+
+  /**
+   * @brief 节点执行 op 后不会分裂或下溢，其祖先不会被修改
+   */
+  bool IsSafe(BPlusTreePage *node, Operation op) const;
+
+  /**
+   * @brief 取得 context 中已加写锁的页，不在其中时加写锁并加入 context
+   */
+  Page *FetchLatchedPage(page_id_t page_id, LatchContext &context);
+
+  /**
+   * @brief 叶子即将下溢时尝试对其左兄弟加写锁，失败返回 false
+   */
+  bool TryLatchPrevLeaf(LeafPage *leaf, LatchContext &context);
+
+  /**
+   * @brief 释放 context 持有的所有锁和 pin，然后删除合并掉的页
+   */
+  void ReleaseLatches(LatchContext &context, bool is_dirty);
+
+  /**
+   * @brief 删除 page_id 及其下的所有页
+   */
+  void DestroySubtree(page_id_t page_id);
+
+  /**
+   * @brief 将 count 个条目尽量平均地分到按 fill_factor 填充的页中，每页不超过 max_size 且不少于 min_size 个条目
+   * @return 每页的条目数
+   */
+  static std::vector<int> PlanPageSizes(size_t count, int max_size, int min_size, double fill_factor);
+
+  size_t GetPageCount(page_id_t page_id);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
-  bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+  bool InsertIntoLeaf(const KeyType &key, const ValueType &value, LatchContext &context);
 
-  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                        Transaction *transaction = nullptr);
+  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node, LatchContext &context);
 
   template<typename N>
   N *Split(N *node);
 
   template<typename N>
-  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *node, LatchContext &context);
 
   template<typename N>
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
-                int index, Transaction *transaction = nullptr);
+                int index, LatchContext &context);
 
   template<typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
 
-  bool AdjustRoot(BPlusTreePage *node);
+  bool AdjustRoot(BPlusTreePage *node, LatchContext &context);
 
   void UpdateRootPageId(int insert_record = 0);
 
@@ -117,11 +192,11 @@ private:
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_;
+  ReaderWriterLatch root_latch_;  // protects root_page_id_
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
-  vector<page_id_t> destroy_internal_pages_id;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
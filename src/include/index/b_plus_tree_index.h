@@ -17,19 +17,43 @@ public:
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
 
+  dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, std::vector<RowId> &result,
+                    Transaction *txn) override;
+
+  /**
+   * @brief 将表的数据页按范围分给 num_threads 个线程，各自提取并（必要时在外存）排序键，归并后自底向上建树
+   */
+  dberr_t BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, double fill_factor,
+                   size_t num_threads, Transaction *txn) override;
+
   dberr_t Destroy() override;
 
+  /**
+   * @brief 索引占用的页数
+   */
+  size_t GetPageCount() { return container_.GetPageCount(); }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  bool IsUnique() const { return unique_; }
+
 protected:
+  /**
+   * @brief 编码索引键，非唯一索引在列之后加上 rid 作为后缀
+   */
+  void SerializeKey(const Row &key, uint64_t rid, KeyType &index_key);
+
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPLUSTREE_TYPE container_;
+  // 任一键列为 unique 时索引键唯一，否则键后缀 RowId 以区分重复的键
+  bool unique_;
 };
 
 #endif //MINISQL_B_PLUS_TREE_INDEX_H
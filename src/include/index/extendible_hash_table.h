@@ -0,0 +1,88 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_TABLE_H
+#define MINISQL_EXTENDIBLE_HASH_TABLE_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+#include "page/hash_table_header_page.h"
+#include "transaction/transaction.h"
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Disk based extendible hash table with unique keys.
+ *
+ * (1) A header page picks a directory page by the high bits of the hash, a directory page picks a bucket page by
+ *     the low bits, so the table grows to HASH_HEADER_ARRAY_SIZE * HASH_DIRECTORY_ARRAY_SIZE buckets
+ * (2) A full bucket splits in two, doubling its directory when the bucket is already at the global depth
+ * (3) An empty bucket merges with its split image, and the directory halves when no bucket needs its full depth
+ * (4) The header page id is recorded in the index roots page like the root of a B+ tree
+ * (5) Thread safe by a table latch, lookups share it and modifications hold it exclusively
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ExtendibleHashTable {
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+public:
+  explicit ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, uint32_t header_max_depth = HASH_HEADER_MAX_DEPTH,
+                               uint32_t directory_max_depth = HASH_DIRECTORY_MAX_DEPTH,
+                               uint32_t bucket_max_size = HASH_BUCKET_PAGE_SIZE);
+
+  bool IsEmpty() const { return header_page_id_ == INVALID_PAGE_ID; }
+
+  /**
+   * @return false if the key exists, or its bucket is full and can no longer split
+   */
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * @return false if the key does not exist
+   */
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
+
+  // destroy the hash table
+  void Destroy();
+
+  // used to check whether all pages are unpinned and every directory is consistent
+  bool Check();
+
+private:
+  static uint32_t Hash(const KeyType &key);
+
+  /**
+   * @brief 取得 hash 对应的目录页（已固定），不存在时按 create 创建目录页及其第一个桶，否则返回 nullptr
+   */
+  Page *FetchDirectoryPage(uint32_t hash, bool create);
+
+  /**
+   * @brief 将满的桶分裂为两个，局部深度等于全局深度时先使目录加倍
+   * @return 目录已达到最大深度时返回 false
+   */
+  bool SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx);
+
+  /**
+   * @brief 反复将 hash 所在的桶与其分裂镜像合并，直到两者都不为空，然后尽量缩小目录
+   */
+  void MergeBuckets(HashTableDirectoryPage *directory, uint32_t hash);
+
+  bool CheckDirectory(HashTableDirectoryPage *directory);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  index_id_t index_id_;
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  uint32_t header_max_depth_;
+  uint32_t directory_max_depth_;
+  uint32_t bucket_max_size_;
+  ReaderWriterLatch table_latch_;
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_TABLE_H
@@ -0,0 +1,151 @@
+#ifndef MINISQL_EXTERNAL_SORTER_H
+#define MINISQL_EXTERNAL_SORTER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * Sorts a stream of fixed size items within a bounded memory buffer.
+ *
+ * Items are collected into the buffer, a full buffer is sorted and spilled to a temporary file as a run,
+ * and the runs are merged with a heap while reading them back. Inputs that fit in the buffer never touch disk.
+ * Items are written as raw bytes, so T must not own any memory.
+ *
+ * Usage: Add() every item, Sort() once, then Next() until it returns false.
+ */
+template<typename T, typename Less>
+class ExternalSorter {
+public:
+  explicit ExternalSorter(Less less, size_t buffer_size = DEFAULT_SORT_BUFFER_SIZE)
+          : less_(less), max_items_(std::max<size_t>(buffer_size / sizeof(T), 2)) {
+    static_assert(std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                  "sorted items are spilled as raw bytes");
+  }
+
+  ~ExternalSorter() {
+    for (auto &run : runs_) {
+      fclose(run.file_);
+    }
+  }
+
+  void Add(const T &item) {
+    ASSERT(!sorted_, "Add after Sort.");
+    if (buffer_.size() == max_items_) {
+      SpillRun();
+    }
+    buffer_.push_back(item);
+    count_++;
+  }
+
+  /**
+   * @brief 结束输入，之后可以按顺序读取
+   */
+  void Sort() {
+    ASSERT(!sorted_, "Sort twice.");
+    sorted_ = true;
+    if (runs_.empty()) {
+      std::sort(buffer_.begin(), buffer_.end(), less_);
+      return;
+    }
+    SpillRun();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    // the merge reads every run through its share of the buffer
+    size_t block_items = std::max<size_t>(max_items_ / runs_.size(), 1);
+    for (size_t i = 0; i < runs_.size(); i++) {
+      rewind(runs_[i].file_);
+      runs_[i].block_.resize(block_items);
+      if (FillBlock(runs_[i])) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  /**
+   * @brief 按顺序取出下一项，全部取完返回 false
+   */
+  bool Next(T &item) {
+    ASSERT(sorted_, "Next before Sort.");
+    if (runs_.empty()) {
+      if (read_ofs_ == buffer_.size()) {
+        return false;
+      }
+      item = buffer_[read_ofs_++];
+      return true;
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    size_t i = heap_.top();
+    heap_.pop();
+    auto &run = runs_[i];
+    item = run.block_[run.read_ofs_++];
+    if (run.read_ofs_ < run.block_size_ || FillBlock(run)) {
+      heap_.push(i);
+    }
+    return true;
+  }
+
+  size_t GetCount() const { return count_; }
+
+  /**
+   * @brief 写到磁盘的有序段数量，输入全部在内存中排序时为 0
+   */
+  size_t GetRunCount() const { return runs_.size(); }
+
+private:
+  struct Run {
+    explicit Run(FILE *file) : file_(file) {}
+
+    FILE *file_;
+    std::vector<T> block_;
+    size_t block_size_{0};
+    size_t read_ofs_{0};
+  };
+
+  /**
+   * Orders runs by their current item, the heap keeps the run with the smallest item on top
+   */
+  struct RunGreater {
+    bool operator()(size_t lhs, size_t rhs) const {
+      const auto &lhs_run = sorter_->runs_[lhs];
+      const auto &rhs_run = sorter_->runs_[rhs];
+      return sorter_->less_(rhs_run.block_[rhs_run.read_ofs_], lhs_run.block_[lhs_run.read_ofs_]);
+    }
+
+    const ExternalSorter *sorter_;
+  };
+
+  void SpillRun() {
+    std::sort(buffer_.begin(), buffer_.end(), less_);
+    FILE *file = tmpfile();
+    ASSERT(file != nullptr, "Failed to create sort run.");
+    size_t written = fwrite(buffer_.data(), sizeof(T), buffer_.size(), file);
+    ASSERT(written == buffer_.size(), "Failed to write sort run.");
+    runs_.emplace_back(file);
+    buffer_.clear();
+  }
+
+  bool FillBlock(Run &run) {
+    run.block_size_ = fread(run.block_.data(), sizeof(T), run.block_.size(), run.file_);
+    run.read_ofs_ = 0;
+    return run.block_size_ > 0;
+  }
+
+  Less less_;
+  size_t max_items_;
+  size_t count_{0};
+  bool sorted_{false};
+  std::vector<T> buffer_;
+  size_t read_ofs_{0};
+  std::vector<Run> runs_;
+  std::priority_queue<size_t, std::vector<size_t>, RunGreater> heap_{RunGreater{this}};
+};
+
+#endif  // MINISQL_EXTERNAL_SORTER_H
@@ -2,26 +2,125 @@
 #define MINISQL_GENERIC_KEY_H
 
 #include <cstring>
+#include <vector>
 
 #include "record/row.h"
 #include "record/field.h"
 
+/**
+ * Index key in an order preserving binary encoding, so keys compare with a plain memcmp.
+ *
+ * Each column is a null flag byte (0 for null, which sorts first, 1 otherwise) followed by its value:
+ *  - int: 4 bytes big endian with the sign bit flipped
+ *  - float: 4 bytes big endian of the IEEE bits, with the sign bit flipped for positive numbers and all bits
+ *    flipped for negative ones
+ *  - char: the bytes followed by a 0 terminator, so a shorter string sorts before its extensions
+ * Keys of non-unique indexes are followed by the RowId of the entry, see SetRowIdSuffix.
+ * The rest of the key is zero filled. Char values must not contain 0 bytes.
+ */
 template<size_t KeySize>
 class GenericKey {
 public:
-  inline void SerializeFromKey(const Row &key, Schema *schema) {
-    // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
+  /**
+   * @return 编码后的长度
+   */
+  inline uint32_t SerializeFromKey(const Row &key, Schema *schema) {
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= KeySize, "Index key size exceed max key size.");
+    // initialize to 0
     memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    uint32_t ofs = 0;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      const Field *field = key.GetField(i);
+      TypeId type_id = schema->GetColumn(i)->GetType();
+      uint32_t size = field->IsNull() ? 1 : (type_id == kTypeChar ? field->GetLength() + 2 : 5);
+      ASSERT(ofs + size <= KeySize, "Index key size exceed max key size.");
+      if (field->IsNull()) {
+        ofs++;
+        continue;
+      }
+      data[ofs++] = 1;
+      if (type_id == kTypeChar) {
+        memcpy(data + ofs, field->GetData(), field->GetLength());
+        ofs += field->GetLength() + 1;
+        continue;
+      }
+      // int and float serialize as their native 4 bytes
+      char value[sizeof(uint32_t)];
+      field->SerializeTo(value);
+      uint32_t bits = MACH_READ_UINT32(value);
+      if (type_id == kTypeInt) {
+        bits ^= 0x80000000u;
+      } else {
+        if (MACH_READ_FROM(float_t, value) == 0) {
+          // -0.0 equals 0.0
+          bits = 0;
+        }
+        bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+      }
+      for (int j = 3; j >= 0; j--) {
+        data[ofs++] = static_cast<char>(bits >> (j * 8));
+      }
+    }
+    return ofs;
   }
 
   inline void DeserializeToKey(Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(data), schema);
+    std::vector<Field> fields;
+    fields.reserve(schema->GetColumnCount());
+    uint32_t ofs = 0;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      TypeId type_id = schema->GetColumn(i)->GetType();
+      if (data[ofs++] == 0) {
+        fields.emplace_back(type_id);
+        continue;
+      }
+      if (type_id == kTypeChar) {
+        uint32_t len = strnlen(data + ofs, KeySize - ofs);
+        fields.emplace_back(type_id, const_cast<char *>(data + ofs), len, true);
+        ofs += len + 1;
+        continue;
+      }
+      uint32_t bits = 0;
+      for (int j = 0; j < 4; j++) {
+        bits = (bits << 8) | static_cast<uint8_t>(data[ofs++]);
+      }
+      if (type_id == kTypeInt) {
+        fields.emplace_back(type_id, static_cast<int32_t>(bits ^ 0x80000000u));
+      } else {
+        bits = (bits & 0x80000000u) ? bits & ~0x80000000u : ~bits;
+        float_t value;
+        memcpy(&value, &bits, sizeof(value));
+        fields.emplace_back(type_id, value);
+      }
+    }
     ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
-    return;
+    // go through the row format, key may already own a heap
+    Row row(fields);
+    std::vector<char> buf(row.GetSerializedSize(schema));
+    row.SerializeTo(buf.data(), schema);
+    key.DeserializeFrom(buf.data(), schema);
+    key.SetRowId(INVALID_ROWID);
+  }
+
+  /**
+   * @brief 在编码后的列之后以大端序写入 RowId，使重复的列值按 RowId 排序且各不相同
+   *
+   * @param ofs SerializeFromKey 返回的编码长度
+   * @param rid RowId::Get() 的值，0 和 UINT64_MAX 分别小于、大于同一列值下所有的 RowId
+   */
+  inline void SetRowIdSuffix(uint32_t ofs, uint64_t rid) {
+    ASSERT(ofs + sizeof(uint64_t) <= KeySize, "Index key size exceed max key size.");
+    for (int j = 7; j >= 0; j--) {
+      data[ofs++] = static_cast<char>(rid >> (j * 8));
+    }
+  }
+
+  /**
+   * @brief 设为第一列不为 NULL 的最小的键
+   */
+  inline void SetMinNotNull() {
+    memset(data, 0, KeySize);
+    data[0] = 1;
   }
 
   // compare
@@ -54,24 +153,8 @@ class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    // keys are encoded order preserving, see GenericKey
+    return memcmp(lhs.data, rhs.data, KeySize);
   }
 
   GenericComparator(const GenericComparator &other) {
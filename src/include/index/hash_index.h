@@ -0,0 +1,40 @@
+#ifndef MINISQL_HASH_INDEX_H
+#define MINISQL_HASH_INDEX_H
+
+#include "index/extendible_hash_table.h"
+#include "index/index.h"
+
+#define HASH_INDEX_TYPE HashIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Index on an extendible hash table, only answers equality lookups on unique keys
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class HashIndex : public Index {
+public:
+  HashIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
+
+  /**
+   * @brief hash 索引不保存键的顺序，不支持范围查询，总是返回 DB_FAILED
+   */
+  dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive, std::vector<RowId> &result,
+                    Transaction *txn) override;
+
+  dberr_t Destroy() override;
+
+  bool Check() { return container_.Check(); }
+
+protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  EXTENDIBLE_HASH_TABLE_TYPE container_;
+};
+
+#endif  // MINISQL_HASH_INDEX_H
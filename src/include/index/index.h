@@ -7,6 +7,13 @@
 #include "record/row.h"
 #include "transaction/transaction.h"
 
+class TableHeap;
+
+/**
+ * Index structures, selected by CREATE INDEX ... USING
+ */
+enum class IndexType { kBPlusTree, kHash };
+
 class Index {
 public:
   explicit Index(index_id_t index_id, IndexSchema *key_schema)
@@ -20,6 +27,26 @@ public:
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) = 0;
 
+  /**
+   * @brief 范围查询，按键的顺序返回键在 lo 与 hi 之间的所有 RowId，NULL 不属于任何范围
+   *
+   * @param lo 下界，nullptr 表示没有下界
+   * @param hi 上界，nullptr 表示没有上界
+   */
+  virtual dberr_t ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                            std::vector<RowId> &result, Transaction *txn) = 0;
+
+  /**
+   * @brief 为表中已有的行建立空索引，默认逐行插入
+   *
+   * @param key_map 每个键列在表中的列号
+   * @param fill_factor 支持批量导入的索引每页的填充比例
+   * @param num_threads 支持并行建立的索引扫描表所用的线程数
+   * @return 唯一索引中有重复的键时返回 DB_KEY_ALREADY_EXIST，已经插入的部分需要调用者 Destroy
+   */
+  virtual dberr_t BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, double fill_factor,
+                           size_t num_threads, Transaction *txn);
+
   virtual dberr_t Destroy() = 0;
 
 protected:
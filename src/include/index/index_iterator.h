@@ -12,7 +12,21 @@ public:
   // you may define your own constructor based on your member variables
   IndexIterator() = delete;
 
-  IndexIterator(LeafPage* leaf, int index, BufferPoolManager* bpm);
+  /**
+   * @param page leaf page pinned and read latched by the caller, released by the iterator
+   */
+  IndexIterator(Page* page, int index, BufferPoolManager* bpm);
+
+  /**
+   * The iterator owns the pin and the read latch of its leaf, so it can be moved but not copied
+   */
+  IndexIterator(const IndexIterator &other) = delete;
+
+  IndexIterator &operator=(const IndexIterator &other) = delete;
+
+  IndexIterator(IndexIterator &&other) noexcept;
+
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
 
   ~IndexIterator();
 
@@ -29,9 +43,19 @@ public:
   bool operator!=(const IndexIterator &itr) const;
 
 private:
+  /** Latch the next leaf, then release the current one. */
+  void MoveToNextLeaf();
+
+  /** Unlatch, then unpin the current leaf if there is one. */
+  void Release();
+
+private:
+  Page* page_;
   LeafPage* leaf_;
   int index_;
   BufferPoolManager* bpm_;
+  // leaves may store the keys compressed, the item is decoded here
+  MappingType item_;
 };
 
 
@@ -0,0 +1,145 @@
+#ifndef MINISQL_B_PLUS_TREE_KEY_SEARCH_H
+#define MINISQL_B_PLUS_TREE_KEY_SEARCH_H
+
+/**
+ * b_plus_tree_key_search.h
+ *
+ * Search for a key among the sorted key & value pairs of a B+ tree page. KeySearch<KeyType, KeyComparator> is
+ * picked at compile time by the page templates:
+ *  - BinaryKeySearch: binary search through the comparator, for any key
+ *  - FixedKeySearch: for FixedKey<int32_t> and FixedKey<float_t>, binary search narrows the range down to a block
+ *    of SEARCH_BLOCK_SIZE keys, and the block is counted without branches, by AVX2 compare + movemask over 8 keys
+ *    at a time when the build targets AVX2, by a scalar loop otherwise
+ */
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "index/fixed_key.h"
+
+#define SEARCH_BLOCK_SIZE 32
+
+template<typename KeyType, typename KeyComparator>
+class BinaryKeySearch {
+public:
+  /**
+   * @return [begin, end) 中第一个键不小于 key 的位置，都小于时返回 end
+   */
+  template<typename Entry>
+  static int LowerBound(const Entry *array, int begin, int end, const KeyType &key, const KeyComparator &comparator) {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(array[mid].first, key) < 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+
+  /**
+   * @return [begin, end) 中第一个键大于 key 的位置，都不大于时返回 end
+   */
+  template<typename Entry>
+  static int UpperBound(const Entry *array, int begin, int end, const KeyType &key, const KeyComparator &comparator) {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(array[mid].first, key) <= 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+};
+
+template<typename T>
+class FixedKeySearch {
+  static_assert(std::is_same<T, int32_t>::value || std::is_same<T, float_t>::value, "int32_t or float_t keys only");
+
+public:
+  template<typename Entry>
+  static int LowerBound(const Entry *array, int begin, int end, const FixedKey<T> &key,
+                        const FixedComparator<T> &comparator) {
+    while (end - begin > SEARCH_BLOCK_SIZE) {
+      int mid = begin + (end - begin) / 2;
+      if (array[mid].first.value < key.value) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin + CountBelow<false>(array + begin, end - begin, key.value);
+  }
+
+  template<typename Entry>
+  static int UpperBound(const Entry *array, int begin, int end, const FixedKey<T> &key,
+                        const FixedComparator<T> &comparator) {
+    while (end - begin > SEARCH_BLOCK_SIZE) {
+      int mid = begin + (end - begin) / 2;
+      if (array[mid].first.value <= key.value) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin + CountBelow<true>(array + begin, end - begin, key.value);
+  }
+
+  /**
+   * @brief 有序的 n 个键中小于 value（inclusive 时不大于 value）的个数
+   */
+  template<bool inclusive, typename Entry>
+  static int CountBelow(const Entry *array, int n, T value) {
+    static_assert(sizeof(Entry) % sizeof(T) == 0, "keys must be T aligned");
+    int count = 0;
+    int i = 0;
+#ifdef __AVX2__
+    // keys are sizeof(Entry) apart, gather 8 of them at a time, lanes past n are masked off and not read
+    const auto *base = reinterpret_cast<const T *>(array);
+    constexpr int stride = sizeof(Entry) / sizeof(T);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i offsets = _mm256_mullo_epi32(lane, _mm256_set1_epi32(stride));
+    for (; i < n; i += 8) {
+      __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - i), lane);
+      int bits;
+      if constexpr (std::is_same<T, int32_t>::value) {
+        __m256i keys = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base + i * stride, offsets, mask, 4);
+        __m256i value_vec = _mm256_set1_epi32(value);
+        // key < value, or key <= value as not key > value
+        __m256i below = inclusive ? _mm256_andnot_si256(_mm256_cmpgt_epi32(keys, value_vec), mask)
+                                  : _mm256_and_si256(_mm256_cmpgt_epi32(value_vec, keys), mask);
+        bits = _mm256_movemask_ps(_mm256_castsi256_ps(below));
+      } else {
+        __m256 keys = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base + i * stride, offsets,
+                                               _mm256_castsi256_ps(mask), 4);
+        __m256 below = _mm256_cmp_ps(keys, _mm256_set1_ps(value), inclusive ? _CMP_LE_OQ : _CMP_LT_OQ);
+        bits = _mm256_movemask_ps(_mm256_and_ps(below, _mm256_castsi256_ps(mask)));
+      }
+      count += __builtin_popcount(bits);
+    }
+#else
+    for (; i < n; i++) {
+      count += inclusive ? array[i].first.value <= value : array[i].first.value < value;
+    }
+#endif
+    return count;
+  }
+};
+
+template<typename KeyType, typename KeyComparator>
+class KeySearch : public BinaryKeySearch<KeyType, KeyComparator> {};
+
+template<>
+class KeySearch<FixedKey<int32_t>, FixedComparator<int32_t>> : public FixedKeySearch<int32_t> {};
+
+template<>
+class KeySearch<FixedKey<float_t>, FixedComparator<float_t>> : public FixedKeySearch<float_t> {};
+
+#endif  // MINISQL_B_PLUS_TREE_KEY_SEARCH_H
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "index/generic_key.h"
 #include "page/b_plus_tree_page.h"
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
@@ -64,9 +65,18 @@ public:
 
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
-private:
+  // append sorted items, also used to fill pages by bulk loading
   void CopyNFrom(MappingType *items, int size);
 
+  /**
+   * @brief 本页的条目全部移到左兄弟 recipient 后是否放得下
+   */
+  bool CanMergeInto(const BPlusTreeLeafPage *recipient) const;
+
+  // entries are fixed size, bulk loading plans the pages by entry counts
+  static constexpr bool kVariableLength = false;
+
+private:
   void CopyLastFrom(const MappingType &item);
 
   void CopyFirstFrom(const MappingType &item);
@@ -75,4 +85,140 @@ private:
   MappingType array_[0];
 };
 
+#define PREFIX_LEAF_TEMPLATE_ARGUMENTS template <size_t KeySize>
+#define B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE BPlusTreeLeafPage<GenericKey<KeySize>, RowId, GenericComparator<KeySize>>
+
+/**
+ * Leaf page of GenericKey indexes, with the keys prefix compressed.
+ *
+ * Keys reaching a leaf lie between its fence keys, the separators around it in the parent, so all of them share
+ * the common prefix of the two fences. The prefix is stored once, as the head of the low fence, and every entry
+ * keeps only the rest of its key with the trailing zero padding dropped. GenericKey is encoded order preserving,
+ * so a key compares with an entry by memcmp of the suffixes. The leftmost leaf has no low fence and the rightmost
+ * no high fence, their prefix is empty.
+ *
+ * Entries are variable length. They are packed from the end of the page towards the front, and a slot directory
+ * of their offsets is kept in key order after the header:
+ *  ---------------------------------------------------------------------------------------------------
+ * | HEADER | LowFence | HighFence | SLOT(0) | SLOT(1) | ... free space ... | ENTRY(1) | ENTRY(0) |
+ *  ---------------------------------------------------------------------------------------------------
+ *  Header format (size in byte, 34 bytes in total):
+ *  ---------------------------------------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) | PageId (4) | NextPageId (4) |
+ *  ---------------------------------------------------------------------------------------------------
+ * | PrefixSize (2) | EntryBegin (2) | LowInfinite (1) | HighInfinite (1) |
+ *  ---------------------------------------------------------------------------------------------------
+ *  Entry format: | SuffixSize (1) | Suffix (SuffixSize) | RID (8) |
+ *
+ * MaxSize is kept at the current size plus the number of the longest possible entries that still fit, so the
+ * tree splits a page before an insert may overflow it and takes a page below half of that as underflowed, the
+ * same as for fixed size entries. Merging two pages may shorten the prefix, it only happens if the entries fit.
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage<GenericKey<KeySize>, RowId, GenericComparator<KeySize>> : public BPlusTreePage {
+  using KeyType = GenericKey<KeySize>;
+  using ValueType = RowId;
+  using KeyComparator = GenericComparator<KeySize>;
+
+public:
+  // max_size is ignored, it follows the free space of the page
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = 0);
+
+  page_id_t GetNextPageId() const;
+
+  void SetNextPageId(page_id_t next_page_id);
+
+  /**
+   * @brief 设置空页的两个栅栏键，nullptr 表示无穷小或无穷大
+   */
+  void SetFences(const KeyType *low_fence, const KeyType *high_fence);
+
+  int GetPrefixSize() const { return prefix_size_; }
+
+  KeyType KeyAt(int index) const;
+
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  MappingType GetItem(int index) const;
+
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  bool Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const;
+
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+
+  // split by bytes, the recipient is the new right sibling
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+  // the recipient is the left sibling
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  // append sorted items within the fences, also used to fill pages by bulk loading
+  void CopyNFrom(MappingType *items, int size);
+
+  bool CanMergeInto(const BPlusTreeLeafPage *recipient) const;
+
+  /**
+   * @brief 批量建树时决定下一个叶子页放入多少条目：叶子以 low_fence 为下界（nullptr 表示无穷小），
+   * 以下一个条目（没有时为无穷大）为上界，按 fill_factor 尽量多放
+   *
+   * @param items 按键严格递增的候选条目，多于 kMaxEntries 个时结果一定小于 size
+   * @return 放入的条目数，至少为 1
+   */
+  static int PlanFill(const KeyType *low_fence, const MappingType *items, int size, double fill_factor);
+
+  // entries are variable length, bulk loading fills the pages by bytes
+  static constexpr bool kVariableLength = true;
+
+  static constexpr size_t kSlotsOffset = LEAF_PAGE_HEADER_SIZE + 6 + 2 * KeySize;
+
+  // slot, suffix size, suffix and rid of the longest entry
+  static constexpr size_t kMaxEntrySize = sizeof(uint16_t) + 1 + KeySize + sizeof(ValueType);
+
+  static constexpr int kMaxEntries = (PAGE_SIZE - kSlotsOffset) / (sizeof(uint16_t) + 1 + sizeof(ValueType));
+
+private:
+  /**
+   * @return 两个栅栏键的公共前缀长度，任一侧无穷时为 0
+   */
+  static int CommonPrefix(const KeyType *low_fence, const KeyType *high_fence);
+
+  // length without the trailing zero padding
+  static int KeyLength(const KeyType &key);
+
+  // bytes taken by the entry of key, slot included
+  static size_t EntrySize(const KeyType &key, int prefix_size);
+
+  const char *EntryAt(int index) const { return reinterpret_cast<const char *>(this) + slots_[index]; }
+
+  size_t FreeSpace() const;
+
+  /**
+   * @brief 比较第 index 个条目与 key，key 须以本页前缀开头，key_length 为 KeyLength(key)
+   */
+  int CompareAt(int index, const KeyType &key, int key_length) const;
+
+  void Decode(std::vector<MappingType> &items) const;
+
+  void Append(const MappingType &item);
+
+  // re-encode the page with the items after its fences changed
+  void Rebuild(const MappingType *items, int size);
+
+  void UpdateMaxSize();
+
+  page_id_t next_page_id_;
+  uint16_t prefix_size_;
+  uint16_t entry_begin_;
+  uint8_t low_infinite_;
+  uint8_t high_infinite_;
+  KeyType low_fence_;
+  KeyType high_fence_;
+  uint16_t slots_[0];
+};
+
 #endif  // MINISQL_B_PLUS_TREE_LEAF_PAGE_H
@@ -41,8 +41,16 @@ private:
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * Search free pages a 64 bit word at a time. The caller makes sure a free page exists at or after start.
+   *
+   * @return the first free page at or after start
+   */
+  uint32_t FindFreePage(uint32_t start) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "Bitmap must be a whole number of 64 bit words.");
 
 private:
   /** The space occupied by all members of the class should be equal to the PageSize */
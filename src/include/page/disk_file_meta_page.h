@@ -2,11 +2,16 @@
 #define MINISQL_DISK_FILE_META_PAGE_H
 
 #include <cstdint>
+#include <limits>
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+static constexpr page_id_t MAX_VALID_PAGE_ID = std::numeric_limits<page_id_t>::max();
 
+/**
+ * Meta page of an extent group. The meta page at physical page 0 records the totals of the whole file in its
+ * header, every other group meta page records the totals of its own group.
+ */
 class DiskFileMetaPage {
 public:
   uint32_t GetExtentNums() {
@@ -17,13 +22,19 @@ public:
     return num_allocated_pages_;
   }
 
+  /**
+   * @param extent_id index of the extent within the group of this meta page
+   */
   uint32_t GetExtentUsedPage(uint32_t extent_id) {
-    if (extent_id >= num_extents_) {
+    if (extent_id >= num_extents_ || extent_id >= EXTENTS_PER_META_PAGE) {
       return 0;
     }
     return extent_used_page_[extent_id];
   }
 
+  /** number of extents a meta page records, i.e. the number of extents in a group */
+  static constexpr uint32_t EXTENTS_PER_META_PAGE = (PAGE_SIZE - 2 * sizeof(uint32_t)) / sizeof(uint32_t);
+
 public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};   // each extent consists with a bit map and BIT_MAP_SIZE pages
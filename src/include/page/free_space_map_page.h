@@ -0,0 +1,63 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * Each table heap keeps a chain of free space map pages, recording the (approximate)
+ * number of free bytes of every heap page in heap chain order.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | HeapPage_1 id (4) | HeapPage_1 free bytes (4) | ... |
+ *  ---------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+public:
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  /**
+   * @return false if the page is full
+   */
+  bool Append(page_id_t heap_page_id, uint32_t free_bytes) {
+    if (count_ >= MAX_ENTRY_COUNT) {
+      return false;
+    }
+    entries_[count_].heap_page_id_ = heap_page_id;
+    entries_[count_].free_bytes_ = free_bytes;
+    count_++;
+    return true;
+  }
+
+  void SetFreeBytes(uint32_t index, uint32_t free_bytes) { entries_[index].free_bytes_ = free_bytes; }
+
+  page_id_t GetHeapPageId(uint32_t index) const { return entries_[index].heap_page_id_; }
+
+  uint32_t GetFreeBytes(uint32_t index) const { return entries_[index].free_bytes_; }
+
+  uint32_t GetEntryCount() const { return count_; }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+public:
+  static constexpr uint32_t MAX_ENTRY_COUNT = (PAGE_SIZE - 8) / 8;
+
+private:
+  struct Entry {
+    page_id_t heap_page_id_;
+    uint32_t free_bytes_;
+  };
+
+  page_id_t next_page_id_;
+  uint32_t count_;
+  Entry entries_[0];
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
@@ -0,0 +1,65 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+/**
+ * hash_table_bucket_page.h
+ *
+ * Leaf level of the extendible hash table. Stores unique keys and their values unordered, removal moves the last
+ * entry into the hole so the entries stay packed.
+ *
+ * Bucket page format (size in byte):
+ *  -------------------------------------------------------------------------
+ * | CurrentSize (4) | MaxSize (4) | KEY(0) + VALUE(0) | KEY(1) + VALUE(1) | ...
+ *  -------------------------------------------------------------------------
+ */
+#include <utility>
+
+#include "common/config.h"
+
+#define MappingType std::pair<KeyType, ValueType>
+
+#define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
+
+#define HASH_TABLE_BUCKET_PAGE_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
+#define HASH_BUCKET_PAGE_HEADER_SIZE 8
+#define HASH_BUCKET_PAGE_SIZE ((PAGE_SIZE - HASH_BUCKET_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+INDEX_TEMPLATE_ARGUMENTS
+class HashTableBucketPage {
+public:
+  // must call initialize method after "create" a new bucket page
+  void Init(uint32_t max_size = HASH_BUCKET_PAGE_SIZE);
+
+  bool Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const;
+
+  /**
+   * @return false if the bucket is full or already holds the key
+   */
+  bool Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /**
+   * @return false if the key does not exist
+   */
+  bool Remove(const KeyType &key, const KeyComparator &comparator);
+
+  void RemoveAt(uint32_t bucket_idx);
+
+  const KeyType &KeyAt(uint32_t bucket_idx) const;
+
+  const MappingType &EntryAt(uint32_t bucket_idx) const;
+
+  uint32_t Size() const { return size_; }
+
+  bool IsFull() const { return size_ == max_size_; }
+
+  bool IsEmpty() const { return size_ == 0; }
+
+private:
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  uint32_t size_;
+  uint32_t max_size_;
+  MappingType array_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
@@ -0,0 +1,72 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+/**
+ * hash_table_directory_page.h
+ *
+ * Second level of the extendible hash table. The low global_depth bits of a hash select a slot, and every slot
+ * points to a bucket page. A bucket with local depth d is shared by the 2^(global_depth - d) slots that agree on
+ * the low d bits.
+ *
+ * Directory page format (size in byte):
+ *  ------------------------------------------------------------------------------------------
+ * | MaxDepth (4) | GlobalDepth (4) | LocalDepth(0..511) (1 each) | BucketPageId(0..511) (4 each) |
+ *  ------------------------------------------------------------------------------------------
+ */
+#include <cstdint>
+
+#include "common/config.h"
+
+#define HASH_DIRECTORY_MAX_DEPTH 9
+#define HASH_DIRECTORY_ARRAY_SIZE (1 << HASH_DIRECTORY_MAX_DEPTH)
+
+class HashTableDirectoryPage {
+public:
+  // must call initialize method after "create" a new directory page
+  void Init(uint32_t max_depth = HASH_DIRECTORY_MAX_DEPTH);
+
+  uint32_t HashToBucketIndex(uint32_t hash) const { return hash & GetGlobalDepthMask(); }
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /**
+   * @brief 与该槽位的桶分裂自同一个桶的槽位，即局部深度最高位相反的槽位
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+  uint32_t GetGlobalDepthMask() const { return (1u << global_depth_) - 1; }
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  uint32_t GetMaxDepth() const { return max_depth_; }
+
+  /**
+   * @brief 全局深度加一，新的一半槽位复制原有的一半
+   */
+  void IncrGlobalDepth();
+
+  void DecrGlobalDepth();
+
+  /**
+   * @brief 所有桶的局部深度都小于全局深度时，目录可以减半
+   */
+  bool CanShrink() const;
+
+  uint32_t Size() const { return 1u << global_depth_; }
+
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth);
+
+private:
+  uint32_t max_depth_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[HASH_DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[HASH_DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "hash table directory page exceeds a page");
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
@@ -0,0 +1,42 @@
+#ifndef MINISQL_HASH_TABLE_HEADER_PAGE_H
+#define MINISQL_HASH_TABLE_HEADER_PAGE_H
+
+/**
+ * hash_table_header_page.h
+ *
+ * First level of the extendible hash table, the page recorded as its root in the index roots page.
+ * The top max_depth bits of a hash select one of the directory pages, which are created on demand.
+ *
+ * Header page format (size in byte):
+ *  ---------------------------------------------------------------------
+ * | DirectoryPageId(0) (4) | ... | DirectoryPageId(511) (4) | MaxDepth (4) |
+ *  ---------------------------------------------------------------------
+ */
+#include <cstdint>
+
+#include "common/config.h"
+
+#define HASH_HEADER_MAX_DEPTH 9
+#define HASH_HEADER_ARRAY_SIZE (1 << HASH_HEADER_MAX_DEPTH)
+
+class HashTableHeaderPage {
+public:
+  // must call initialize method after "create" a new header page
+  void Init(uint32_t max_depth = HASH_HEADER_MAX_DEPTH);
+
+  uint32_t HashToDirectoryIndex(uint32_t hash) const;
+
+  page_id_t GetDirectoryPageId(uint32_t directory_idx) const;
+
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+  uint32_t MaxSize() const { return 1u << max_depth_; }
+
+private:
+  page_id_t directory_page_ids_[HASH_HEADER_ARRAY_SIZE];
+  uint32_t max_depth_;
+};
+
+static_assert(sizeof(HashTableHeaderPage) <= PAGE_SIZE, "hash table header page exceeds a page");
+
+#endif  // MINISQL_HASH_TABLE_HEADER_PAGE_H
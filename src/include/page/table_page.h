@@ -15,6 +15,8 @@
  *  ----------------------------------------------------------------
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
+ *  The top bit of a tuple size is the delete flag and the next two bits are the RowFormat of the tuple,
+ *  pages written before the compact format existed have 0 there, which reads as RowFormat::kLegacy.
  **/
 
 #include <cstring>
@@ -61,10 +63,19 @@ public:
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * @brief 不拷贝，直接返回 rid 对应的 tuple 在页内的数据及其格式，tuple 不存在或已删除时返回 nullptr
+   */
+  const char *GetTupleData(const RowId &rid, uint32_t *size, RowFormat *format);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
 private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -76,10 +87,6 @@ private:
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -88,11 +95,30 @@ private:
     memcpy(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num, &offset, sizeof(uint32_t));
   }
 
+  /**
+   * @brief tuple 的大小和 delete flag，不含格式位
+   */
   uint32_t GetTupleSize(uint32_t slot_num) {
-    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num) & ~FORMAT_MASK;
   }
 
+  /**
+   * @brief 保留格式位
+   */
   void SetTupleSize(uint32_t slot_num, uint32_t size) {
+    uint32_t format_bits = *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num) &
+                           FORMAT_MASK;
+    size |= format_bits;
+    memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
+  }
+
+  RowFormat GetTupleFormat(uint32_t slot_num) {
+    uint32_t size = *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num);
+    return static_cast<RowFormat>((size & FORMAT_MASK) >> FORMAT_SHIFT);
+  }
+
+  void SetTupleFormat(uint32_t slot_num, RowFormat format) {
+    uint32_t size = GetTupleSize(slot_num) | (static_cast<uint32_t>(format) << FORMAT_SHIFT);
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
@@ -105,8 +131,9 @@ private:
 private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
+  static constexpr uint32_t FORMAT_SHIFT = 8 * sizeof(uint32_t) - 3;
+  static constexpr uint32_t FORMAT_MASK = 3U << FORMAT_SHIFT;
   static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
@@ -115,6 +142,7 @@ private:
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
 
 public:
+  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
@@ -17,6 +17,10 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class ColumnVector;
+
+  friend class Predicate;
+
 public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
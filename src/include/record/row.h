@@ -10,16 +10,28 @@
 #include "utils/mem_heap.h"
 
 /**
- *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *  
+ * On-page formats of a row, TablePage keeps the format of each tuple in its slot so both can share a page
+ */
+enum class RowFormat {
+  kLegacy = 0,
+  kCompact = 1
+};
+
+/**
+ *  Compact row format, written by SerializeTo:
+ * --------------------------------------------------------------------------------------------
+ * | Null bitmap | Fixed values | Char end offsets (2 each) | Char data |
+ * --------------------------------------------------------------------------------------------
+ *  The null bitmap has one bit per column. int and float values take 4 bytes each, in column order, at offsets
+ *  the Schema derives once from the column types, so they are read in O(1); a null value keeps its zeroed slot.
+ *  The bytes of the k-th char column end at its end offset and start at the end offset of the (k-1)-th char
+ *  column, or at Schema::GetFixedSize() for the first one; a null char column is empty.
  *
+ *  Legacy row format, read only:
+ * --------------------------------------------------------------------------------------------
+ * | RowId (8) | Field Nums (4) | Null flags (1 each) | Type tag (1) | Field-1 | ... | Type tag (1) | Field-N |
+ * --------------------------------------------------------------------------------------------
+ *  Fields are serialized by their Type and null fields are left out, so reading a field decodes all before it.
  */
 class Row {
 public:
@@ -71,7 +83,10 @@ public:
    */
   uint32_t SerializeTo(char *buf, Schema *schema) const;
 
-  uint32_t DeserializeFrom(char *buf, Schema *schema);
+  /**
+   * @brief 按 format 读出一行，RowId 不从 buf 中读取
+   */
+  uint32_t DeserializeFrom(char *buf, Schema *schema, RowFormat format = RowFormat::kCompact);
 
   /**
    * For empty row, return 0
@@ -96,6 +111,8 @@ public:
 private:
   Row &operator=(const Row &other) = delete;
 
+  uint32_t DeserializeLegacyFrom(char *buf);
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
@@ -0,0 +1,68 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <string_view>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a serialized row, usually the tuple bytes inside a pinned and latched table page.
+ *
+ * Fields are decoded one at a time by column index straight from the bytes, nothing is copied or allocated.
+ * A field of a compact row is found in O(1) from the layout of the Schema; a legacy row has to skip the fields
+ * before it.
+ * A view is only valid while the bytes it points at are: for a tuple in a page, inside the ScanPageViews or
+ * GetTupleView callback that handed it out. Materialize a Row when the row has to outlive that.
+ */
+class RowView {
+public:
+  RowView(const char *data, uint32_t size, RowFormat format, Schema *schema, RowId rid)
+          : data_(data), size_(size), format_(format), schema_(schema), rid_(rid) {}
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const {
+    return format_ == RowFormat::kCompact ? schema_->GetColumnCount() : MACH_READ_UINT32(data_ + sizeof(RowId));
+  }
+
+  inline bool IsNull(uint32_t idx) const {
+    if (format_ == RowFormat::kCompact) {
+      return (data_[idx / 8] >> (idx % 8)) & 1;
+    }
+    return MACH_READ_FROM(bool, data_ + OFFSET_NULLS + idx);
+  }
+
+  /**
+   * @brief 下面三个函数要求第 idx 个字段不为 null，且类型与 schema 中的一致
+   */
+  int32_t GetInt(uint32_t idx) const;
+
+  float GetFloat(uint32_t idx) const;
+
+  std::string_view GetChars(uint32_t idx) const;
+
+  /**
+   * @brief 拷贝出完整的一行，row 的 RowId 为视图的 RowId
+   */
+  void Materialize(Row *row) const;
+
+private:
+  /**
+   * @return 旧格式中第 idx 个字段的数据在 data_ 中的位置；需要跳过它之前的每个字段，代价与 idx 成正比
+   */
+  uint32_t GetLegacyFieldOffset(uint32_t idx) const;
+
+  /** null flags of the legacy format */
+  static constexpr uint32_t OFFSET_NULLS = sizeof(RowId) + sizeof(uint32_t);
+
+  const char *data_;
+  uint32_t size_;
+  RowFormat format_;
+  Schema *schema_;
+  RowId rid_;
+};
+
+#endif  // MINISQL_ROW_VIEW_H
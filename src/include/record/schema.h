@@ -10,7 +10,7 @@
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) { InitRowLayout(); }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +28,26 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Layout of the rows of this schema in the compact row format (see Row), derived once from the column types
+   */
+  inline uint32_t GetNullBitmapSize() const { return null_bitmap_size_; }
+
+  /**
+   * @brief int 和 float 列为值在行中的偏移；char 列为它的结束偏移在偏移数组中的位置
+   */
+  inline uint32_t GetFieldOffset(uint32_t column_index) const { return field_offsets_[column_index]; }
+
+  /**
+   * @brief 偏移数组的起始位置，即第一个 char 列的结束偏移所在的位置
+   */
+  inline uint32_t GetCharOffsetsBegin() const { return char_offsets_begin_; }
+
+  /**
+   * @brief 变长数据之前的部分的长度，即 null bitmap、定长列和偏移数组的总长度
+   */
+  inline uint32_t GetFixedSize() const { return fixed_size_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -73,8 +93,14 @@ public:
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
 private:
+  void InitRowLayout();
+
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  uint32_t null_bitmap_size_{0};
+  std::vector<uint32_t> field_offsets_;
+  uint32_t char_offsets_begin_{0};
+  uint32_t fixed_size_{0};
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,37 @@
+#ifndef MINISQL_ASYNC_DISK_IO_H
+#define MINISQL_ASYNC_DISK_IO_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Asynchronous positioned reads and writes on a file descriptor.
+ *
+ * Requests may complete out of order. Callbacks run on an internal completion thread with the number of
+ * bytes transferred or -errno, so they must be short and must not submit and wait on further requests.
+ * Destroying the object waits for all requests in flight.
+ */
+class AsyncDiskIO {
+public:
+  using Callback = std::function<void(ssize_t)>;
+
+  virtual ~AsyncDiskIO() = default;
+
+  virtual void Read(int fd, size_t offset, char *buf, size_t len, Callback callback) = 0;
+
+  virtual void Write(int fd, size_t offset, const char *buf, size_t len, Callback callback) = 0;
+
+  /**
+   * @return name of the engine, for logging
+   */
+  virtual const char *GetName() const = 0;
+
+  /**
+   * @return an io_uring engine if the kernel supports it and allow_io_uring is set, a thread pool otherwise
+   */
+  static AsyncDiskIO *Create(size_t queue_depth, size_t num_threads, bool allow_io_uring = true);
+};
+
+#endif  // MINISQL_ASYNC_DISK_IO_H
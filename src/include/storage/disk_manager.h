@@ -3,15 +3,26 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <mutex>
+#include <memory>
 #include <string>
+#include <vector>
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/async_disk_io.h"
+
+/**
+ * File backends a DiskManager can be constructed with.
+ * kPosix uses pread/pwrite on a raw fd, so page reads and writes need no latch and share no seek cursor;
+ * kFStream is the original std::fstream backend, kept for comparison.
+ */
+enum class DiskBackend { kFStream, kPosix };
 
-#define MAX_EXTENT 8
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -19,14 +30,20 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * A meta page records at most M = DiskFileMetaPage::EXTENTS_PER_META_PAGE extents, so extents are grouped by M
+ * and every group after the first starts with its own meta page:
+ * | Meta Page (group 0) | Extent 0 | ... | Extent M-1 | Meta Page (group 1) | Extent M | ... | Extent 2M-1 | ...
+ * The number of extents is only bounded by page_id_t. All meta pages are kept in memory and written back on
+ * Sync and Close, together with a stack of the extents that still have free pages.
+ * Extent bitmaps are cached in memory on first use as well, so allocation does no I/O; dirty bitmaps are written
+ * back on Sync and Close.
  */
 class DiskManager {
 public:
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DiskBackend backend = DiskBackend::kPosix);
 
-~DiskManager() {
-    auto meta = reinterpret_cast<char *>(meta_data_);
-    WritePhysicalPage(0, meta);
+  ~DiskManager() {
     if (!closed) {
       Close();
     }
@@ -44,6 +61,28 @@ public:
    */
   void WritePage(page_id_t logical_page_id, const char *page_data);
 
+  /**
+   * Read page asynchronously, callback runs once page_data is filled.
+   * Requests go through io_uring when the kernel supports it and a small thread pool otherwise;
+   * the fstream backend completes them synchronously.
+   * Note: callback runs on an I/O completion thread and must not wait for other asynchronous requests
+   */
+  void ReadPageAsync(page_id_t logical_page_id, char *page_data, std::function<void()> callback);
+
+  std::future<void> ReadPageAsync(page_id_t logical_page_id, char *page_data);
+
+  /**
+   * Write page asynchronously, page_data must stay valid until callback runs
+   */
+  void WritePageAsync(page_id_t logical_page_id, const char *page_data, std::function<void()> callback);
+
+  std::future<void> WritePageAsync(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * @return name of the asynchronous I/O engine in use
+   */
+  const char *GetAsyncIOName();
+
   /**
    * Get next free page from disk
    * @return logical page id of allocated page
@@ -61,7 +100,13 @@ public:
   bool IsPageFree(page_id_t logical_page_id);
 
   /**
-   * Shut down the disk manager and close all the file resources.
+   * Make all pages written so far durable.
+   * Writes are not synced one by one; callers sync at checkpoints such as FlushAllPages and Close.
+   */
+  void Sync();
+
+  /**
+   * Write back the meta page, sync and close all the file resources.
    */
   void Close();
 
@@ -77,7 +122,7 @@ private:
   /**
    * Helper function to get disk file size
    */
-  int GetFileSize(const std::string &file_name);
+  int64_t GetFileSize(const std::string &file_name);
 
   /**
    * Read physical page from disk
@@ -89,19 +134,73 @@ private:
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  void ReadPhysicalPagePosix(size_t offset, char *page_data);
+
+  void WritePhysicalPagePosix(size_t offset, const char *page_data);
+
+  void ExtendFileSize(size_t end);
+
+  /**
+   * Create the asynchronous I/O engine on first use
+   */
+  AsyncDiskIO *GetAsyncIO();
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
+  /**
+   * @return physical page id of the bitmap page of an extent
+   */
+  static page_id_t MapBitmapPageId(uint32_t extent_id);
+
+  /**
+   * @return physical page id of the meta page of an extent group
+   */
+  static page_id_t MapMetaPageId(uint32_t group_id);
+
+  /**
+   * @return meta page of an extent group, group 0 is meta_data_
+   */
+  DiskFileMetaPage *GetMetaPage(uint32_t group_id);
+
+  uint32_t &ExtentUsedPage(uint32_t extent_id);
+
+  /**
+   * Read the meta pages of all groups and find the extents with free pages
+   */
+  void LoadMetaPages();
+
+  void WriteMetaPages();
+
+  /**
+   * @return cached bitmap of an extent, read from disk on first use
+   */
+  BitmapPage<PAGE_SIZE> *GetBitmapPage(uint32_t extent_id);
+
+  void WriteBitmapPages();
+
 private:
-  // stream to write db file
+  DiskBackend backend_;
+  // stream to write db file, used by kFStream
   std::fstream db_io_;
+  // raw file descriptor and cached file size, used by kPosix
+  int db_fd_{-1};
+  std::atomic<size_t> file_size_{0};
+  std::atomic<AsyncDiskIO *> async_io_{nullptr};
   std::string file_name_;
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
+  // meta pages of groups 1, 2, ...
+  std::vector<std::unique_ptr<char[]>> group_meta_data_;
+  // extents that are not full, allocation takes from the back
+  std::vector<uint32_t> free_extents_;
+  // cached extent bitmaps, nullptr until first used
+  std::vector<std::unique_ptr<char[]>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
 
 };
 
@@ -0,0 +1,99 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * Free space map of a table heap.
+ *
+ * The map is persisted in a chain of FreeSpaceMapPage and mirrored in memory, where a max segment
+ * tree over heap pages (in heap chain order) finds the first page with enough room in O(log n).
+ * Free bytes are only written back when they move across a PERSIST_GRANULARITY step, so the
+ * persisted values are approximate; callers must tolerate a page that turns out to be full.
+ * All public methods may be called by concurrent inserters and scanners, they are serialized by latch_.
+ */
+class FreeSpaceMap {
+public:
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  /**
+   * Allocate the first map page of a new, empty map
+   * @return false if no page could be allocated
+   */
+  bool Init();
+
+  /**
+   * Load an existing map into memory
+   */
+  void Load(page_id_t first_page_id);
+
+  /**
+   * Record a heap page newly linked at the tail of the heap chain
+   */
+  bool AddPage(page_id_t heap_page_id, uint32_t free_bytes);
+
+  /**
+   * Update the free bytes of a heap page after it changed
+   */
+  void UpdatePage(page_id_t heap_page_id, uint32_t free_bytes);
+
+  /**
+   * @return the first heap page in chain order with at least required free bytes, INVALID_PAGE_ID if none
+   */
+  page_id_t FindPage(uint32_t required) const;
+
+  /**
+   * @return the recorded free bytes of a heap page, 0 if the page is unknown
+   */
+  uint32_t GetFreeBytes(page_id_t heap_page_id) const;
+
+  /**
+   * @return position of a heap page in heap chain order, -1 if the page is unknown
+   */
+  int GetPageIndex(page_id_t heap_page_id) const;
+
+  page_id_t GetFirstPageId() const;
+
+  page_id_t GetLastHeapPageId() const;
+
+  /**
+   * @return number of heap pages, pages may be appended by inserters at any time
+   */
+  size_t GetHeapPageCount() const;
+
+  /**
+   * @return the heap page at position index in heap chain order, index must be less than GetHeapPageCount()
+   */
+  page_id_t GetHeapPage(size_t index) const;
+
+  /**
+   * @return a copy of all heap pages in heap chain order
+   */
+  std::vector<page_id_t> GetHeapPages() const;
+
+private:
+  void Append(page_id_t heap_page_id, uint32_t free_bytes);
+
+  void SetTreeValue(uint32_t index, uint32_t free_bytes);
+
+  void Persist(uint32_t index, uint32_t free_bytes);
+
+private:
+  static constexpr uint32_t PERSIST_GRANULARITY = 128;
+
+  BufferPoolManager *buffer_pool_manager_;
+  mutable std::mutex latch_;
+  std::vector<page_id_t> map_pages_;            /** map pages in chain order */
+  std::vector<page_id_t> heap_pages_;           /** heap pages in chain order */
+  std::vector<uint32_t> persisted_free_bytes_;  /** free bytes as last written to the map pages */
+  std::unordered_map<page_id_t, uint32_t> page_index_;
+  std::vector<uint32_t> max_tree_;              /** leaves live in [capacity_, 2 * capacity_) */
+  uint32_t capacity_{0};
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_H
@@ -0,0 +1,35 @@
+#ifndef MINISQL_READ_AHEAD_H
+#define MINISQL_READ_AHEAD_H
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/free_space_map.h"
+
+/**
+ * Adaptive read-ahead of one reader walking the heap pages of a table in heap chain order.
+ *
+ * Shared by TableIterator and the page at a time scans of the executors. As long as the pages are read one
+ * after another the window doubles, up to READ_AHEAD_MAX_PAGES and a quarter of the buffer pool; a jump
+ * resets it.
+ */
+class ReadAhead {
+public:
+  ReadAhead(BufferPoolManager *buffer_pool_manager, const FreeSpaceMap *free_space_map)
+          : buffer_pool_manager_(buffer_pool_manager), free_space_map_(free_space_map) {}
+
+  /**
+   * @brief 即将读取第 page_index 个堆页时调用：调整预读窗口，并请求缓冲池异步预读窗口内尚未预读的后续数据页
+   */
+  void Access(size_t page_index);
+
+private:
+  static constexpr size_t READ_AHEAD_INITIAL_PAGES = 4;
+  static constexpr size_t READ_AHEAD_MAX_PAGES = 64;
+
+  BufferPoolManager *buffer_pool_manager_;
+  const FreeSpaceMap *free_space_map_;
+  int last_page_index_{-1};                           // position of the last page read in the heap chain
+  size_t window_{READ_AHEAD_INITIAL_PAGES};
+  size_t prefetched_end_{0};                          // pages before this position were already read ahead
+};
+
+#endif  // MINISQL_READ_AHEAD_H
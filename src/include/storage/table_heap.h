@@ -1,8 +1,14 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+#include <mutex>
+
 #include "buffer/buffer_pool_manager.h"
 #include "page/table_page.h"
+#include "record/row_view.h"
+#include "storage/free_space_map.h"
+#include "storage/read_ahead.h"
 #include "storage/table_iterator.h"
 #include "transaction/log_manager.h"
 #include "transaction/lock_manager.h"
@@ -20,7 +26,15 @@ public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
                            LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, first_page_id, INVALID_PAGE_ID, schema, log_manager, lock_manager);
+  }
+
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                           page_id_t free_space_map_page_id, Schema *schema, LogManager *log_manager,
+                           LockManager *lock_manager, MemHeap *heap) {
+    void *buf = heap->Allocate(sizeof(TableHeap));
+    return new(buf) TableHeap(buffer_pool_manager, first_page_id, free_space_map_page_id, schema, log_manager,
+                              lock_manager);
   }
 
   ~TableHeap() {}
@@ -74,6 +88,27 @@ public:
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read every tuple of one heap page under its read latch, used to scan disjoint page ranges in parallel
+   * @param[in] callback called with each tuple, row id of the tuple is wrapped in row
+   * @return false if the page could not be fetched
+   */
+  bool ScanPage(page_id_t page_id, const std::function<void(Row &)> &callback, Transaction *txn);
+
+  /**
+   * Same as ScanPage, but hands out views of the tuple bytes in the page instead of deserialized rows
+   * @param[in] callback called with each tuple while the page is pinned and latched, the view is only valid inside it
+   * @return false if the page could not be fetched
+   */
+  bool ScanPageViews(page_id_t page_id, const std::function<void(const RowView &)> &callback, Transaction *txn);
+
+  /**
+   * Read a tuple as a view of its bytes in the page
+   * @param[in] callback called with the tuple while the page is pinned and latched, the view is only valid inside it
+   * @return true if the tuple exists, otherwise the callback is not called
+   */
+  bool GetTupleView(const RowId &rid, const std::function<void(const RowView &)> &callback);
+
   /**
    * Free table heap and release storage in disk file. 销毁整个TableHeap并释放这些数据页
    */
@@ -94,6 +129,18 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of this table's free space map
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return free_space_map_.GetFirstPageId(); }
+
+  inline const FreeSpaceMap &GetFreeSpaceMap() const { return free_space_map_; }
+
+  /**
+   * @return read-ahead for a reader walking the pages of GetFreeSpaceMap().GetHeapPage() in order
+   */
+  inline ReadAhead NewReadAhead() { return ReadAhead(buffer_pool_manager_, &free_space_map_); }
+
 private:
   /**
    * create table heap and initialize first page
@@ -103,23 +150,23 @@ private:
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
+          lock_manager_(lock_manager),
+          free_space_map_(buffer_pool_manager) {
             auto page = reinterpret_cast<TablePage *>(buffer_pool_manager->NewPage(first_page_id_));
             page->Init(first_page_id_, INVALID_PAGE_ID, log_manager, txn);
+            uint32_t free_bytes = page->GetFreeSpaceRemaining();
             buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-            // ASSERT(false, "Not implemented yet.");
+            free_space_map_.Init();
+            free_space_map_.AddPage(first_page_id_, free_bytes);
   };
 
   /**
-   * load existing table heap by first_page_id
+   * load existing table heap by first_page_id, the free space map is rebuilt from the page chain
+   * if free_space_map_page_id is INVALID_PAGE_ID
    */
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
-          : buffer_pool_manager_(buffer_pool_manager),
-            first_page_id_(first_page_id),
-            schema_(schema),
-            log_manager_(log_manager),
-            lock_manager_(lock_manager) {}
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                     page_id_t free_space_map_page_id, Schema *schema, LogManager *log_manager,
+                     LockManager *lock_manager);
 
 private:
   BufferPoolManager *buffer_pool_manager_;
@@ -127,6 +174,8 @@ private:
   Schema *schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  FreeSpaceMap free_space_map_;
+  std::mutex append_latch_;  /** serializes inserters linking a new page at the tail of the heap chain */
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
@@ -3,6 +3,7 @@
 
 #include "common/rowid.h"
 #include "record/row.h"
+#include "storage/read_ahead.h"
 #include "transaction/transaction.h"
 
 class TableHeap;
@@ -24,7 +25,8 @@ public:
 
   void operator = (const TableIterator &itr) { 
     table_heap_ = itr.table_heap_;
-    row_ = itr.row_;
+    row_->SetRowId(itr.row_->GetRowId());
+    read_ahead_ = itr.read_ahead_;
   }
 
   const Row &operator*();
@@ -43,9 +45,16 @@ public:
    */
   TableIterator operator++(int);
 
+private:
+  /**
+   * @brief 进入一个新的数据页时调用，预读其后的数据页
+   */
+  void ReadAheadFrom(page_id_t page_id);
+
 private:
   TableHeap *table_heap_;
   Row *row_;
+  ReadAhead read_ahead_;
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <string>
+#include <thread>
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
 #include "page/index_roots_page.h"
 
@@ -22,45 +25,36 @@ BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager* buffer_pool_ma
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy() {
-  Page* root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  BPlusTreePage* root_node = reinterpret_cast<BPlusTreePage*>(root_page->GetData());
-  // directly delete if it is a leaf page
-  if (root_node->IsLeafPage()) {
-    buffer_pool_manager_->DeletePage(root_page_id_);
-  }
-  // else delete the internal pages one by one
-  else {
-    for (auto page_id : destroy_internal_pages_id) {
-      buffer_pool_manager_->DeletePage(page_id);
-    }
-  }
-  buffer_pool_manager_->UnpinPage(root_page->GetPageId(), false);
-
-  // firstly find the first leaf page
-  KeyType key;
-  Page* leaf_page = FindLeafPage(key, true);
-  ASSERT(leaf_page, "leaf page is nullptr");
-  LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  assert(leaf_node->IsLeafPage());
-  page_id_t next_id = leaf_node->GetNextPageId();
-
-  // delete all the leaf pages which are linear arranged
-  while (next_id != INVALID_PAGE_ID) {
-    buffer_pool_manager_->DeletePage(leaf_page->GetPageId());
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-
-    leaf_page = buffer_pool_manager_->FetchPage(next_id);
-    leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-    assert(leaf_node->IsLeafPage());
-    next_id = leaf_node->GetNextPageId();
+  if (IsEmpty()) {
+    return;
   }
-  buffer_pool_manager_->DeletePage(leaf_page->GetPageId());
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  DestroySubtree(root_page_id_);
 
   // delete <index_id, root_page_id> from header page
   UpdateRootPageId(2);
   root_page_id_ = INVALID_PAGE_ID;
-  destroy_internal_pages_id.clear();
+}
+
+/**
+ * Delete a page and every page below it, each page is unpinned before it is deleted
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DestroySubtree(page_id_t page_id) {
+  Page* page = buffer_pool_manager_->FetchPage(page_id);
+  ASSERT(page != nullptr, "out of memory");
+  BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
+  std::vector<page_id_t> children;
+  if (!node->IsLeafPage()) {
+    InternalPage* internal_node = reinterpret_cast<InternalPage*>(node);
+    for (int i = 0; i < internal_node->GetSize(); i++) {
+      children.push_back(internal_node->ValueAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  for (auto child_id : children) {
+    DestroySubtree(child_id);
+  }
+  buffer_pool_manager_->DeletePage(page_id);
 }
 
 /**
@@ -81,8 +75,8 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
   */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType& key, std::vector<ValueType>& result, Transaction* transaction) {
-  // Find the leaf node containing key
-  auto leaf_page = FindLeafPage(key, false);
+  // Find the leaf node containing key, read latched
+  auto leaf_page = CrabToLeaf(key, false, false);
   // If the root have not created, or the key do not exist, return false
   if (!leaf_page)
     return false;
@@ -91,7 +85,8 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType& key, std::vector<ValueType>& result
   ValueType value;
   // Find value in leaf node
   bool ret = leaf_node->Lookup(key, value, comparator_);
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
+  leaf_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
   if (!ret) return false;
   result.push_back(value);
   return true;
@@ -109,13 +104,36 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType& key, std::vector<ValueType>& result
   */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType& key, const ValueType& value, Transaction* transaction) {
-  // If there is no root node, create the tree
-  if (IsEmpty()) {
+  // 1. Optimistic: only the leaf is write latched, enough if the leaf does not split
+  Page* leaf_page = CrabToLeaf(key, false, true);
+  if (leaf_page != nullptr) {
+    LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+    ValueType lookup_value;
+    bool duplicate = leaf_node->Lookup(key, lookup_value, comparator_);
+    bool fit = !duplicate && leaf_node->GetSize() < leaf_node->GetMaxSize();
+    if (fit) {
+      leaf_node->Insert(key, value, comparator_);
+    }
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), fit);
+    if (duplicate || fit) {
+      return fit;
+    }
+  }
+
+  // 2. Pessimistic: write latch the path down from the highest ancestor that may split
+  LatchContext context;
+  leaf_page = CrabToLeafPessimistic(key, Operation::kInsert, context);
+  bool ret = true;
+  if (leaf_page == nullptr) {
+    // If there is no root node, create the tree
     StartNewTree(key, value);
-    return true;
   }
-  // else, insert into the tree
-  return InsertIntoLeaf(key, value, transaction);
+  else {
+    ret = InsertIntoLeaf(key, value, context);
+  }
+  ReleaseLatches(context, ret);
+  return ret;
 }
 
 /**
@@ -152,10 +170,9 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType& key, const ValueType& value) {
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType& key, const ValueType& value, Transaction* transaction) {
-  // 1. Find the leaf node containing key
-  auto leaf_page = FindLeafPage(key, false);
-  ASSERT(leaf_page, "leaf page is nullptr");
+bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType& key, const ValueType& value, LatchContext& context) {
+  // 1. The leaf node containing key is the last page latched
+  auto leaf_page = context.latched_pages_.back();
   LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
   assert(leaf_node->IsLeafPage());
 
@@ -164,14 +181,12 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType& key, const ValueType& value,
 
   // 2. If the key already exist in leaf, return false immediately
   if (leaf_node->Lookup(key, lookup_value, comparator_)) {
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
     return false;
   }
 
   // 3.1. If the leaf has space to insert, insert that <key, value>, then return
   if (leaf_node->GetSize() < leaf_node->GetMaxSize()) {
     leaf_node->Insert(key, value, comparator_);
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
     return true;
   }
 
@@ -191,10 +206,10 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType& key, const ValueType& value,
     new_leaf->SetNextPageId(leaf_node->GetPageId());
   }
 
-  InsertIntoParent(leaf_node, new_leaf->KeyAt(0), new_leaf, transaction);
+  InsertIntoParent(leaf_node, new_leaf->KeyAt(0), new_leaf, context);
 
+  // the new leaf is only reachable through latched pages, no need to latch it
   buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
   return true;
 }
 
@@ -250,7 +265,7 @@ N* BPLUSTREE_TYPE::Split(N* node) {
  * recursively if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage* old_node, const KeyType& key, BPlusTreePage* new_node, Transaction* transaction) {
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage* old_node, const KeyType& key, BPlusTreePage* new_node, LatchContext& context) {
   // If the root node splitted, then should create a new root
   // the height of tree will increase by 1
   if (old_node->IsRootPage()) {
@@ -281,7 +296,6 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage* old_node, const KeyType& ke
   page_id_t parent_page_id = old_node->GetParentPageId();
   Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
   ASSERT(parent_page != nullptr, "out of memory");
-  assert(parent_page->GetPinCount() == 1);
   InternalPage* parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
 
   // If the parent has space to insert new node, insert new node, then return
@@ -302,7 +316,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage* old_node, const KeyType& ke
     new_parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
     new_node->SetParentPageId(new_parent->GetPageId());
   }
-  InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+  InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, context);
 
   buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
   buffer_pool_manager_->UnpinPage(parent_page_id, true);
@@ -320,42 +334,54 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage* old_node, const KeyType& ke
   */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType& key, Transaction* transaction) {
-  if (root_page_id_ == INVALID_PAGE_ID) return;
-
-  // Find the leaf page which contains the key
-  Page* leaf_page = FindLeafPage(key, false);
-  ASSERT(leaf_page, "leaf page is nullptr");
+  // Optimistic: only the leaf is write latched, enough if the leaf does not underflow
+  Page* leaf_page = CrabToLeaf(key, false, true);
+  if (leaf_page == nullptr) return;
   LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  assert(leaf_node->IsLeafPage());
   ValueType lookup_value;
-  if (leaf_node->Lookup(key, lookup_value, comparator_) == false) {
-    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    return;
+  bool found = leaf_node->Lookup(key, lookup_value, comparator_);
+  bool safe = found && IsSafe(leaf_node, Operation::kRemove);
+  // The parent key is a lower bound of the leaf, it stays valid after the first key is deleted
+  if (safe) {
+    leaf_node->RemoveAndDeleteRecord(key, comparator_);
   }
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), safe);
+  if (!found || safe) return;
+
+  // Pessimistic: write latch the path down from the highest ancestor that may underflow
+  while (true) {
+    LatchContext context;
+    leaf_page = CrabToLeafPessimistic(key, Operation::kRemove, context);
+    if (leaf_page == nullptr) {
+      ReleaseLatches(context, false);
+      return;
+    }
+    leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+    assert(leaf_node->IsLeafPage());
+    if (leaf_node->Lookup(key, lookup_value, comparator_) == false) {
+      ReleaseLatches(context, false);
+      return;
+    }
+    // 迭代器从左向右加锁，这里只能尝试锁住左兄弟，失败时放弃所有锁重试以免死锁
+    safe = IsSafe(leaf_node, Operation::kRemove);
+    if (!safe && !TryLatchPrevLeaf(leaf_node, context)) {
+      ReleaseLatches(context, false);
+      std::this_thread::yield();
+      continue;
+    }
 
-  // Delete this key in the leaf page
-  // Set leaf_size as the size of this leaf after delete
-  int leaf_size = leaf_node->RemoveAndDeleteRecord(key, comparator_);
-  //不满足每个节点size都在minsize和maxsize区间的条件了，则要对其进行redistribute或merge
-  if (leaf_size < leaf_node->GetMinSize()) {
-    CoalesceOrRedistribute(leaf_node, transaction);
-  }
-  else {
-    page_id_t parent_id = leaf_node->GetParentPageId();
-    if (parent_id != INVALID_PAGE_ID) {
-      Page* parent_page = buffer_pool_manager_->FetchPage(parent_id);
-      InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
-      KeyType newkey = leaf_node->GetItem(0).first;
-      // newkey is the leftest key in leaf, adjust value in parent
-      if (leaf_node->KeyIndex(newkey, comparator_) == 0) {
-        int index = parent_node->ValueIndex(leaf_node->GetPageId());
-        parent_node->SetKeyAt(index, newkey);
-      }
-      buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+    // Delete this key in the leaf page
+    // Set leaf_size as the size of this leaf after delete
+    int leaf_size = leaf_node->RemoveAndDeleteRecord(key, comparator_);
+    //不满足每个节点size都在minsize和maxsize区间的条件了，则要对其进行redistribute或merge
+    // 变长叶子的 min size 随空闲空间变化，只有删除前不安全时才持有父节点的锁
+    if (!safe && leaf_size < leaf_node->GetMinSize()) {
+      CoalesceOrRedistribute(leaf_node, context);
     }
+    ReleaseLatches(context, true);
+    return;
   }
-
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
 }
 
 /**
@@ -367,29 +393,22 @@ void BPLUSTREE_TYPE::Remove(const KeyType& key, Transaction* transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N* node, Transaction* transaction) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N* node, LatchContext& context) {
   // 如果递归进行到root，单独考虑
   if (node->IsRootPage()) {
-    return AdjustRoot(node);
-  }
-  page_id_t parent_id, prev_id = INVALID_PAGE_ID, next_id = INVALID_PAGE_ID;
-  N* prev_node;
-  N* next_node;
-  Page* prev_page;
-  Page* next_page;
-  parent_id = node->GetParentPageId();
-  Page* parent_page = buffer_pool_manager_->FetchPage(parent_id);
-  InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
+    return AdjustRoot(node, context);
+  }
+  // the parent and siblings are write latched and pinned by context until the operation ends
+  N* prev_node = nullptr;
+  N* next_node = nullptr;
+  page_id_t parent_id = node->GetParentPageId();
+  InternalPage* parent_node = reinterpret_cast<InternalPage*>(FetchLatchedPage(parent_id, context)->GetData());
   int node_index = parent_node->ValueIndex(node->GetPageId());
   if (node_index > 0) {// means that the pre_node exists
-    prev_id = parent_node->ValueAt(node_index - 1);
-    prev_page = buffer_pool_manager_->FetchPage(prev_id);
-    prev_node = reinterpret_cast<N*>(prev_page->GetData());
+    prev_node = reinterpret_cast<N*>(FetchLatchedPage(parent_node->ValueAt(node_index - 1), context)->GetData());
     // pre比半页多，node比半页少，将pre的最后一个移到node的第一个
     if (prev_node->GetSize() > prev_node->GetMinSize()) {
       Redistribute(prev_node, node, 1);
-      buffer_pool_manager_->UnpinPage(parent_id, true);
-      buffer_pool_manager_->UnpinPage(prev_id, true);
       return false;
     }
   }
@@ -398,17 +417,10 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N* node, Transaction* transaction) {
 
   // the next_node exists
   if (node_index != parent_node->GetSize() - 1) {
-    next_id = parent_node->ValueAt(node_index + 1);
-    next_page = buffer_pool_manager_->FetchPage(next_id);
-    next_node = reinterpret_cast<N*>(next_page->GetData());
+    next_node = reinterpret_cast<N*>(FetchLatchedPage(parent_node->ValueAt(node_index + 1), context)->GetData());
     // next比半页多，node比半页少，将next的第一个移到node的最后一个
     if (next_node->GetSize() > next_node->GetMinSize()) {
       Redistribute(next_node, node, 0);
-      buffer_pool_manager_->UnpinPage(parent_id, true);
-      buffer_pool_manager_->UnpinPage(next_id, true);
-      if (node_index > 0) {
-        buffer_pool_manager_->UnpinPage(prev_id, false);
-      }
       return false;
     }
   }
@@ -419,23 +431,15 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N* node, Transaction* transaction) {
   // 3. (node_index在(0,parent_size-1) and next_node->GetSize() <= next_node->GetMinSize() and prev_node->GetSize() <= prev_node->GetMinSize())
 
   // situation: 2,3
-  if (prev_id != INVALID_PAGE_ID) {
-    Coalesce(&prev_node, &node, &parent_node, node_index, transaction);
-    buffer_pool_manager_->UnpinPage(parent_id, true);
-    buffer_pool_manager_->UnpinPage(prev_id, true);
-    if (next_id != INVALID_PAGE_ID) {
-      buffer_pool_manager_->UnpinPage(next_id, false);
-    }
+  if (prev_node != nullptr) {
+    Coalesce(&prev_node, &node, &parent_node, node_index, context);
     return true;
   }
   // situation: 1
   else {
-    Coalesce(&node, &next_node, &parent_node, node_index + 1, transaction);
-    buffer_pool_manager_->UnpinPage(parent_id, true);
-    buffer_pool_manager_->UnpinPage(next_id, true);
+    Coalesce(&node, &next_node, &parent_node, node_index + 1, context);
     return false;
   }
-  return false;
 }
 
 /**
@@ -453,13 +457,17 @@ INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 bool BPLUSTREE_TYPE::Coalesce(N** neighbor_node, N** node,
   BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>** parent, int index,
-  Transaction* transaction) {
+  LatchContext& context) {
   // leaf node
   if ((*node)->IsLeafPage()) {
     LeafPage* op_node = reinterpret_cast<LeafPage*>(*node);
     LeafPage* op_neighbor_node = reinterpret_cast<LeafPage*>(*neighbor_node);
     assert(op_node->IsLeafPage());
     assert(op_neighbor_node->IsLeafPage());
+    // a prefix compressed leaf stays underflowed if the merged entries do not fit
+    if (!op_node->CanMergeInto(op_neighbor_node)) {
+      return false;
+    }
     op_node->MoveAllTo(op_neighbor_node);
   }
   // internal node, needs to change the middlekey
@@ -469,12 +477,12 @@ bool BPLUSTREE_TYPE::Coalesce(N** neighbor_node, N** node,
     KeyType middle_key = (*parent)->KeyAt(index);
     op_node->MoveAllTo(op_neighbor_node, middle_key, buffer_pool_manager_);
   }
-  buffer_pool_manager_->UnpinPage((*node)->GetPageId(), true);
-  buffer_pool_manager_->DeletePage((*node)->GetPageId());
+  // the page is still latched and pinned, delete it after the latches are released
+  context.deleted_pages_.push_back((*node)->GetPageId());
   (*parent)->Remove(index);
   assert((*parent));
   if ((*parent)->GetSize() < (*parent)->GetMinSize()) {//if parent node is not maintain size condition
-    return CoalesceOrRedistribute(*parent, transaction);
+    return CoalesceOrRedistribute(*parent, context);
   }
   return false;
 }
@@ -547,7 +555,7 @@ void BPLUSTREE_TYPE::Redistribute(N* neighbor_node, N* node, int index) {
  * happened
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage* old_root_node) {
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage* old_root_node, LatchContext& context) {
   // size of root page can be less than min size
   if (old_root_node->GetSize() > 1) {
     return false; // means not delete this node
@@ -569,12 +577,236 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage* old_root_node) {
     new_root_node->SetParentPageId(INVALID_PAGE_ID);
     buffer_pool_manager_->UnpinPage(new_root_id, true);
   }
+  // root_latch_ is held since the old root is not safe
   root_page_id_ = new_root_id;
-  UpdateRootPageId(0);
+  // an empty tree has no record, StartNewTree inserts it again
+  UpdateRootPageId(new_root_id == INVALID_PAGE_ID ? 2 : 0);
+  context.deleted_pages_.push_back(old_root_node->GetPageId());
+
+  return true;
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<int> BPLUSTREE_TYPE::PlanPageSizes(size_t count, int max_size, int min_size, double fill_factor) {
+  int target = std::min(std::max(static_cast<int>(max_size * fill_factor), std::max(min_size, 1)), max_size);
+  // floor keeps every page at least at target, ceil keeps it within max_size
+  size_t num_pages = std::max<size_t>({count / target, (count + max_size - 1) / max_size, 1});
+  std::vector<int> sizes(num_pages, static_cast<int>(count / num_pages));
+  for (size_t i = 0; i < count % num_pages; i++) {
+    sizes[i]++;
+  }
+  return sizes;
+}
+
+/**
+ * Pages are allocated top down, internal levels first and then the leaves, so every page knows its parent when it
+ * is written and the leaves are contiguous on disk. The leaves are filled from the input in one pass, remembering
+ * the first key of each page, and the internal levels are filled from those keys bottom up.
+ * Leaves of variable length entries hold as many entries as fit, so they are filled first, and get their parents
+ * when the lowest internal level is filled.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(size_t count, const std::function<bool(MappingType &)> &next, double fill_factor) {
+  root_latch_.WLock();
+  if (!IsEmpty()) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  if (count == 0) {
+    root_latch_.WUnlock();
+    return true;
+  }
+
+  std::vector<std::vector<int>> levels(1);
+  std::vector<std::vector<page_id_t>> page_ids(1);
+  std::vector<std::pair<KeyType, page_id_t>> first_keys;
+  bool ok = true;
+  KeyType last_key;
+  size_t loaded = 0;
+  // the next entry, if it is strictly greater than the last one
+  auto next_in_order = [&](MappingType &item) {
+    if (!next(item)) {
+      return false;
+    }
+    if (loaded++ > 0 && comparator_(last_key, item.first) >= 0) {
+      ok = false;
+      return false;
+    }
+    last_key = item.first;
+    return true;
+  };
+
+  // 1. the number of entries of every page, level by level from the leaves up
+  if constexpr (LeafPage::kVariableLength) {
+    // every leaf takes as many entries from the window as fit, the window holds more than a leaf can
+    std::vector<MappingType> window;
+    MappingType item;
+    while (loaded < count && static_cast<int>(window.size()) <= LeafPage::kMaxEntries && next_in_order(item)) {
+      window.push_back(item);
+    }
+    while (ok && !window.empty()) {
+      const KeyType *low_fence = first_keys.empty() ? nullptr : &window.front().first;
+      int size = LeafPage::PlanFill(low_fence, window.data(), static_cast<int>(window.size()), fill_factor);
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id);
+      ASSERT(page != nullptr, "out of memory");
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      leaf->SetFences(low_fence, size < static_cast<int>(window.size()) ? &window[size].first : nullptr);
+      leaf->CopyNFrom(window.data(), size);
+      if (!page_ids[0].empty()) {
+        Page *prev_page = buffer_pool_manager_->FetchPage(page_ids[0].back());
+        ASSERT(prev_page != nullptr, "out of memory");
+        reinterpret_cast<LeafPage *>(prev_page->GetData())->SetNextPageId(page_id);
+        buffer_pool_manager_->UnpinPage(page_ids[0].back(), true);
+      }
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      levels[0].push_back(size);
+      page_ids[0].push_back(page_id);
+      first_keys.emplace_back(window.front().first, page_id);
+      window.erase(window.begin(), window.begin() + size);
+      while (loaded < count && static_cast<int>(window.size()) <= LeafPage::kMaxEntries && next_in_order(item)) {
+        window.push_back(item);
+      }
+    }
+    ok = ok && loaded == count;
+  } else {
+    levels[0] = PlanPageSizes(count, leaf_max_size_, leaf_max_size_ >> 1, fill_factor);
+  }
+  if (ok) {
+    while (levels.back().size() > 1) {
+      levels.push_back(PlanPageSizes(levels.back().size(), internal_max_size_, internal_max_size_ >> 1, fill_factor));
+    }
+  }
+  page_ids.resize(levels.size());
+
+  // 2. allocate the internal pages from the root down
+  std::vector<page_id_t> parent_ids{INVALID_PAGE_ID};
+  for (size_t level = levels.size() - 1; level > 0; level--) {
+    size_t parent = 0;
+    int children = 0;
+    for (size_t i = 0; i < levels[level].size(); i++) {
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id);
+      ASSERT(page != nullptr, "out of memory");
+      reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_ids[parent], internal_max_size_);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      page_ids[level].push_back(page_id);
+      if (level + 1 < levels.size() && ++children == levels[level + 1][parent]) {
+        parent++;
+        children = 0;
+      }
+    }
+    parent_ids = page_ids[level];
+  }
+
+  // 3. fill the leaves and link them
+  if constexpr (!LeafPage::kVariableLength) {
+    std::vector<MappingType> items;
+    LeafPage *prev_leaf = nullptr;
+    size_t parent = 0;
+    int children = 0;
+    for (size_t i = 0; i < levels[0].size(); i++) {
+      items.clear();
+      MappingType item;
+      while (static_cast<int>(items.size()) < levels[0][i] && next_in_order(item)) {
+        items.push_back(item);
+      }
+      if (static_cast<int>(items.size()) < levels[0][i]) {
+        ok = false;
+        break;
+      }
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id);
+      ASSERT(page != nullptr, "out of memory");
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      leaf->Init(page_id, parent_ids[parent], leaf_max_size_);
+      leaf->CopyNFrom(items.data(), static_cast<int>(items.size()));
+      page_ids[0].push_back(page_id);
+      first_keys.emplace_back(items.front().first, page_id);
+      if (levels.size() > 1 && ++children == levels[1][parent]) {
+        parent++;
+        children = 0;
+      }
+      if (prev_leaf != nullptr) {
+        prev_leaf->SetNextPageId(page_id);
+        buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+      }
+      prev_leaf = leaf;
+    }
+    if (prev_leaf != nullptr) {
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+  }
+  if (!ok) {
+    for (auto &level_page_ids : page_ids) {
+      for (auto page_id : level_page_ids) {
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+    }
+    root_latch_.WUnlock();
+    return false;
+  }
+
+  // 4. fill the internal pages with the first keys of their children
+  for (size_t level = 1; level < levels.size(); level++) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_keys;
+    size_t child = 0;
+    for (size_t i = 0; i < levels[level].size(); i++) {
+      Page *page = buffer_pool_manager_->FetchPage(page_ids[level][i]);
+      ASSERT(page != nullptr, "out of memory");
+      auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+      for (int j = 0; j < levels[level][i]; j++, child++) {
+        node->SetKeyAt(j, first_keys[child].first);
+        node->SetValueAt(j, first_keys[child].second);
+        if (LeafPage::kVariableLength && level == 1) {
+          Page *leaf_page = buffer_pool_manager_->FetchPage(first_keys[child].second);
+          ASSERT(leaf_page != nullptr, "out of memory");
+          reinterpret_cast<BPlusTreePage *>(leaf_page->GetData())->SetParentPageId(page_ids[level][i]);
+          buffer_pool_manager_->UnpinPage(first_keys[child].second, true);
+        }
+      }
+      node->SetSize(levels[level][i]);
+      parent_keys.emplace_back(node->KeyAt(0), page_ids[level][i]);
+      buffer_pool_manager_->UnpinPage(page_ids[level][i], true);
+    }
+    first_keys.swap(parent_keys);
+  }
 
+  root_page_id_ = page_ids.back().front();
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
   return true;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetPageCount() {
+  return IsEmpty() ? 0 : GetPageCount(root_page_id_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetPageCount(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  ASSERT(page != nullptr, "out of memory");
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  std::vector<page_id_t> children;
+  if (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      children.push_back(internal->ValueAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  size_t count = 1;
+  for (auto child : children) {
+    count += GetPageCount(child);
+  }
+  return count;
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -586,11 +818,11 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage* old_root_node) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
   KeyType key;
-  Page* leaf_page = FindLeafPage(key, true); // Pinned !!!
-  ASSERT(leaf_page, "leaf page is nullptr");
-  LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  assert(leaf_node->IsLeafPage());
-  return INDEXITERATOR_TYPE(leaf_node, 0, buffer_pool_manager_);
+  Page* leaf_page = CrabToLeaf(key, true, false); // Pinned and read latched !!!
+  if (leaf_page == nullptr) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(leaf_page, 0, buffer_pool_manager_);
 }
 
 /**
@@ -600,12 +832,14 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType& key) {
-  Page* leaf_page = FindLeafPage(key, false); // Pinned !!!
-  ASSERT(leaf_page, "leaf page is nullptr");
+  Page* leaf_page = CrabToLeaf(key, false, false); // Pinned and read latched !!!
+  if (leaf_page == nullptr) {
+    return End();
+  }
   LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
   assert(leaf_node->IsLeafPage());
   int index = leaf_node->KeyIndex(key, comparator_);
-  return INDEXITERATOR_TYPE(leaf_node, index, buffer_pool_manager_);
+  return INDEXITERATOR_TYPE(leaf_page, index, buffer_pool_manager_);
 }
 
 /**
@@ -629,27 +863,173 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
   */
 INDEX_TEMPLATE_ARGUMENTS
 Page* BPLUSTREE_TYPE::FindLeafPage(const KeyType& key, bool leftMost) {
+  Page* page = CrabToLeaf(key, leftMost, false);
+  if (page != nullptr) {
+    page->RUnlatch();
+  }
+  return page;
+}
+
+/**
+ * Read latch crabbing: latch the child before releasing the parent.
+ * The level of a page never changes, so the child can be checked for a leaf
+ * before it is latched.
+ * NOTE: the leaf page is pinned and latched, unlatch it before unpinning.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page* BPLUSTREE_TYPE::CrabToLeaf(const KeyType& key, bool leftMost, bool exclusive) {
+  root_latch_.RLock();
   // If no root, return nullptr immediately
-  if (root_page_id_ == INVALID_PAGE_ID)
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_latch_.RUnlock();
     return nullptr;
+  }
 
   Page* page = buffer_pool_manager_->FetchPage(root_page_id_); // Pinned, without unpinned
   BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
+  bool leaf = node->IsLeafPage();
+  if (leaf && exclusive) {
+    page->WLatch();
+  }
+  else {
+    page->RLatch();
+  }
   ASSERT(node->IsRootPage(), "Not Root Page");
+  root_latch_.RUnlock();
 
   // if leftMost is false, call Lookup() to find next child
   // if leftMost is true, next child is ValueAt(0) in each step
-  while (!node->IsLeafPage()) {
+  while (!leaf) {
     InternalPage* internal_node = reinterpret_cast<InternalPage*>(page->GetData());
     page_id_t next_page_id = leftMost ? internal_node->ValueAt(0) : internal_node->Lookup(key, comparator_);
-    buffer_pool_manager_->UnpinPage(internal_node->GetPageId(), false);
-    page = buffer_pool_manager_->FetchPage(next_page_id);
+    Page* child_page = buffer_pool_manager_->FetchPage(next_page_id);
+    node = reinterpret_cast<BPlusTreePage*>(child_page->GetData());
+    leaf = node->IsLeafPage();
+    if (leaf && exclusive) {
+      child_page->WLatch();
+    }
+    else {
+      child_page->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child_page;
+  }
+
+  return page;
+}
+
+/**
+ * Write latch crabbing: once a node is safe, no split or merge propagates
+ * above it, so the latches of all its ancestors are released.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page* BPLUSTREE_TYPE::CrabToLeafPessimistic(const KeyType& key, Operation op, LatchContext& context) {
+  root_latch_.WLock();
+  context.root_latched_ = true;
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+
+  Page* page = FetchLatchedPage(root_page_id_, context);
+  BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
+  while (true) {
+    if (IsSafe(node, op)) {
+      // release all ancestors, the root latch as well
+      for (size_t i = 0; i + 1 < context.latched_pages_.size(); i++) {
+        Page* ancestor = context.latched_pages_[i];
+        ancestor->WUnlatch();
+        buffer_pool_manager_->UnpinPage(ancestor->GetPageId(), false);
+      }
+      context.latched_pages_.erase(context.latched_pages_.begin(), context.latched_pages_.end() - 1);
+      if (context.root_latched_) {
+        root_latch_.WUnlock();
+        context.root_latched_ = false;
+      }
+    }
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    InternalPage* internal_node = reinterpret_cast<InternalPage*>(node);
+    page = FetchLatchedPage(internal_node->Lookup(key, comparator_), context);
     node = reinterpret_cast<BPlusTreePage*>(page->GetData());
   }
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage* node, Operation op) const {
+  if (op == Operation::kInsert) {
+    return node->GetSize() < node->GetMaxSize();
+  }
+  // AdjustRoot changes the root when a root leaf becomes empty or a root internal page has one child left
+  if (node->IsRootPage()) {
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  }
+  return node->GetSize() > node->GetMinSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page* BPLUSTREE_TYPE::FetchLatchedPage(page_id_t page_id, LatchContext& context) {
+  for (auto page : context.latched_pages_) {
+    if (page->GetPageId() == page_id) {
+      return page;
+    }
+  }
+  Page* page = buffer_pool_manager_->FetchPage(page_id);
+  ASSERT(page != nullptr, "out of memory");
+  page->WLatch();
+  context.latched_pages_.push_back(page);
   return page;
 }
 
+/**
+ * Iterators hold the latch of a leaf while latching the next one, so a writer
+ * holding a leaf must not wait for the leaf before it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TryLatchPrevLeaf(LeafPage* leaf, LatchContext& context) {
+  if (leaf->IsRootPage()) {
+    return true;
+  }
+  // the parent is latched since the leaf is not safe
+  InternalPage* parent = reinterpret_cast<InternalPage*>(
+    FetchLatchedPage(leaf->GetParentPageId(), context)->GetData());
+  int index = parent->ValueIndex(leaf->GetPageId());
+  if (index == 0) {
+    return true;
+  }
+  Page* prev_page = buffer_pool_manager_->FetchPage(parent->ValueAt(index - 1));
+  ASSERT(prev_page != nullptr, "out of memory");
+  if (!prev_page->TryWLatch()) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), false);
+    return false;
+  }
+  context.latched_pages_.push_back(prev_page);
+  return true;
+}
+
+/**
+ * Pages are unlatched before they are unpinned: once unpinned, the frame may
+ * be reused for another page, which must not find it latched. A page deleted
+ * while another thread still pins it is freed at that thread's last unpin.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatches(LatchContext& context, bool is_dirty) {
+  for (auto page : context.latched_pages_) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+  context.latched_pages_.clear();
+  if (context.root_latched_) {
+    root_latch_.WUnlock();
+    context.root_latched_ = false;
+  }
+  for (auto page_id : context.deleted_pages_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  context.deleted_pages_.clear();
+}
+
 /**
  * Update/Insert root page id in header page(where page_id = 0, header_page is
  * defined under include/page/header_page.h)
@@ -916,3 +1296,9 @@ class BPlusTree<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTree<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class BPlusTree<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
@@ -1,20 +1,38 @@
+#include <algorithm>
+#include <queue>
+#include <thread>
+
 #include "index/b_plus_tree_index.h"
+#include "index/external_sorter.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
+#include "storage/table_heap.h"
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
                                      BufferPoolManager *buffer_pool_manager)
         : Index(index_id, key_schema),
           comparator_(key_schema_),
-          container_(index_id, buffer_pool_manager, comparator_) {
+          container_(index_id, buffer_pool_manager, comparator_),
+          unique_(false) {
+  for (auto column : key_schema_->GetColumns()) {
+    unique_ = unique_ || column->IsUnique();
+  }
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::SerializeKey(const Row &key, uint64_t rid, KeyType &index_key) {
+  uint32_t len = index_key.SerializeFromKey(key, key_schema_);
+  if (!unique_) {
+    index_key.SetRowIdSuffix(len, rid);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  SerializeKey(key, row_id.Get(), index_key);
 
   bool status = container_.Insert(index_key, row_id, txn);
 
@@ -27,7 +45,7 @@ dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transact
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  SerializeKey(key, row_id.Get(), index_key);
 
   container_.Remove(index_key, txn);
   return DB_SUCCESS;
@@ -35,6 +53,12 @@ dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transact
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
+  if (!unique_) {
+    // all the entries with the same columns, in RowId order
+    size_t found = result.size();
+    ScanRange(&key, true, &key, true, result, txn);
+    return result.size() > found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+  }
   KeyType index_key;
   index_key.SerializeFromKey(key, key_schema_);
   if (container_.GetValue(index_key, result, txn)) {
@@ -43,6 +67,112 @@ dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Tra
   return DB_KEY_NOT_FOUND;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRange(const Row *lo, bool lo_inclusive, const Row *hi, bool hi_inclusive,
+                                        vector<RowId> &result, Transaction *txn) {
+  KeyType lo_key;
+  KeyType hi_key;
+  // with a RowId suffix, an inclusive lower bound sorts before every RowId of its columns and an exclusive one after
+  // them, the upper bound likewise
+  if (lo != nullptr) {
+    SerializeKey(*lo, lo_inclusive ? 0 : UINT64_MAX, lo_key);
+  } else {
+    // NULL sorts first, start behind it
+    lo_key.SetMinNotNull();
+    lo_inclusive = true;
+  }
+  if (hi != nullptr) {
+    SerializeKey(*hi, hi_inclusive ? UINT64_MAX : 0, hi_key);
+  }
+  for (auto iter = container_.Begin(lo_key); iter != container_.End(); ++iter) {
+    const auto &entry = *iter;
+    if (!lo_inclusive && comparator_(entry.first, lo_key) == 0) {
+      continue;
+    }
+    if (hi != nullptr) {
+      int cmp = comparator_(entry.first, hi_key);
+      if (cmp > 0 || (cmp == 0 && !hi_inclusive)) {
+        break;
+      }
+    }
+    result.push_back(entry.second);
+  }
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, double fill_factor,
+                                       size_t num_threads, Transaction *txn) {
+  if (!container_.IsEmpty()) {
+    return DB_FAILED;
+  }
+  auto less = [this](const MappingType &lhs, const MappingType &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+  using Sorter = ExternalSorter<MappingType, decltype(less)>;
+  const std::vector<page_id_t> pages = table_heap->GetFreeSpaceMap().GetHeapPages();
+  num_threads = std::max<size_t>(std::min(num_threads, pages.size()), 1);
+
+  // 1. every worker extracts and sorts the keys of its own range of heap pages, within its share of the sort buffer
+  std::vector<Sorter *> sorters;
+  for (size_t i = 0; i < num_threads; i++) {
+    sorters.push_back(new Sorter(less, DEFAULT_SORT_BUFFER_SIZE / num_threads));
+  }
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_threads; i++) {
+    workers.emplace_back([&, i] {
+      auto add_row = [&](Row &row) {
+        std::vector<Field> fields;
+        for (auto idx : key_map) {
+          fields.push_back(*row.GetField(idx));
+        }
+        Row key(fields);
+        MappingType entry;
+        SerializeKey(key, row.GetRowId().Get(), entry.first);
+        entry.second = row.GetRowId();
+        sorters[i]->Add(entry);
+      };
+      for (size_t j = pages.size() * i / num_threads; j < pages.size() * (i + 1) / num_threads; j++) {
+        table_heap->ScanPage(pages[j], add_row, txn);
+      }
+      sorters[i]->Sort();
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // 2. merge the sorted outputs of the workers straight into the leaves
+  size_t count = 0;
+  for (auto sorter : sorters) {
+    count += sorter->GetCount();
+  }
+  std::vector<MappingType> heads(num_threads);
+  auto greater = [&](size_t lhs, size_t rhs) { return comparator_(heads[lhs].first, heads[rhs].first) > 0; };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> merge_heap(greater);
+  for (size_t i = 0; i < num_threads; i++) {
+    if (sorters[i]->Next(heads[i])) {
+      merge_heap.push(i);
+    }
+  }
+  auto next = [&](MappingType &entry) {
+    if (merge_heap.empty()) {
+      return false;
+    }
+    size_t i = merge_heap.top();
+    merge_heap.pop();
+    entry = heads[i];
+    if (sorters[i]->Next(heads[i])) {
+      merge_heap.push(i);
+    }
+    return true;
+  };
+  // the index is empty, so this only fails on duplicate keys of a unique index
+  bool status = container_.BulkLoad(count, next, fill_factor);
+  for (auto sorter : sorters) {
+    delete sorter;
+  }
+  return status ? DB_SUCCESS : DB_KEY_ALREADY_EXIST;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   container_.Destroy();
@@ -78,4 +208,10 @@ template
 class BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeIndex<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class BPlusTreeIndex<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "index/extendible_hash_table.h"
+
+#include <unordered_set>
+
+#include "glog/logging.h"
+#include "index/basic_comparator.h"
+#include "index/fixed_key.h"
+#include "index/generic_key.h"
+#include "page/index_roots_page.h"
+
+INDEX_TEMPLATE_ARGUMENTS
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, uint32_t header_max_depth,
+                                                uint32_t directory_max_depth, uint32_t bucket_max_size)
+        : index_id_(index_id), buffer_pool_manager_(buffer_pool_manager), comparator_(comparator),
+          header_max_depth_(header_max_depth), directory_max_depth_(directory_max_depth),
+          bucket_max_size_(bucket_max_size) {
+  // If the index exist, do not create, but load that table
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  ASSERT(page != nullptr, "root fetch fail");
+  auto *node = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (!node->GetRootId(index_id, &header_page_id_)) {
+    header_page_id_ = INVALID_PAGE_ID;
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+}
+
+/**
+ * FNV-1a over the key bytes, then a murmur finalizer so that both the high bits (header) and the low bits
+ * (directory) are well mixed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::Hash(const KeyType &key) {
+  auto *bytes = reinterpret_cast<const uint8_t *>(&key);
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < sizeof(KeyType); i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage(uint32_t hash, bool create) {
+  if (IsEmpty()) {
+    if (!create) {
+      return nullptr;
+    }
+    Page *header_page = buffer_pool_manager_->NewPage(header_page_id_);
+    ASSERT(header_page != nullptr, "out of memory");
+    reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->Init(header_max_depth_);
+    buffer_pool_manager_->UnpinPage(header_page_id_, true);
+    UpdateRootPageId(1);
+  }
+  Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  ASSERT(header_page != nullptr, "out of memory");
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  uint32_t directory_idx = header->HashToDirectoryIndex(hash);
+  page_id_t directory_page_id = header->GetDirectoryPageId(directory_idx);
+  if (directory_page_id != INVALID_PAGE_ID) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return buffer_pool_manager_->FetchPage(directory_page_id);
+  }
+  if (!create) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return nullptr;
+  }
+  // a new directory starts at depth 0 with a single empty bucket
+  Page *directory_page = buffer_pool_manager_->NewPage(directory_page_id);
+  ASSERT(directory_page != nullptr, "out of memory");
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  directory->Init(directory_max_depth_);
+  page_id_t bucket_page_id;
+  Page *bucket_page = buffer_pool_manager_->NewPage(bucket_page_id);
+  ASSERT(bucket_page != nullptr, "out of memory");
+  reinterpret_cast<BucketPage *>(bucket_page->GetData())->Init(bucket_max_size_);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  directory->SetBucketPageId(0, bucket_page_id);
+  header->SetDirectoryPageId(directory_idx, directory_page_id);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  // the caller only marks the directory dirty when it changes it, write the new one back now
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  return buffer_pool_manager_->FetchPage(directory_page_id);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result,
+                                          Transaction *transaction) {
+  table_latch_.RLock();
+  uint32_t hash = Hash(key);
+  Page *directory_page = FetchDirectoryPage(hash, false);
+  if (directory_page == nullptr) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  page_id_t bucket_page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+  buffer_pool_manager_->UnpinPage(directory_page->GetPageId(), false);
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  ASSERT(bucket_page != nullptr, "out of memory");
+  ValueType value;
+  bool ret = reinterpret_cast<BucketPage *>(bucket_page->GetData())->Lookup(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  table_latch_.RUnlock();
+  if (ret) {
+    result.push_back(value);
+  }
+  return ret;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  table_latch_.WLock();
+  uint32_t hash = Hash(key);
+  Page *directory_page = FetchDirectoryPage(hash, true);
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  bool ret = false;
+  bool directory_dirty = false;
+  while (true) {
+    uint32_t bucket_idx = directory->HashToBucketIndex(hash);
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    ASSERT(bucket_page != nullptr, "out of memory");
+    auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+    ValueType lookup_value;
+    if (bucket->Lookup(key, lookup_value, comparator_)) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    if (!bucket->IsFull()) {
+      ret = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+      break;
+    }
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    // all the keys of the bucket may share the low bits of the new key, keep splitting until it fits
+    if (!SplitBucket(directory, bucket_idx)) {
+      break;
+    }
+    directory_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page->GetPageId(), directory_dirty);
+  table_latch_.WUnlock();
+  return ret;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == directory->GetGlobalDepth()) {
+    if (directory->GetGlobalDepth() == directory->GetMaxDepth()) {
+      return false;
+    }
+    directory->IncrGlobalDepth();
+  }
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  page_id_t image_page_id;
+  Page *image_page = buffer_pool_manager_->NewPage(image_page_id);
+  ASSERT(image_page != nullptr, "out of memory");
+  auto *image = reinterpret_cast<BucketPage *>(image_page->GetData());
+  image->Init(bucket_max_size_);
+
+  // the slots of the bucket with the next hash bit set now point to its split image
+  uint32_t split_bit = 1u << local_depth;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == bucket_page_id) {
+      if (i & split_bit) {
+        directory->SetBucketPageId(i, image_page_id);
+      }
+      directory->SetLocalDepth(i, local_depth + 1);
+    }
+  }
+
+  // and so do its entries
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  ASSERT(bucket_page != nullptr, "out of memory");
+  auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+  for (uint32_t i = bucket->Size(); i-- > 0;) {
+    if (Hash(bucket->KeyAt(i)) & split_bit) {
+      const auto &entry = bucket->EntryAt(i);
+      image->Insert(entry.first, entry.second, comparator_);
+      bucket->RemoveAt(i);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  table_latch_.WLock();
+  uint32_t hash = Hash(key);
+  Page *directory_page = FetchDirectoryPage(hash, false);
+  if (directory_page == nullptr) {
+    table_latch_.WUnlock();
+    return false;
+  }
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  page_id_t bucket_page_id = directory->GetBucketPageId(directory->HashToBucketIndex(hash));
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  ASSERT(bucket_page != nullptr, "out of memory");
+  auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+  bool ret = bucket->Remove(key, comparator_);
+  bool is_empty = bucket->IsEmpty();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, ret);
+  if (ret && is_empty) {
+    MergeBuckets(directory, hash);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page->GetPageId(), ret && is_empty);
+  table_latch_.WUnlock();
+  return ret;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::MergeBuckets(HashTableDirectoryPage *directory, uint32_t hash) {
+  while (true) {
+    uint32_t bucket_idx = directory->HashToBucketIndex(hash);
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = directory->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || directory->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    Page *image_page = buffer_pool_manager_->FetchPage(image_page_id);
+    ASSERT(bucket_page != nullptr && image_page != nullptr, "out of memory");
+    bool bucket_empty = reinterpret_cast<BucketPage *>(bucket_page->GetData())->IsEmpty();
+    bool image_empty = reinterpret_cast<BucketPage *>(image_page->GetData())->IsEmpty();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+    // keep the bucket that may hold entries, point the slots of both to it
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t deleted_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      page_id_t page_id = directory->GetBucketPageId(i);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        directory->SetBucketPageId(i, kept_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(deleted_page_id);
+  }
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::Destroy() {
+  table_latch_.WLock();
+  if (IsEmpty()) {
+    table_latch_.WUnlock();
+    return;
+  }
+  Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  ASSERT(header_page != nullptr, "out of memory");
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  for (uint32_t i = 0; i < header->MaxSize(); i++) {
+    page_id_t directory_page_id = header->GetDirectoryPageId(i);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id);
+    ASSERT(directory_page != nullptr, "out of memory");
+    auto *directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+    std::unordered_set<page_id_t> bucket_page_ids;
+    for (uint32_t j = 0; j < directory->Size(); j++) {
+      bucket_page_ids.insert(directory->GetBucketPageId(j));
+    }
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    for (auto bucket_page_id : bucket_page_ids) {
+      buffer_pool_manager_->DeletePage(bucket_page_id);
+    }
+    buffer_pool_manager_->DeletePage(directory_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->DeletePage(header_page_id_);
+  UpdateRootPageId(2);
+  header_page_id_ = INVALID_PAGE_ID;
+  table_latch_.WUnlock();
+}
+
+/**
+ * Every bucket with local depth d must be shared by exactly the 2^(global_depth - d) slots agreeing on its low d
+ * bits, and hold only keys that hash to those slots
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::CheckDirectory(HashTableDirectoryPage *directory) {
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    uint32_t local_depth = directory->GetLocalDepth(i);
+    uint32_t local_mask = (1u << local_depth) - 1;
+    for (uint32_t j = 0; j < directory->Size(); j++) {
+      bool same_bucket = directory->GetBucketPageId(i) == directory->GetBucketPageId(j);
+      if (same_bucket != ((i & local_mask) == (j & local_mask))) {
+        return false;
+      }
+    }
+    Page *bucket_page = buffer_pool_manager_->FetchPage(directory->GetBucketPageId(i));
+    ASSERT(bucket_page != nullptr, "out of memory");
+    auto *bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+    bool ok = true;
+    for (uint32_t j = 0; j < bucket->Size() && ok; j++) {
+      ok = (Hash(bucket->KeyAt(j)) & local_mask) == (i & local_mask);
+    }
+    buffer_pool_manager_->UnpinPage(directory->GetBucketPageId(i), false);
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTENDIBLE_HASH_TABLE_TYPE::Check() {
+  bool consistent = true;
+  table_latch_.RLock();
+  if (!IsEmpty()) {
+    Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+    ASSERT(header_page != nullptr, "out of memory");
+    auto *header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+    for (uint32_t i = 0; i < header->MaxSize() && consistent; i++) {
+      page_id_t directory_page_id = header->GetDirectoryPageId(i);
+      if (directory_page_id == INVALID_PAGE_ID) {
+        continue;
+      }
+      Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id);
+      ASSERT(directory_page != nullptr, "out of memory");
+      consistent = CheckDirectory(reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData()));
+      buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  }
+  table_latch_.RUnlock();
+  if (!consistent) {
+    LOG(ERROR) << "inconsistent hash directory" << std::endl;
+  }
+  bool all_unpinned = buffer_pool_manager_->CheckAllUnpinned();
+  if (!all_unpinned) {
+    LOG(ERROR) << "problem in page unpin" << std::endl;
+  }
+  return consistent && all_unpinned;
+}
+
+/**
+ * Update the header page id recorded in the index roots page, see BPlusTree::UpdateRootPageId
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::UpdateRootPageId(int insert_record) {
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  ASSERT(page != nullptr, "root fetch fail");
+  auto *node = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (!insert_record) {
+    bool update_status = node->Update(index_id_, header_page_id_);
+    ASSERT(update_status, "update root fail");
+  } else if (insert_record == 1) {
+    bool insert_status = node->Insert(index_id_, header_page_id_);
+    ASSERT(insert_status, "insert root fail");
+  } else {
+    bool delete_status = node->Delete(index_id_);
+    ASSERT(delete_status, "delete root fail");
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
+
+template
+class ExtendibleHashTable<int, int, BasicComparator<int>>;
+
+template
+class ExtendibleHashTable<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class ExtendibleHashTable<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class ExtendibleHashTable<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class ExtendibleHashTable<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class ExtendibleHashTable<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class ExtendibleHashTable<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class ExtendibleHashTable<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
@@ -0,0 +1,22 @@
+#include "index/index.h"
+#include "storage/table_heap.h"
+
+dberr_t Index::BulkLoad(TableHeap *table_heap, const std::vector<uint32_t> &key_map, double fill_factor,
+                        size_t num_threads, Transaction *txn) {
+  for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+    // the iterator only holds the RowId of the tuple, the fields are read here
+    RowId rid = iter->GetRowId();
+    Row row(rid);
+    table_heap->GetTuple(&row, txn);
+    std::vector<Field> fields;
+    for (auto idx : key_map) {
+      fields.push_back(*row.GetField(idx));
+    }
+    Row key(fields);
+    if (InsertEntry(key, rid, txn) != DB_SUCCESS) {
+      // the key is already in a unique index
+      return DB_KEY_ALREADY_EXIST;
+    }
+  }
+  return DB_SUCCESS;
+}
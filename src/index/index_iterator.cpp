@@ -1,25 +1,46 @@
 #include "index/basic_comparator.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
 #include "index/index_iterator.h"
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(LeafPage* leaf, int index, BufferPoolManager* bpm) :
-  leaf_(leaf), index_(index), bpm_(bpm) {
-  if (leaf) {
-    // Latch the page in use
-    bpm_->FetchPage(leaf_->GetPageId())->RLatch();
-    bpm_->UnpinPage(leaf_->GetPageId(), false);
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(Page* page, int index, BufferPoolManager* bpm) :
+  page_(page), leaf_(page ? reinterpret_cast<LeafPage*>(page->GetData()) : nullptr), index_(index), bpm_(bpm) {
+  // the key searched is greater than all keys in its leaf
+  if (leaf_ && index_ == leaf_->GetSize()) {
+    MoveToNextLeaf();
   }
 }
 
-// INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(const INDEXITERATOR_TYPE &other) :
-//   leaf_(other.leaf_), index_(other.index_), bpm_(other.bpm_) {}
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(IndexIterator&& other) noexcept :
+  page_(other.page_), leaf_(other.leaf_), index_(other.index_), bpm_(other.bpm_), item_(other.item_) {
+  other.page_ = nullptr;
+  other.leaf_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE& INDEXITERATOR_TYPE::operator=(IndexIterator&& other) noexcept {
+  if (this != &other) {
+    Release();
+    page_ = other.page_;
+    leaf_ = other.leaf_;
+    index_ = other.index_;
+    bpm_ = other.bpm_;
+    item_ = other.item_;
+    other.page_ = nullptr;
+    other.leaf_ = nullptr;
+  }
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
+  Release();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
   if (leaf_) {
-    // Unlatch the page, unpin
-    bpm_->FetchPage(leaf_->GetPageId())->RUnlatch();
-    bpm_->UnpinPage(leaf_->GetPageId(), false);
-    bpm_->UnpinPage(leaf_->GetPageId(), false);
+    // Unlatch while the page is still pinned, once unpinned the frame may be reused
+    page_->RUnlatch();
+    bpm_->UnpinPage(page_->GetPageId(), false);
   }
 }
 
@@ -27,7 +48,8 @@ INDEX_TEMPLATE_ARGUMENTS const MappingType& INDEXITERATOR_TYPE::operator*() {
   ASSERT(!(
     leaf_ == nullptr || (index_ == leaf_->GetSize() && leaf_->GetNextPageId() == INVALID_PAGE_ID)
     ), "IndexIterator::operator*: out of range");
-  return leaf_->GetItem(index_);
+  item_ = leaf_->GetItem(index_);
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE& INDEXITERATOR_TYPE::operator++() {
@@ -36,41 +58,31 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE& INDEXITERATOR_TYPE::operator++() {
 
   // This page is iterate over
   if (index_ == leaf_->GetSize()) {
-    // Have next page
-    if (leaf_->GetNextPageId() != INVALID_PAGE_ID) {
-      page_id_t next_page_id = leaf_->GetNextPageId();
-
-      Page* page = bpm_->FetchPage(next_page_id);
-      ASSERT(page, "IndexIterator(operator++): Cannot Fetch next_page_id");
-
-      // Latch next page and unlatch this page
-      page->RLatch();
-      bpm_->FetchPage(leaf_->GetPageId())->RUnlatch();
-      bpm_->UnpinPage(leaf_->GetPageId(), false);
-      bpm_->UnpinPage(leaf_->GetPageId(), false);
-
-      LeafPage* next_leaf = reinterpret_cast<LeafPage*>(page->GetData());
-      assert(next_leaf->IsLeafPage());
-
-      // Point to next page
-      index_ = 0;
-      leaf_ = next_leaf;
-    }
-
-    // Havn't next page
-    else {
-      bpm_->FetchPage(leaf_->GetPageId())->RUnlatch();
-      bpm_->UnpinPage(leaf_->GetPageId(), false);
-      bpm_->UnpinPage(leaf_->GetPageId(), false);
-
-      // Point to invalid page
-      index_ = 0;
-      leaf_ = nullptr;
-    }
+    MoveToNextLeaf();
   }
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::MoveToNextLeaf() {
+  page_id_t next_page_id = leaf_->GetNextPageId();
+  Page* next_page = nullptr;
+  // Have next page, latch it before releasing this page so that it cannot be merged away meanwhile.
+  // Leaves are always latched from left to right, writers only try to latch the leaf before their own.
+  if (next_page_id != INVALID_PAGE_ID) {
+    next_page = bpm_->FetchPage(next_page_id);
+    ASSERT(next_page, "IndexIterator(operator++): Cannot Fetch next_page_id");
+    next_page->RLatch();
+  }
+  Release();
+
+  // Point to next page, or invalid page if there is no next page
+  index_ = 0;
+  page_ = next_page;
+  leaf_ = next_page ? reinterpret_cast<LeafPage*>(next_page->GetData()) : nullptr;
+  assert(!leaf_ || leaf_->IsLeafPage());
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator& itr) const {
   return bpm_ == itr.bpm_ && leaf_ == itr.leaf_ && index_ == itr.index_;
@@ -98,3 +110,9 @@ class IndexIterator<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class IndexIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class IndexIterator<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class IndexIterator<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
@@ -1,5 +1,7 @@
 #include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_key_search.h"
 #include "index/basic_comparator.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
 
 /*****************************************************************************
@@ -36,6 +38,12 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType& key) {
   this->array_[index].first = key;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType& value) {
+  ASSERT(0 <= index && index < GetMaxSize(), "index invalid");
+  this->array_[index].second = value;
+}
+
 /**
  * Helper method to find and return array index(or offset), so that its value
  * equals to input "value"
@@ -70,12 +78,8 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
   */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType& key, const KeyComparator& comparator) const {
-  int i;
-  for (i = 1; i < GetSize(); i++) {
-    if (comparator(array_[i].first, key) > 0) {
-      break;
-    }
-  }
+  // the last child whose first key is not greater than key
+  int i = KeySearch<KeyType, KeyComparator>::UpperBound(array_, 1, GetSize(), key, comparator);
   ValueType val = array_[i - 1].second;
   return val;
 }
@@ -290,4 +294,8 @@ template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparato
 
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 
-template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
\ No newline at end of file
+template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+template class BPlusTreeInternalPage<FixedKey<int32_t>, page_id_t, FixedComparator<int32_t>>;
+
+template class BPlusTreeInternalPage<FixedKey<float_t>, page_id_t, FixedComparator<float_t>>;
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <cstring>
 #include "index/basic_comparator.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
+#include "page/b_plus_tree_key_search.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 /*****************************************************************************
@@ -42,20 +45,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType& key, const KeyComparator& comparator) const {
-  /*
-  for (int i = 0; i < GetMaxSize(); i++)
-    if (comparator(array_[i].first, key) >= 0)
-      return i;
-  return 0;
-  */
-  int start = 0, end = GetSize(), mid;
-  while (start < end) {
-    mid = start + (end - start) / 2;
-    if (comparator(array_[mid].first, key) < 0)
-      start = mid + 1;
-    else end = mid;
-  }
-  return start;
+  return KeySearch<KeyType, KeyComparator>::LowerBound(array_, 0, GetSize(), key, comparator);
 }
 
 /**
@@ -146,18 +136,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType* items, int size) {
   */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType& key, ValueType& value, const KeyComparator& comparator) const {
-  int start = 0, end = GetSize() - 1;
-  while (start <= end) {
-    int mid = start + (end - start) / 2;
-    if (comparator(key, array_[mid].first) == 0) {
-      value = array_[mid].second;
-      return true;
-    }
-    else if (comparator(key, array_[mid].first) < 0)
-      end = mid - 1;
-    else start = mid + 1;
+  int key_index = KeyIndex(key, comparator);
+  if (key_index == GetSize() || comparator(array_[key_index].first, key) != 0) {
+    return false;
   }
-  return false;
+  value = array_[key_index].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -250,6 +234,368 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType& item) {
   array_[0].second = item.second;
 }
 
+/**
+ * Every entry fits since the recipient was less than half full and the neighbor could not lend
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanMergeInto(const BPlusTreeLeafPage* recipient) const {
+  return GetSize() + recipient->GetSize() <= recipient->GetMaxSize();
+}
+
+/*****************************************************************************
+ * PREFIX COMPRESSED LEAF PAGE OF GENERIC KEYS
+ *****************************************************************************/
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  ASSERT(reinterpret_cast<char*>(slots_) - reinterpret_cast<char*>(this) == static_cast<int>(kSlotsOffset),
+         "unexpected leaf page layout");
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+  next_page_id_ = INVALID_PAGE_ID;
+  entry_begin_ = PAGE_SIZE;
+  SetFences(nullptr, nullptr);
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetNextPageId() const {
+  return next_page_id_;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::SetFences(const KeyType* low_fence, const KeyType* high_fence) {
+  ASSERT(GetSize() == 0, "fences of a page that is not empty");
+  low_infinite_ = low_fence == nullptr;
+  high_infinite_ = high_fence == nullptr;
+  if (low_fence != nullptr) {
+    low_fence_ = *low_fence;
+  }
+  if (high_fence != nullptr) {
+    high_fence_ = *high_fence;
+  }
+  prefix_size_ = CommonPrefix(low_fence, high_fence);
+  UpdateMaxSize();
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::CommonPrefix(const KeyType* low_fence, const KeyType* high_fence) {
+  if (low_fence == nullptr || high_fence == nullptr) {
+    return 0;
+  }
+  int size = 0;
+  while (size < static_cast<int>(KeySize) && low_fence->data[size] == high_fence->data[size]) {
+    size++;
+  }
+  return size;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyLength(const KeyType& key) {
+  int length = KeySize;
+  while (length > 0 && key.data[length - 1] == 0) {
+    length--;
+  }
+  return length;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::EntrySize(const KeyType& key, int prefix_size) {
+  return kMaxEntrySize - KeySize + std::max(KeyLength(key) - prefix_size, 0);
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::FreeSpace() const {
+  return entry_begin_ - kSlotsOffset - GetSize() * sizeof(uint16_t);
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::UpdateMaxSize() {
+  SetMaxSize(GetSize() + static_cast<int>(FreeSpace() / kMaxEntrySize));
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+GenericKey<KeySize> B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyAt(int index) const {
+  ASSERT(0 <= index && index < GetSize(), "index invalid");
+  const char* entry = EntryAt(index);
+  int suffix_size = static_cast<uint8_t>(entry[0]);
+  KeyType key;
+  memcpy(key.data, low_fence_.data, prefix_size_);
+  memcpy(key.data + prefix_size_, entry + 1, suffix_size);
+  memset(key.data + prefix_size_ + suffix_size, 0, KeySize - prefix_size_ - suffix_size);
+  return key;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+std::pair<GenericKey<KeySize>, RowId> B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::GetItem(int index) const {
+  const char* entry = EntryAt(index);
+  MappingType item;
+  item.first = KeyAt(index);
+  memcpy(&item.second, entry + 1 + static_cast<uint8_t>(entry[0]), sizeof(ValueType));
+  return item;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::CompareAt(int index, const KeyType& key, int key_length) const {
+  const char* entry = EntryAt(index);
+  int suffix_size = static_cast<uint8_t>(entry[0]);
+  int cmp = memcmp(entry + 1, key.data + prefix_size_, suffix_size);
+  if (cmp != 0) {
+    return cmp;
+  }
+  // the entry is zero past its suffix
+  return prefix_size_ + suffix_size < key_length ? -1 : 0;
+}
+
+/**
+ * Keys out of the prefix sort before or after all entries
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::KeyIndex(const KeyType& key, const KeyComparator& comparator) const {
+  int cmp = memcmp(key.data, low_fence_.data, prefix_size_);
+  if (cmp != 0) {
+    return cmp < 0 ? 0 : GetSize();
+  }
+  int key_length = KeyLength(key);
+  int begin = 0;
+  int end = GetSize();
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    if (CompareAt(mid, key, key_length) < 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Lookup(const KeyType& key, ValueType& value,
+                                               const KeyComparator& comparator) const {
+  int key_index = KeyIndex(key, comparator);
+  if (key_index == GetSize() || CompareAt(key_index, key, KeyLength(key)) != 0) {
+    return false;
+  }
+  const char* entry = EntryAt(key_index);
+  memcpy(&value, entry + 1 + static_cast<uint8_t>(entry[0]), sizeof(ValueType));
+  return true;
+}
+
+/**
+ * The caller makes sure the page is not full and the key is within the fences
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Insert(const KeyType& key, const ValueType& value,
+                                              const KeyComparator& comparator) {
+  ASSERT(memcmp(key.data, low_fence_.data, prefix_size_) == 0, "key out of the page prefix");
+  int key_index = KeyIndex(key, comparator);
+  if (key_index < GetSize() && CompareAt(key_index, key, KeyLength(key)) == 0) {
+    return GetSize();
+  }
+  Append(std::make_pair(key, value));
+  // the new slot is the last one, move it to its place
+  uint16_t slot = slots_[GetSize() - 1];
+  memmove(slots_ + key_index + 1, slots_ + key_index, (GetSize() - 1 - key_index) * sizeof(uint16_t));
+  slots_[key_index] = slot;
+  UpdateMaxSize();
+  return GetSize();
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Append(const MappingType& item) {
+  size_t entry_size = EntrySize(item.first, prefix_size_);
+  ASSERT(entry_size <= FreeSpace(), "leaf page overflow");
+  int suffix_size = static_cast<int>(entry_size - kMaxEntrySize + KeySize);
+  entry_begin_ -= entry_size - sizeof(uint16_t);
+  char* entry = reinterpret_cast<char*>(this) + entry_begin_;
+  entry[0] = static_cast<char>(suffix_size);
+  memcpy(entry + 1, item.first.data + prefix_size_, suffix_size);
+  memcpy(entry + 1 + suffix_size, &item.second, sizeof(ValueType));
+  slots_[GetSize()] = entry_begin_;
+  if (GetSize() == GetMaxSize()) {
+    SetMaxSize(GetSize() + 1);
+  }
+  IncreaseSize(1);
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::CopyNFrom(MappingType* items, int size) {
+  for (int i = 0; i < size; i++) {
+    Append(items[i]);
+  }
+  UpdateMaxSize();
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Decode(std::vector<MappingType>& items) const {
+  for (int i = 0; i < GetSize(); i++) {
+    items.push_back(GetItem(i));
+  }
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::Rebuild(const MappingType* items, int size) {
+  SetSize(0);
+  entry_begin_ = PAGE_SIZE;
+  prefix_size_ = CommonPrefix(low_infinite_ ? nullptr : &low_fence_, high_infinite_ ? nullptr : &high_fence_);
+  for (int i = 0; i < size; i++) {
+    Append(items[i]);
+  }
+  UpdateMaxSize();
+}
+
+/**
+ * The entries are compacted, the ones packed before the removed entry move up by its size
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType& key, const KeyComparator& comparator) {
+  int key_index = KeyIndex(key, comparator);
+  if (key_index == GetSize() || CompareAt(key_index, key, KeyLength(key)) != 0) {
+    ASSERT(false, "Leaf::RemoveAndDeleteRecord: not found! ");
+    return GetSize();
+  }
+  uint16_t offset = slots_[key_index];
+  const char* entry = EntryAt(key_index);
+  uint16_t entry_size = 1 + static_cast<uint8_t>(entry[0]) + sizeof(ValueType);
+  char* page = reinterpret_cast<char*>(this);
+  memmove(page + entry_begin_ + entry_size, page + entry_begin_, offset - entry_begin_);
+  entry_begin_ += entry_size;
+  memmove(slots_ + key_index, slots_ + key_index + 1, (GetSize() - 1 - key_index) * sizeof(uint16_t));
+  IncreaseSize(-1);
+  for (int i = 0; i < GetSize(); i++) {
+    if (slots_[i] < offset) {
+      slots_[i] += entry_size;
+    }
+  }
+  UpdateMaxSize();
+  return GetSize();
+}
+
+/**
+ * Split at the middle byte, the separator becomes the high fence of this page and the low fence of the recipient,
+ * the prefixes of both may grow
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage* recipient) {
+  std::vector<MappingType> items;
+  Decode(items);
+  size_t half = (PAGE_SIZE - entry_begin_ + GetSize() * sizeof(uint16_t)) / 2;
+  size_t bytes = 0;
+  int split = 0;
+  while (split < GetSize() - 1 && bytes < half) {
+    bytes += EntrySize(items[split++].first, prefix_size_);
+  }
+  split = std::max(split, 1);
+  recipient->SetFences(&items[split].first, high_infinite_ ? nullptr : &high_fence_);
+  recipient->CopyNFrom(items.data() + split, GetSize() - split);
+  high_fence_ = items[split].first;
+  high_infinite_ = false;
+  Rebuild(items.data(), split);
+}
+
+/**
+ * This page is the right sibling, the merged page takes its high fence and the prefix may shrink
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::CanMergeInto(const BPlusTreeLeafPage* recipient) const {
+  int prefix_size = CommonPrefix(recipient->low_infinite_ ? nullptr : &recipient->low_fence_,
+                                 high_infinite_ ? nullptr : &high_fence_);
+  size_t bytes = 0;
+  for (int i = 0; i < recipient->GetSize(); i++) {
+    bytes += EntrySize(recipient->KeyAt(i), prefix_size);
+  }
+  for (int i = 0; i < GetSize(); i++) {
+    bytes += EntrySize(KeyAt(i), prefix_size);
+  }
+  return bytes <= PAGE_SIZE - kSlotsOffset;
+}
+
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage* recipient) {
+  std::vector<MappingType> items;
+  recipient->Decode(items);
+  Decode(items);
+  recipient->high_fence_ = high_fence_;
+  recipient->high_infinite_ = high_infinite_;
+  recipient->Rebuild(items.data(), static_cast<int>(items.size()));
+  recipient->SetNextPageId(GetNextPageId());
+  Rebuild(nullptr, 0);
+}
+
+/**
+ * This page is the right sibling of the recipient, its second key becomes the separator
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage* recipient) {
+  ASSERT(GetSize() > 1, "the last entry can not be moved");
+  std::vector<MappingType> items;
+  Decode(items);
+  std::vector<MappingType> recipient_items;
+  recipient->Decode(recipient_items);
+  recipient_items.push_back(items.front());
+  low_fence_ = items[1].first;
+  low_infinite_ = false;
+  recipient->high_fence_ = low_fence_;
+  recipient->high_infinite_ = false;
+  recipient->Rebuild(recipient_items.data(), static_cast<int>(recipient_items.size()));
+  Rebuild(items.data() + 1, GetSize() - 1);
+}
+
+/**
+ * This page is the left sibling of the recipient, the moved key becomes the separator
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage* recipient) {
+  ASSERT(GetSize() > 1, "the last entry can not be moved");
+  std::vector<MappingType> items;
+  Decode(items);
+  std::vector<MappingType> recipient_items{items.back()};
+  recipient->Decode(recipient_items);
+  high_fence_ = items.back().first;
+  high_infinite_ = false;
+  recipient->low_fence_ = high_fence_;
+  recipient->low_infinite_ = false;
+  recipient->Rebuild(recipient_items.data(), static_cast<int>(recipient_items.size()));
+  Rebuild(items.data(), GetSize() - 1);
+}
+
+/**
+ * The bytes taken by the first n items only grow with n, since the prefix shared with the next key can only
+ * shrink, so the largest n that fits is found by binary search
+ */
+PREFIX_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PREFIX_LEAF_PAGE_TYPE::PlanFill(const KeyType* low_fence, const MappingType* items, int size,
+                                                double fill_factor) {
+  size_t capacity = PAGE_SIZE - kSlotsOffset;
+  size_t target = std::min(std::max(static_cast<size_t>(capacity * fill_factor), kMaxEntrySize), capacity);
+  auto fits = [&](int n) {
+    int prefix_size = CommonPrefix(low_fence, n < size ? &items[n].first : nullptr);
+    size_t bytes = 0;
+    for (int i = 0; i < n && bytes <= target; i++) {
+      bytes += EntrySize(items[i].first, prefix_size);
+    }
+    return bytes <= target;
+  };
+  int low = 1;
+  int high = size;
+  while (low < high) {
+    int mid = low + (high - low + 1) / 2;
+    if (fits(mid)) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
 template
 class BPlusTreeLeafPage<int, int, BasicComparator<int>>;
 
@@ -266,4 +612,10 @@ template
 class BPlusTreeLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeLeafPage<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class BPlusTreeLeafPage<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
\ No newline at end of file
@@ -1,31 +1,16 @@
 #include "page/bitmap_page.h"
 #include "glog/logging.h"
 template<size_t PageSize>
-#define FILENAME "data"
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
   // 如果已分配满
   if (page_allocated_ == 8*MAX_CHARS) {
     return false;
   }
-  // 分配next free page
-  int byteindex = next_free_page_/8;
-  int bitindex = next_free_page_%8;
-  int tmp = 1<<bitindex;
-  bytes[byteindex] |= tmp;
+  // next_free_page_ 不大于最小的空闲页，从它开始按 64 位字查找第一个空闲位
+  page_offset = FindFreePage(next_free_page_);
+  bytes[page_offset / 8] |= 1 << (page_offset % 8);
   page_allocated_++;
-  page_offset = next_free_page_;
-  // 重新设置next free page 
-  if (page_allocated_ < 8*MAX_CHARS) {
-    for (size_t i = next_free_page_; i < 8*MAX_CHARS; i++) {
-      byteindex = i/8;
-      bitindex = i%8;
-      tmp = 1<<bitindex;
-      if ((bytes[byteindex] & tmp) == 0){
-        next_free_page_ = i;
-        break;
-	  }
-	}
-  }
+  next_free_page_ = page_offset + 1;
   return true;
 }
 
@@ -45,6 +30,21 @@ bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
   return true;
 }
 
+template<size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindFreePage(uint32_t start) const {
+  // byte i bit j is page 8 * i + j, which is bit 8 * i + j of a little endian 64 bit word
+  uint32_t word_index = start / 64;
+  uint64_t word;
+  memcpy(&word, bytes + word_index * 8, sizeof(word));
+  // pages before start count as allocated
+  word |= (uint64_t(1) << (start % 64)) - 1;
+  while (~word == 0) {
+    word_index++;
+    memcpy(&word, bytes + word_index * 8, sizeof(word));
+  }
+  return word_index * 64 + __builtin_ctzll(~word);
+}
+
 template<size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
   // 转换计算地址
@@ -0,0 +1,101 @@
+#include "page/hash_table_bucket_page.h"
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "index/basic_comparator.h"
+#include "index/fixed_key.h"
+#include "index/generic_key.h"
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_PAGE_TYPE::Init(uint32_t max_size) {
+  ASSERT(max_size <= HASH_BUCKET_PAGE_SIZE, "bucket size too large");
+  size_ = 0;
+  max_size_ = max_size;
+}
+
+/**
+ * Helper method to find the position of key, -1 if it does not exist
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int HASH_TABLE_BUCKET_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  for (uint32_t i = 0; i < size_; i++) {
+    if (comparator(array_[i].first, key) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index < 0) {
+    return false;
+  }
+  value = array_[index].second;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  if (IsFull() || KeyIndex(key, comparator) >= 0) {
+    return false;
+  }
+  array_[size_].first = key;
+  array_[size_].second = value;
+  size_++;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool HASH_TABLE_BUCKET_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index < 0) {
+    return false;
+  }
+  RemoveAt(index);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void HASH_TABLE_BUCKET_PAGE_TYPE::RemoveAt(uint32_t bucket_idx) {
+  ASSERT(bucket_idx < size_, "index invalid");
+  size_--;
+  array_[bucket_idx] = array_[size_];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+const KeyType &HASH_TABLE_BUCKET_PAGE_TYPE::KeyAt(uint32_t bucket_idx) const {
+  ASSERT(bucket_idx < size_, "index invalid");
+  return array_[bucket_idx].first;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &HASH_TABLE_BUCKET_PAGE_TYPE::EntryAt(uint32_t bucket_idx) const {
+  ASSERT(bucket_idx < size_, "index invalid");
+  return array_[bucket_idx];
+}
+
+template
+class HashTableBucketPage<int, int, BasicComparator<int>>;
+
+template
+class HashTableBucketPage<GenericKey<4>, RowId, GenericComparator<4>>;
+
+template
+class HashTableBucketPage<GenericKey<8>, RowId, GenericComparator<8>>;
+
+template
+class HashTableBucketPage<GenericKey<16>, RowId, GenericComparator<16>>;
+
+template
+class HashTableBucketPage<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class HashTableBucketPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class HashTableBucketPage<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+
+template
+class HashTableBucketPage<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
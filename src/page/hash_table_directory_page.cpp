@@ -0,0 +1,66 @@
+#include "page/hash_table_directory_page.h"
+
+#include "common/macros.h"
+
+void HashTableDirectoryPage::Init(uint32_t max_depth) {
+  ASSERT(max_depth <= HASH_DIRECTORY_MAX_DEPTH, "directory depth too large");
+  max_depth_ = max_depth;
+  global_depth_ = 0;
+  for (uint32_t i = 0; i < (1u << max_depth_); i++) {
+    local_depths_[i] = 0;
+    bucket_page_ids_[i] = INVALID_PAGE_ID;
+  }
+}
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const {
+  ASSERT(bucket_idx < Size(), "index invalid");
+  return bucket_page_ids_[bucket_idx];
+}
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  ASSERT(bucket_idx < Size(), "index invalid");
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const {
+  uint32_t local_depth = GetLocalDepth(bucket_idx);
+  return local_depth == 0 ? bucket_idx : bucket_idx ^ (1u << (local_depth - 1));
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  ASSERT(global_depth_ < max_depth_, "directory is full");
+  uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    local_depths_[size + i] = local_depths_[i];
+    bucket_page_ids_[size + i] = bucket_page_ids_[i];
+  }
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  ASSERT(global_depth_ > 0, "directory is empty");
+  global_depth_--;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const {
+  ASSERT(bucket_idx < Size(), "index invalid");
+  return local_depths_[bucket_idx];
+}
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  ASSERT(bucket_idx < Size(), "index invalid");
+  ASSERT(local_depth <= global_depth_, "local depth exceeds global depth");
+  local_depths_[bucket_idx] = local_depth;
+}
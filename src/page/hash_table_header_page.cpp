@@ -0,0 +1,28 @@
+#include "page/hash_table_header_page.h"
+
+#include "common/macros.h"
+
+void HashTableHeaderPage::Init(uint32_t max_depth) {
+  ASSERT(max_depth <= HASH_HEADER_MAX_DEPTH, "header depth too large");
+  max_depth_ = max_depth;
+  for (uint32_t i = 0; i < MaxSize(); i++) {
+    directory_page_ids_[i] = INVALID_PAGE_ID;
+  }
+}
+
+/**
+ * The directories use the low bits of a hash, the header takes the high bits
+ */
+uint32_t HashTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const {
+  return max_depth_ == 0 ? 0 : hash >> (32 - max_depth_);
+}
+
+page_id_t HashTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const {
+  ASSERT(directory_idx < MaxSize(), "index invalid");
+  return directory_page_ids_[directory_idx];
+}
+
+void HashTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  ASSERT(directory_idx < MaxSize(), "index invalid");
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
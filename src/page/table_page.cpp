@@ -35,6 +35,7 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
   // Set the tuple.
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
   SetTupleSize(i, serialized_size);
+  SetTupleFormat(i, RowFormat::kCompact);
   // Set rid
   row.SetRowId(RowId(GetTablePageId(), i));
   if (i == GetTupleCount()) {
@@ -82,7 +83,8 @@ UpdateTablePageStatus TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema
   }
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes =
+          old_row->DeserializeFrom(GetData() + tuple_offset, schema, GetTupleFormat(slot_num));
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
@@ -91,6 +93,8 @@ UpdateTablePageStatus TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema
   SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
   new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
   SetTupleSize(slot_num, serialized_size);
+  // the new value is always written in the current format
+  SetTupleFormat(slot_num, RowFormat::kCompact);
 
   // Update all tuple offsets.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -158,11 +162,26 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
+  uint32_t __attribute__((unused)) read_bytes =
+          row->DeserializeFrom(GetData() + tuple_offset, schema, GetTupleFormat(slot_num));
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
   return true;
 }
 
+const char *TablePage::GetTupleData(const RowId &rid, uint32_t *size, RowFormat *format) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return nullptr;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return nullptr;
+  }
+  *size = tuple_size;
+  *format = GetTupleFormat(slot_num);
+  return GetData() + GetTupleOffsetAtSlot(slot_num);
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
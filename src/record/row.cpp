@@ -1,72 +1,57 @@
 #include "record/row.h"
 
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-  uint32_t count = GetFieldCount();
-  // offset record fixed length to write in buf
-  uint32_t offset = 0;
-
-  MACH_WRITE_TO(RowId, buf + offset, GetRowId());
-  offset += sizeof(RowId);
-
-  MACH_WRITE_TO(uint32_t, buf + offset, count);
-  offset += sizeof(uint32_t);
-  
-
-  // offset_field record dynamic length to field write in buf
-  uint32_t offset_field = 0;
-  for(uint32_t i = 0; i < count; i++){
-    Field* f = GetField(i);
-    // null must write the type
-    if(f->IsNull())
-    {
-      MACH_WRITE_TO(bool, buf + offset + i, 1);
-      const TypeId type_id = (*(schema->GetColumn(i))).GetType();
-      // tyep_id for length 4, I optimize it to a char(length 1) for each type
-      if(type_id == kTypeInt)
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '1');
-      }
-      else if (type_id == kTypeFloat)
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '2');
-      }
-      else
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '3');
-      }
-      offset_field += 1;
+  ASSERT(GetFieldCount() == schema->GetColumnCount(), "Fields do not match the schema.");
+  // null bitmap, null fixed values and the offsets start zeroed
+  memset(buf, 0, schema->GetFixedSize());
+  uint32_t offset = schema->GetFixedSize();
+  for (uint32_t i = 0; i < GetFieldCount(); i++) {
+    const Field *field = GetField(i);
+    if (field->IsNull()) {
+      buf[i / 8] |= static_cast<char>(1 << (i % 8));
     }
-    else
-    {
-      MACH_WRITE_TO(bool, buf + offset + i, 0);
-      const TypeId type_id = (*(schema->GetColumn(i))).GetType();
-      if(type_id == kTypeInt)
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '1');
+    if (schema->GetColumn(i)->GetType() == kTypeChar) {
+      if (!field->IsNull()) {
+        memcpy(buf + offset, field->GetData(), field->GetLength());
+        offset += field->GetLength();
       }
-      else if (type_id == kTypeFloat)
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '2');
-      }
-      else
-      {
-        MACH_WRITE_TO(char, buf + offset + count * sizeof(bool) + offset_field, '3');
-      }
-      offset_field += 1;
-      offset_field += (*f).SerializeTo(buf + offset + count * sizeof(bool) + offset_field);
+      MACH_WRITE_TO(uint16_t, buf + schema->GetFieldOffset(i), static_cast<uint16_t>(offset));
+    } else {
+      field->SerializeTo(buf + schema->GetFieldOffset(i));
     }
   }
-  offset = offset + count * sizeof(bool) + offset_field;
   return offset;
 }
 
-uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  uint32_t offset = 0;
+uint32_t Row::DeserializeFrom(char *buf, Schema *schema, RowFormat format) {
+  if (format == RowFormat::kLegacy) {
+    return DeserializeLegacyFrom(buf);
+  }
   fields_.clear();
+  uint32_t offset = schema->GetFixedSize();
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    TypeId type_id = schema->GetColumn(i)->GetType();
+    bool is_null = (buf[i / 8] >> (i % 8)) & 1;
+    Field *field;
+    if (type_id == kTypeChar) {
+      // chars of this column run from the end of the previous char column to its own end
+      uint32_t end = MACH_READ_FROM(uint16_t, buf + schema->GetFieldOffset(i));
+      field = is_null ? ALLOC_P(heap_, Field)(kTypeChar)
+                      : ALLOC_P(heap_, Field)(kTypeChar, buf + offset, end - offset, true);
+      offset = end;
+    } else {
+      Field::DeserializeFrom(buf + schema->GetFieldOffset(i), type_id, &field, is_null, heap_);
+    }
+    fields_.push_back(field);
+  }
+  return offset;
+}
 
-  SetRowId(MACH_READ_FROM(RowId, buf + offset));
+uint32_t Row::DeserializeLegacyFrom(char *buf) {
+  uint32_t offset = 0;
+  fields_.clear();
 
-  // offset record fixed length to read in buf
+  // the stored RowId is not the RowId of the tuple, skip it
   offset += sizeof(RowId);
   uint32_t count = MACH_READ_FROM(uint32_t, buf + offset);
   offset += sizeof(uint32_t);
@@ -105,11 +90,12 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 }
 
 uint32_t Row::GetSerializedSize(Schema *schema) const {
-  uint32_t count = GetFieldCount();
-  uint32_t offset = sizeof(RowId) + sizeof(uint32_t) + count * sizeof(bool);
-  for(size_t i = 0; i < count; i++){
-    Field* f = GetField(i);
-    offset += (*f).GetSerializedSize() + sizeof(char);
+  uint32_t size = schema->GetFixedSize();
+  for (uint32_t i = 0; i < GetFieldCount(); i++) {
+    const Field *field = GetField(i);
+    if (schema->GetColumn(i)->GetType() == kTypeChar && !field->IsNull()) {
+      size += field->GetLength();
+    }
   }
-  return offset;
+  return size;
 }
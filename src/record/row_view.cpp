@@ -0,0 +1,54 @@
+#include "record/row_view.h"
+
+uint32_t RowView::GetLegacyFieldOffset(uint32_t idx) const {
+  uint32_t count = GetFieldCount();
+  ASSERT(idx < count, "Failed to access field");
+  // every field is a one char type tag followed by its data, null fields have no data
+  uint32_t offset = OFFSET_NULLS + count * sizeof(bool);
+  for (uint32_t i = 0; i < idx; i++) {
+    offset += sizeof(char);
+    if (IsNull(i)) {
+      continue;
+    }
+    if (data_[offset - 1] == '3') {
+      offset += sizeof(uint32_t) + MACH_READ_UINT32(data_ + offset);
+    } else {
+      offset += sizeof(int32_t);
+    }
+  }
+  ASSERT(offset < size_, "Field out of the tuple.");
+  return offset + sizeof(char);
+}
+
+int32_t RowView::GetInt(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeInt, "Not an int column.");
+  uint32_t offset = format_ == RowFormat::kCompact ? schema_->GetFieldOffset(idx) : GetLegacyFieldOffset(idx);
+  return MACH_READ_INT32(data_ + offset);
+}
+
+float RowView::GetFloat(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeFloat, "Not a float column.");
+  uint32_t offset = format_ == RowFormat::kCompact ? schema_->GetFieldOffset(idx) : GetLegacyFieldOffset(idx);
+  return MACH_READ_FROM(float, data_ + offset);
+}
+
+std::string_view RowView::GetChars(uint32_t idx) const {
+  ASSERT(schema_->GetColumn(idx)->GetType() == TypeId::kTypeChar, "Not a char column.");
+  if (format_ == RowFormat::kCompact) {
+    // starts where the previous char column ends, the end offsets of the char columns are back to back
+    uint32_t end_offset = schema_->GetFieldOffset(idx);
+    uint32_t end = MACH_READ_FROM(uint16_t, data_ + end_offset);
+    uint32_t begin = end_offset == schema_->GetCharOffsetsBegin()
+                     ? schema_->GetFixedSize()
+                     : MACH_READ_FROM(uint16_t, data_ + end_offset - sizeof(uint16_t));
+    return std::string_view(data_ + begin, end - begin);
+  }
+  uint32_t offset = GetLegacyFieldOffset(idx);
+  return std::string_view(data_ + offset + sizeof(uint32_t), MACH_READ_UINT32(data_ + offset));
+}
+
+void RowView::Materialize(Row *row) const {
+  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(const_cast<char *>(data_), schema_, format_);
+  ASSERT(read_bytes == size_, "Unexpected behavior in tuple deserialize.");
+  row->SetRowId(rid_);
+}
@@ -1,5 +1,26 @@
 #include "record/schema.h"
 
+void Schema::InitRowLayout() {
+  null_bitmap_size_ = (GetColumnCount() + 7) / 8;
+  field_offsets_.resize(GetColumnCount());
+  // fixed width values first, then one end offset per char column
+  uint32_t offset = null_bitmap_size_;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (columns_[i]->GetType() != TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += sizeof(int32_t);
+    }
+  }
+  char_offsets_begin_ = offset;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += sizeof(uint16_t);
+    }
+  }
+  fixed_size_ = offset;
+}
+
 uint32_t Schema::SerializeTo(char *buf) const {
   int32_t offset = 0;
   // write magic_num first
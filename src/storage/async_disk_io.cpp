@@ -0,0 +1,298 @@
+#include "storage/async_disk_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "glog/logging.h"
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define MINISQL_HAVE_IO_URING
+#endif
+#endif
+
+namespace {
+
+/**
+ * Fallback engine: a fixed set of workers issuing blocking pread/pwrite.
+ */
+class ThreadPoolDiskIO : public AsyncDiskIO {
+public:
+  explicit ThreadPoolDiskIO(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back(&ThreadPoolDiskIO::Work, this);
+    }
+  }
+
+  ~ThreadPoolDiskIO() override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Read(int fd, size_t offset, char *buf, size_t len, Callback callback) override {
+    Submit([fd, offset, buf, len, callback] {
+      ssize_t res = pread(fd, buf, len, offset);
+      callback(res < 0 ? -errno : res);
+    });
+  }
+
+  void Write(int fd, size_t offset, const char *buf, size_t len, Callback callback) override {
+    Submit([fd, offset, buf, len, callback] {
+      ssize_t res = pwrite(fd, buf, len, offset);
+      callback(res < 0 ? -errno : res);
+    });
+  }
+
+  const char *GetName() const override { return "thread pool"; }
+
+private:
+  void Submit(std::function<void()> task) {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      // drain the queue before stopping, callers may be waiting on these requests
+      if (tasks_.empty()) {
+        break;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+#ifdef MINISQL_HAVE_IO_URING
+/**
+ * io_uring engine driven by raw syscalls, so no liburing is needed.
+ * Submitters fill the submission ring under a latch, a reaper thread waits on the completion ring and runs callbacks.
+ */
+class IoUringDiskIO : public AsyncDiskIO {
+public:
+  /**
+   * @return nullptr if the kernel (or a seccomp policy) does not allow io_uring
+   */
+  static IoUringDiskIO *Create(size_t queue_depth) {
+    auto *io = new IoUringDiskIO();
+    if (!io->Init(static_cast<unsigned>(queue_depth))) {
+      delete io;
+      return nullptr;
+    }
+    io->reaper_ = std::thread(&IoUringDiskIO::Reap, io);
+    return io;
+  }
+
+  ~IoUringDiskIO() override {
+    if (reaper_.joinable()) {
+      {
+        std::scoped_lock<std::mutex> lock(latch_);
+        stop_ = true;
+      }
+      // a no-op request wakes the reaper up
+      Submit(IORING_OP_NOP, -1, 0, nullptr);
+      reaper_.join();
+    }
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, entries_ * sizeof(io_uring_sqe));
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  void Read(int fd, size_t offset, char *buf, size_t len, Callback callback) override {
+    auto *request = new Request{std::move(callback), {buf, len}};
+    Submit(IORING_OP_READV, fd, offset, request);
+  }
+
+  void Write(int fd, size_t offset, const char *buf, size_t len, Callback callback) override {
+    auto *request = new Request{std::move(callback), {const_cast<char *>(buf), len}};
+    Submit(IORING_OP_WRITEV, fd, offset, request);
+  }
+
+  const char *GetName() const override { return "io_uring"; }
+
+private:
+  struct Request {
+    Callback callback_;
+    iovec iov_;
+  };
+
+  IoUringDiskIO() = default;
+
+  bool Init(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      return false;
+    }
+    entries_ = params.sq_entries;
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                  IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      return false;
+    }
+    sqes_ = mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 ring_fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return false;
+    }
+    auto *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  void Submit(uint8_t opcode, int fd, size_t offset, Request *request) {
+    std::unique_lock<std::mutex> lock(latch_);
+    // the completion ring holds twice the submission entries, bounding in flight requests keeps it from overflowing
+    cv_.wait(lock, [this] { return in_flight_ < entries_; });
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = offset;
+    if (request != nullptr) {
+      sqe->addr = reinterpret_cast<uint64_t>(&request->iov_);
+      sqe->len = 1;
+    }
+    sqe->user_data = reinterpret_cast<uint64_t>(request);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    in_flight_++;
+    int res;
+    do {
+      res = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0));
+    } while (res < 0 && errno == EINTR);
+    if (res < 0) {
+      LOG(ERROR) << "io_uring submission failed: " << errno;
+    }
+  }
+
+  void Reap() {
+    while (true) {
+      int res = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (res < 0 && errno != EINTR) {
+        LOG(ERROR) << "io_uring wait failed: " << errno;
+      }
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      size_t completed = 0;
+      while (head != tail) {
+        io_uring_cqe cqe = cqes_[head & cq_mask_];
+        head++;
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        auto *request = reinterpret_cast<Request *>(cqe.user_data);
+        if (request != nullptr) {
+          request->callback_(cqe.res);
+          delete request;
+        }
+        completed++;
+      }
+      std::scoped_lock<std::mutex> lock(latch_);
+      in_flight_ -= completed;
+      if (completed > 0) {
+        cv_.notify_all();
+      }
+      if (stop_ && in_flight_ == 0) {
+        break;
+      }
+    }
+  }
+
+private:
+  int ring_fd_{-1};
+  unsigned entries_{0};
+  void *sq_ring_{MAP_FAILED};
+  void *cq_ring_{MAP_FAILED};
+  void *sqes_{MAP_FAILED};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+  std::thread reaper_;
+  std::mutex latch_;                   // protects the submission ring, in_flight_ and stop_
+  std::condition_variable cv_;
+  size_t in_flight_{0};
+  bool stop_{false};
+};
+#endif
+
+}  // namespace
+
+AsyncDiskIO *AsyncDiskIO::Create(size_t queue_depth, size_t num_threads, bool allow_io_uring) {
+#ifdef MINISQL_HAVE_IO_URING
+  if (allow_io_uring) {
+    AsyncDiskIO *io = IoUringDiskIO::Create(queue_depth);
+    if (io != nullptr) {
+      return io;
+    }
+  }
+#endif
+  return new ThreadPoolDiskIO(num_threads);
+}
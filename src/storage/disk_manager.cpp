@@ -1,13 +1,30 @@
+#include <cerrno>
+#include <fcntl.h>
 #include <stdexcept>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "storage/disk_manager.h"
 
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, DiskBackend backend) : backend_(backend), file_name_(db_file) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (backend_ == DiskBackend::kPosix) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (db_fd_ < 0) {
+      throw std::exception();
+    }
+    struct stat stat_buf;
+    if (fstat(db_fd_, &stat_buf) != 0) {
+      throw std::exception();
+    }
+    file_size_ = static_cast<size_t>(stat_buf.st_size);
+    ReadPhysicalPage(META_PAGE_ID, meta_data_);
+    LoadMetaPages();
+    return;
+  }
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
   if (!db_io_.is_open()) {
@@ -22,123 +39,293 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  LoadMetaPages();
 }
 
+void DiskManager::Sync() {
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  if (closed) {
+    return;
+  }
+  WriteBitmapPages();
+  WriteMetaPages();
+  if (backend_ == DiskBackend::kPosix) {
+    if (fdatasync(db_fd_) != 0) {
+      LOG(ERROR) << "I/O error while syncing";
+    }
+  } else {
+    db_io_.flush();
+  }
+}
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
-    db_io_.close();
+    // waits for asynchronous requests in flight
+    delete async_io_.exchange(nullptr);
+    Sync();
+    if (backend_ == DiskBackend::kPosix) {
+      close(db_fd_);
+      db_fd_ = -1;
+    } else {
+      db_io_.close();
+    }
     closed = true;
   }
 }
 
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (backend_ == DiskBackend::kPosix) {
+    // positioned reads do not share a cursor, no latch needed
+    ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+    return;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (backend_ == DiskBackend::kPosix) {
+    WritePhysicalPage(MapPageId(logical_page_id), page_data);
+    return;
+  }
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
+void DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data, std::function<void()> callback) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  if (backend_ != DiskBackend::kPosix || offset >= file_size_.load()) {
+    ReadPage(logical_page_id, page_data);
+    callback();
+    return;
+  }
+  GetAsyncIO()->Read(db_fd_, offset, page_data, PAGE_SIZE, [this, offset, page_data, callback](ssize_t res) {
+    if (res != PAGE_SIZE) {
+      // error or short read, the synchronous path retries and zero fills past the end of file
+      ReadPhysicalPagePosix(offset, page_data);
+    }
+    callback();
+  });
+}
+
+std::future<void> DiskManager::ReadPageAsync(page_id_t logical_page_id, char *page_data) {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  ReadPageAsync(logical_page_id, page_data, [promise] { promise->set_value(); });
+  return future;
+}
+
+void DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data, std::function<void()> callback) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  if (backend_ != DiskBackend::kPosix) {
+    WritePage(logical_page_id, page_data);
+    callback();
+    return;
+  }
+  size_t offset = static_cast<size_t>(MapPageId(logical_page_id)) * PAGE_SIZE;
+  GetAsyncIO()->Write(db_fd_, offset, page_data, PAGE_SIZE, [this, offset, page_data, callback](ssize_t res) {
+    if (res != PAGE_SIZE) {
+      WritePhysicalPagePosix(offset, page_data);
+    } else {
+      ExtendFileSize(offset + PAGE_SIZE);
+    }
+    callback();
+  });
+}
+
+std::future<void> DiskManager::WritePageAsync(page_id_t logical_page_id, const char *page_data) {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  WritePageAsync(logical_page_id, page_data, [promise] { promise->set_value(); });
+  return future;
+}
+
+const char *DiskManager::GetAsyncIOName() {
+  return backend_ == DiskBackend::kPosix ? GetAsyncIO()->GetName() : "synchronous";
+}
+
+AsyncDiskIO *DiskManager::GetAsyncIO() {
+  AsyncDiskIO *async_io = async_io_.load();
+  if (async_io == nullptr) {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    async_io = async_io_.load();
+    if (async_io == nullptr) {
+      async_io = AsyncDiskIO::Create(ASYNC_IO_QUEUE_DEPTH, ASYNC_IO_THREADS);
+      async_io_ = async_io;
+    }
+  }
+  return async_io;
+}
+
 page_id_t DiskManager::AllocatePage() {
-  page_id_t logical_id = 0;
-  //get disk information from the meta_data_
-  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_); 
-  uint32_t extent_id = 0;
-  for(uint32_t i = 0 ; i < MAX_EXTENT;i++){
-    if(meta_page->extent_used_page_[i] < BITMAP_SIZE){
-      //record we get a new page from this extent
-      meta_page->extent_used_page_[i]++;
-      meta_page->num_allocated_pages_++;
-      extent_id = i;
-      break;
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (free_extents_.empty()) {
+    // every extent is full, append a new one
+    uint32_t extent_id = meta_page->num_extents_++;
+    uint32_t group_id = extent_id / DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+    if (group_id > 0) {
+      if (extent_id % DiskFileMetaPage::EXTENTS_PER_META_PAGE == 0) {
+        group_meta_data_.emplace_back(new char[PAGE_SIZE]());
+      }
+      GetMetaPage(group_id)->num_extents_++;
     }
-  }meta_page->num_extents_ = extent_id+1;
-  char temp_char[PAGE_SIZE];  
-  if(meta_page->extent_used_page_[extent_id] == 0){//means this new extent don't have a bitmap
-    //create a bitmap_page
-    memset(temp_char, 0, PAGE_SIZE);
-    WritePhysicalPage(extent_id*(BITMAP_SIZE+1)+1,temp_char);   
-  }
-  //read bitmap page  
-  ReadPhysicalPage(extent_id*(BITMAP_SIZE+1)+1,temp_char);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(temp_char);
-  uint32_t index ;
-  bitmap_page->AllocatePage(index);
-  logical_id = extent_id*BITMAP_SIZE + index;
-  //write bitmap page
-  memcpy(temp_char,bitmap_page,PAGE_SIZE);
-  WritePhysicalPage(1 + extent_id*(BITMAP_SIZE + 1), temp_char);
-  //store meta_page
-  memcpy(meta_data_,meta_page,PAGE_SIZE);
-  return logical_id;
+    // the bitmap of a new extent starts empty in memory, it reaches the disk on the next Sync
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
+    bitmaps_[extent_id].reset(new char[PAGE_SIZE]());
+    bitmap_dirty_[extent_id] = true;
+    free_extents_.push_back(extent_id);
+  }
+  uint32_t extent_id = free_extents_.back();
+  uint32_t index;
+  if (!GetBitmapPage(extent_id)->AllocatePage(index)) {
+    ASSERT(false, "Extent bitmap is full but meta page says otherwise.");
+  }
+  bitmap_dirty_[extent_id] = true;
+  //record we get a new page from this extent
+  uint32_t &used = ExtentUsedPage(extent_id);
+  used++;
+  meta_page->num_allocated_pages_++;
+  uint32_t group_id = extent_id / DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+  if (group_id > 0) {
+    GetMetaPage(group_id)->num_allocated_pages_++;
+  }
+  if (used == BITMAP_SIZE) {
+    free_extents_.pop_back();
+  }
+  return extent_id * BITMAP_SIZE + index;
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  page_id_t physical_page_id = MapPageId(logical_page_id);
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   //calculate the place of this page
   uint32_t extent_id = logical_page_id / BITMAP_SIZE ,index = logical_page_id % BITMAP_SIZE ;
-  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_); 
-  if(meta_page->extent_used_page_[extent_id] > 0){
-    //record one page will be moved from this extent
-    meta_page->extent_used_page_[extent_id]-- ;
-    meta_page->num_allocated_pages_--;    
-  }else{
-    return ;
-  }
-  //make thiis page empty
-  char page_data[PAGE_SIZE];
-  memset(page_data, 0, PAGE_SIZE);
-  WritePhysicalPage(physical_page_id,page_data);
-  //read bitmap page  
-  char temp_char[PAGE_SIZE];
-  ReadPhysicalPage(1 + extent_id*(BITMAP_SIZE + 1),temp_char);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(temp_char);  
-  bitmap_page->DeAllocatePage(index);
-  //write bitmap page
-  memcpy(temp_char,bitmap_page,PAGE_SIZE);
-  WritePhysicalPage(1 + extent_id*(BITMAP_SIZE + 1), temp_char);
-  //store meta_page
-  memcpy(meta_data_,meta_page,PAGE_SIZE);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (extent_id >= meta_page->num_extents_ || ExtentUsedPage(extent_id) == 0) {
+    return;
+  }
+  // the page content is left as is, a reallocated page is reset by the buffer pool anyway
+  if (!GetBitmapPage(extent_id)->DeAllocatePage(index)) {
+    // already free
+    return;
+  }
+  bitmap_dirty_[extent_id] = true;
+  //record one page will be moved from this extent
+  uint32_t &used = ExtentUsedPage(extent_id);
+  if (used == BITMAP_SIZE) {
+    free_extents_.push_back(extent_id);
+  }
+  used--;
+  meta_page->num_allocated_pages_--;
+  uint32_t group_id = extent_id / DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+  if (group_id > 0) {
+    GetMetaPage(group_id)->num_allocated_pages_--;
+  }
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  char page_data[PAGE_SIZE];
-  uint32_t extent_id = logical_page_id / BITMAP_SIZE, index = logical_page_id % BITMAP_SIZE ;;
-  if(extent_id > MAX_EXTENT){//over range
-    printf("Extent_nums: over the range ");
-    return false;
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE, index = logical_page_id % BITMAP_SIZE;
+  if (extent_id >= reinterpret_cast<DiskFileMetaPage *>(meta_data_)->num_extents_) {
+    // extent not created yet
+    return true;
+  }
+  return GetBitmapPage(extent_id)->IsPageFree(index);
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetBitmapPage(uint32_t extent_id) {
+  if (bitmaps_.size() <= extent_id) {
+    bitmaps_.resize(extent_id + 1);
+    bitmap_dirty_.resize(extent_id + 1, false);
   }
-  //read bitmap page  
-  ReadPhysicalPage(1 + extent_id*(BITMAP_SIZE + 1), page_data);
-  BitmapPage<PAGE_SIZE> *bitmap_page = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(page_data);
+  if (bitmaps_[extent_id] == nullptr) {
+    bitmaps_[extent_id].reset(new char[PAGE_SIZE]);
+    ReadPhysicalPage(MapBitmapPageId(extent_id), bitmaps_[extent_id].get());
+  }
+  return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmaps_[extent_id].get());
+}
 
-  return bitmap_page->IsPageFree(index);
+void DiskManager::WriteBitmapPages() {
+  for (uint32_t extent_id = 0; extent_id < bitmaps_.size(); extent_id++) {
+    if (bitmap_dirty_[extent_id]) {
+      WritePhysicalPage(MapBitmapPageId(extent_id), bitmaps_[extent_id].get());
+      bitmap_dirty_[extent_id] = false;
+    }
+  }
 }
 
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-  page_id_t physical_page_id = 0;
-  uint32_t extent_id = logical_page_id / BITMAP_SIZE ;
-  uint32_t index = logical_page_id % BITMAP_SIZE ;
-  physical_page_id = extent_id*(BITMAP_SIZE + 1) + index + 2;
+  uint32_t extent_id = logical_page_id / BITMAP_SIZE;
+  uint32_t index = logical_page_id % BITMAP_SIZE;
+  // data pages follow the bitmap page of their extent
+  return MapBitmapPageId(extent_id) + 1 + index;
+}
+
+page_id_t DiskManager::MapBitmapPageId(uint32_t extent_id) {
+  uint32_t group_id = extent_id / DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+  uint32_t extent_index = extent_id % DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+  return MapMetaPageId(group_id) + 1 + extent_index * (BITMAP_SIZE + 1);
+}
 
-  return physical_page_id;
-  
+page_id_t DiskManager::MapMetaPageId(uint32_t group_id) {
+  // a group is its meta page followed by EXTENTS_PER_META_PAGE extents, group 0 starts at META_PAGE_ID
+  return META_PAGE_ID + group_id * (DiskFileMetaPage::EXTENTS_PER_META_PAGE * (BITMAP_SIZE + 1) + 1);
+}
+
+DiskFileMetaPage *DiskManager::GetMetaPage(uint32_t group_id) {
+  if (group_id == 0) {
+    return reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  }
+  return reinterpret_cast<DiskFileMetaPage *>(group_meta_data_[group_id - 1].get());
+}
+
+uint32_t &DiskManager::ExtentUsedPage(uint32_t extent_id) {
+  return GetMetaPage(extent_id / DiskFileMetaPage::EXTENTS_PER_META_PAGE)
+      ->extent_used_page_[extent_id % DiskFileMetaPage::EXTENTS_PER_META_PAGE];
+}
+
+void DiskManager::LoadMetaPages() {
+  uint32_t num_extents = reinterpret_cast<DiskFileMetaPage *>(meta_data_)->num_extents_;
+  uint32_t num_groups =
+      (num_extents + DiskFileMetaPage::EXTENTS_PER_META_PAGE - 1) / DiskFileMetaPage::EXTENTS_PER_META_PAGE;
+  for (uint32_t group_id = 1; group_id < num_groups; group_id++) {
+    group_meta_data_.emplace_back(new char[PAGE_SIZE]);
+    ReadPhysicalPage(MapMetaPageId(group_id), group_meta_data_.back().get());
+  }
+  // lowest extents on top of the stack, so the file is filled from the front
+  for (uint32_t extent_id = num_extents; extent_id > 0; extent_id--) {
+    if (ExtentUsedPage(extent_id - 1) < BITMAP_SIZE) {
+      free_extents_.push_back(extent_id - 1);
+    }
+  }
+}
+
+void DiskManager::WriteMetaPages() {
+  WritePhysicalPage(META_PAGE_ID, meta_data_);
+  for (uint32_t group_id = 1; group_id <= group_meta_data_.size(); group_id++) {
+    WritePhysicalPage(MapMetaPageId(group_id), group_meta_data_[group_id - 1].get());
+  }
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  if (backend_ == DiskBackend::kPosix) {
+    ReadPhysicalPagePosix(offset, page_data);
+    return;
+  }
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
+  if (static_cast<int64_t>(offset) >= GetFileSize(file_name_)) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
@@ -160,6 +347,10 @@ void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data)
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  if (backend_ == DiskBackend::kPosix) {
+    WritePhysicalPagePosix(offset, page_data);
+    return;
+  }
   // set write cursor to offset
   db_io_.seekp(offset);
   db_io_.write(page_data, PAGE_SIZE);
@@ -172,6 +363,56 @@ void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page
   db_io_.flush();
 }
 
+void DiskManager::ReadPhysicalPagePosix(size_t offset, char *page_data) {
+  // the cached size saves a stat() per read; pages past the end of file read as zeros
+  if (offset >= file_size_.load()) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  size_t read_count = 0;
+  while (read_count < PAGE_SIZE) {
+    ssize_t res = pread(db_fd_, page_data + read_count, PAGE_SIZE - read_count, offset + read_count);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res < 0) {
+      LOG(ERROR) << "I/O error while reading";
+    }
+    if (res <= 0) {
+      break;
+    }
+    read_count += res;
+  }
+  if (read_count < PAGE_SIZE) {
+#ifdef ENABLE_BPM_DEBUG
+    LOG(INFO) << "Read less than a page" << std::endl;
+#endif
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  }
+}
+
+void DiskManager::WritePhysicalPagePosix(size_t offset, const char *page_data) {
+  size_t write_count = 0;
+  while (write_count < PAGE_SIZE) {
+    ssize_t res = pwrite(db_fd_, page_data + write_count, PAGE_SIZE - write_count, offset + write_count);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      LOG(ERROR) << "I/O error while writing";
+      return;
+    }
+    write_count += res;
+  }
+  ExtendFileSize(offset + PAGE_SIZE);
+}
+
+void DiskManager::ExtendFileSize(size_t end) {
+  // concurrent writers may race here, keep the largest end
+  size_t file_size = file_size_.load();
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
+  }
+}
 
 char *DiskManager::GetMetaData() {
   return meta_data_;
@@ -0,0 +1,160 @@
+#include "storage/free_space_map.h"
+
+#include <algorithm>
+
+bool FreeSpaceMap::Init() {
+  std::lock_guard<std::mutex> lock(latch_);
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  map_pages_.push_back(page_id);
+  return true;
+}
+
+void FreeSpaceMap::Load(page_id_t first_page_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  page_id_t page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    map_pages_.push_back(page_id);
+    for (uint32_t i = 0; i < page->GetEntryCount(); i++) {
+      Append(page->GetHeapPageId(i), page->GetFreeBytes(i));
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+bool FreeSpaceMap::AddPage(page_id_t heap_page_id, uint32_t free_bytes) {
+  std::lock_guard<std::mutex> lock(latch_);
+  ASSERT(!map_pages_.empty(), "Free space map is not initialized.");
+  page_id_t last_page_id = map_pages_.back();
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(last_page_id)->GetData());
+  if (!page->Append(heap_page_id, free_bytes)) {
+    // the last map page is full, chain a new one
+    page_id_t new_page_id;
+    Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+      return false;
+    }
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    page = reinterpret_cast<FreeSpaceMapPage *>(new_page->GetData());
+    page->Init();
+    page->Append(heap_page_id, free_bytes);
+    map_pages_.push_back(new_page_id);
+    last_page_id = new_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  Append(heap_page_id, free_bytes);
+  return true;
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t heap_page_id, uint32_t free_bytes) {
+  std::lock_guard<std::mutex> lock(latch_);
+  auto it = page_index_.find(heap_page_id);
+  if (it == page_index_.end()) {
+    return;
+  }
+  uint32_t index = it->second;
+  SetTreeValue(index, free_bytes);
+  if (free_bytes / PERSIST_GRANULARITY != persisted_free_bytes_[index] / PERSIST_GRANULARITY) {
+    Persist(index, free_bytes);
+  }
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t required) const {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (heap_pages_.empty() || max_tree_[1] < required) {
+    return INVALID_PAGE_ID;
+  }
+  // descend to the leftmost leaf with enough room
+  uint32_t node = 1;
+  while (node < capacity_) {
+    node = max_tree_[2 * node] >= required ? 2 * node : 2 * node + 1;
+  }
+  return heap_pages_[node - capacity_];
+}
+
+uint32_t FreeSpaceMap::GetFreeBytes(page_id_t heap_page_id) const {
+  std::lock_guard<std::mutex> lock(latch_);
+  auto it = page_index_.find(heap_page_id);
+  if (it == page_index_.end()) {
+    return 0;
+  }
+  return max_tree_[capacity_ + it->second];
+}
+
+int FreeSpaceMap::GetPageIndex(page_id_t heap_page_id) const {
+  std::lock_guard<std::mutex> lock(latch_);
+  auto it = page_index_.find(heap_page_id);
+  return it == page_index_.end() ? -1 : static_cast<int>(it->second);
+}
+
+page_id_t FreeSpaceMap::GetFirstPageId() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return map_pages_.empty() ? INVALID_PAGE_ID : map_pages_.front();
+}
+
+page_id_t FreeSpaceMap::GetLastHeapPageId() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return heap_pages_.empty() ? INVALID_PAGE_ID : heap_pages_.back();
+}
+
+size_t FreeSpaceMap::GetHeapPageCount() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return heap_pages_.size();
+}
+
+page_id_t FreeSpaceMap::GetHeapPage(size_t index) const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return heap_pages_[index];
+}
+
+std::vector<page_id_t> FreeSpaceMap::GetHeapPages() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return heap_pages_;
+}
+
+void FreeSpaceMap::Append(page_id_t heap_page_id, uint32_t free_bytes) {
+  uint32_t index = heap_pages_.size();
+  if (index == capacity_) {
+    // grow the tree and rebuild it from the old leaves
+    uint32_t new_capacity = capacity_ == 0 ? 16 : capacity_ * 2;
+    std::vector<uint32_t> new_tree(2 * new_capacity, 0);
+    for (uint32_t i = 0; i < index; i++) {
+      new_tree[new_capacity + i] = max_tree_[capacity_ + i];
+    }
+    for (uint32_t node = new_capacity - 1; node > 0; node--) {
+      new_tree[node] = std::max(new_tree[2 * node], new_tree[2 * node + 1]);
+    }
+    max_tree_.swap(new_tree);
+    capacity_ = new_capacity;
+  }
+  heap_pages_.push_back(heap_page_id);
+  persisted_free_bytes_.push_back(free_bytes);
+  page_index_[heap_page_id] = index;
+  SetTreeValue(index, free_bytes);
+}
+
+void FreeSpaceMap::SetTreeValue(uint32_t index, uint32_t free_bytes) {
+  uint32_t node = capacity_ + index;
+  max_tree_[node] = free_bytes;
+  for (node /= 2; node > 0; node /= 2) {
+    max_tree_[node] = std::max(max_tree_[2 * node], max_tree_[2 * node + 1]);
+  }
+}
+
+void FreeSpaceMap::Persist(uint32_t index, uint32_t free_bytes) {
+  page_id_t page_id = map_pages_[index / FreeSpaceMapPage::MAX_ENTRY_COUNT];
+  auto page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  page->SetFreeBytes(index % FreeSpaceMapPage::MAX_ENTRY_COUNT, free_bytes);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  persisted_free_bytes_[index] = free_bytes;
+}
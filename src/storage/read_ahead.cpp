@@ -0,0 +1,21 @@
+#include "storage/read_ahead.h"
+
+#include <algorithm>
+
+void ReadAhead::Access(size_t page_index) {
+  if (last_page_index_ >= 0 && page_index == static_cast<size_t>(last_page_index_) + 1) {
+    // pages read too far ahead would only evict each other in a small pool
+    size_t max_window = std::min(READ_AHEAD_MAX_PAGES, buffer_pool_manager_->GetPoolSize() / 4);
+    window_ = std::min(window_ * 2, std::max(max_window, READ_AHEAD_INITIAL_PAGES));
+  } else {
+    window_ = READ_AHEAD_INITIAL_PAGES;
+    prefetched_end_ = page_index + 1;
+  }
+  last_page_index_ = static_cast<int>(page_index);
+  size_t begin = std::max(prefetched_end_, page_index + 1);
+  size_t end = std::min(page_index + 1 + window_, free_space_map_->GetHeapPageCount());
+  for (size_t i = begin; i < end; i++) {
+    buffer_pool_manager_->PrefetchPage(free_space_map_->GetHeapPage(i));
+  }
+  prefetched_end_ = std::max(prefetched_end_, end);
+}
@@ -1,60 +1,80 @@
 #include "storage/table_heap.h"
 #include "glog/logging.h"
 
-bool TableHeap::InsertTuple(Row& row, Transaction* txn) {
-  // start from the first page
+TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                     page_id_t free_space_map_page_id, Schema *schema, LogManager *log_manager,
+                     LockManager *lock_manager)
+        : buffer_pool_manager_(buffer_pool_manager),
+          first_page_id_(first_page_id),
+          schema_(schema),
+          log_manager_(log_manager),
+          lock_manager_(lock_manager),
+          free_space_map_(buffer_pool_manager) {
+  if (free_space_map_page_id != INVALID_PAGE_ID) {
+    free_space_map_.Load(free_space_map_page_id);
+    return;
+  }
+  // no persisted map (heap created before free space maps existed), rebuild it by walking the chain once
+  free_space_map_.Init();
   page_id_t page_id = first_page_id_;
-  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
-  if (page == nullptr) {
-    return false;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    free_space_map_.AddPage(page_id, page->GetFreeSpaceRemaining());
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
   }
-  page->WLatch();
-  // f record the result of the insert
-  bool f = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  if (f == true) {
-    return true;
+}
+
+bool TableHeap::InsertTuple(Row& row, Transaction* txn) {
+  uint32_t serialized_size = row.GetSerializedSize(schema_);
+  if (serialized_size > TablePage::SIZE_MAX_ROW) {
+    return false;
   }
-  else {
-    // judge whether existed page have space to insert
-    while (page->GetNextPageId() != -1) {
-      page_id = page->GetNextPageId();
-      page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
-      if (page == nullptr) {
-        return false;
-      }
-      page->WLatch();
-      bool f = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-      page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-      if (f == true) {
-        return true;
-      }
-    }
-    // no space int all existed pages
-    page_id_t pre_id = page_id;
-    // make a new page as next page
-    page = reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(page_id));
-    page->Init(page_id, pre_id, log_manager_, txn);
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-    // update the pre_page
-    page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(pre_id));
-    page->WLatch();
-    page->SetNextPageId(page_id);
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  uint32_t required = serialized_size + TablePage::SIZE_TUPLE;
+  // go straight to the first page the free space map believes has room
+  page_id_t page_id;
+  while ((page_id = free_space_map_.FindPage(required)) != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
     if (page == nullptr) {
       return false;
     }
-    // insert the tuple into the new page
-    page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
     page->WLatch();
-    f = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    bool f = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    // the map is approximate, correct it with what the page really has left
+    free_space_map_.UpdatePage(page_id, page->GetFreeSpaceRemaining());
     page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-    return f;
+    buffer_pool_manager_->UnpinPage(page_id, f);
+    if (f == true) {
+      return true;
+    }
+  }
+  // no space in all existed pages, make a new page after the last one
+  std::lock_guard<std::mutex> lock(append_latch_);
+  page_id_t pre_id = free_space_map_.GetLastHeapPageId();
+  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(page_id));
+  if (page == nullptr) {
+    return false;
   }
+  page->WLatch();
+  page->Init(page_id, pre_id, log_manager_, txn);
+  bool f = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_bytes = page->GetFreeSpaceRemaining();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  // update the pre_page
+  auto pre_page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(pre_id));
+  if (pre_page == nullptr) {
+    return false;
+  }
+  pre_page->WLatch();
+  pre_page->SetNextPageId(page_id);
+  pre_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(pre_id, true);
+  free_space_map_.AddPage(page_id, free_bytes);
+  return f;
 }
 
 bool TableHeap::MarkDelete(const RowId& rid, Transaction* txn) {
@@ -81,16 +101,14 @@ bool TableHeap::UpdateTuple(Row& row, const RowId& rid, Transaction* txn) {
   Row old_row(rid);
   page->WLatch();
   UpdateTablePageStatus f = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
+  free_space_map_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
   if (f == UpdateTablePageStatus::completed) // update success
     return true;
   else if (f == UpdateTablePageStatus::too_much_data) { // new data is too much
-    page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-    page->WLatch();
-    page->ApplyDelete(rid, txn, log_manager_); // delete old record
-    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true); // insert new record
-    return InsertTuple(row, txn);
+    ApplyDelete(rid, txn); // delete old record
+    return InsertTuple(row, txn); // insert new record
   }
   else
     return false;
@@ -103,6 +121,7 @@ void TableHeap::ApplyDelete(const RowId& rid, Transaction* txn) {
   // Step2: Delete the tuple from the page.
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
+  free_space_map_.UpdatePage(rid.GetPageId(), page->GetFreeSpaceRemaining());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
   // buffer_pool_manager_->DeletePage(page->GetTablePageId());
@@ -131,26 +150,85 @@ bool TableHeap::GetTuple(Row* row, Transaction* txn) {
     return false;
   }
   bool f;
-  page->WLatch();
+  page->RLatch();
   f = page->GetTuple(row, schema_, txn, lock_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
   return f;
 }
 
+bool TableHeap::ScanPage(page_id_t page_id, const std::function<void(Row &)> &callback, Transaction* txn) {
+  return ScanPageViews(page_id, [&callback](const RowView &view) {
+    Row row(view.GetRowId());
+    view.Materialize(&row);
+    callback(row);
+  }, txn);
+}
+
+bool TableHeap::ScanPageViews(page_id_t page_id, const std::function<void(const RowView &)> &callback,
+                              Transaction* txn) {
+  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  page->RLatch();
+  RowId rid;
+  bool found = page->GetFirstTupleRid(&rid);
+  while (found) {
+    uint32_t size;
+    RowFormat format;
+    const char *data = page->GetTupleData(rid, &size, &format);
+    callback(RowView(data, size, format, schema_, rid));
+    RowId next_rid;
+    found = page->GetNextTupleRid(rid, &next_rid);
+    rid = next_rid;
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return true;
+}
+
+bool TableHeap::GetTupleView(const RowId &rid, const std::function<void(const RowView &)> &callback) {
+  page_id_t page_id = rid.GetPageId();
+  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return false;
+  }
+  page->RLatch();
+  uint32_t size;
+  RowFormat format;
+  const char *data = page->GetTupleData(rid, &size, &format);
+  if (data != nullptr) {
+    callback(RowView(data, size, format, schema_, rid));
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return data != nullptr;
+}
+
 TableIterator TableHeap::Begin(Transaction* txn) {
-  // iterator point to first_page_id_'s first row
-  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(first_page_id_));
-  auto rid = new RowId();
-  page->WLatch();
-  page->GetFirstTupleRid(rid);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return TableIterator(this, Row(*rid));
+  // iterator point to the first row of the first page that has one
+  RowId rid;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    bool found = page->GetFirstTupleRid(&rid);
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (found) {
+      break;
+    }
+    page_id = next_page_id;
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    return End();
+  }
+  return TableIterator(this, Row(rid));
 }
 
 TableIterator TableHeap::End() {
   // iterator point to invalid row
-  auto rid = new RowId(INVALID_ROWID);
-  return TableIterator(this, Row(*rid));
+  return TableIterator(this, Row(INVALID_ROWID));
 }
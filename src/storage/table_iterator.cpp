@@ -1,17 +1,23 @@
 #include "storage/table_iterator.h"
+
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "storage/table_heap.h"
 
-TableIterator::TableIterator(TableHeap* table_heap, Row row) : table_heap_(table_heap) {
+TableIterator::TableIterator(TableHeap* table_heap, Row row)
+        : table_heap_(table_heap), read_ahead_(table_heap->NewReadAhead()) {
   row_ = new Row(row.GetRowId());
+  if (row_->GetRowId().GetPageId() != INVALID_PAGE_ID) {
+    ReadAheadFrom(row_->GetRowId().GetPageId());
+  }
 }
 
-TableIterator::TableIterator(const TableIterator& other) : table_heap_(other.table_heap_) {
+TableIterator::TableIterator(const TableIterator& other)
+        : table_heap_(other.table_heap_), read_ahead_(other.read_ahead_) {
   row_ = new Row(other.row_->GetRowId());
 }
 
-TableIterator::~TableIterator() {}
+TableIterator::~TableIterator() { delete row_; }
 
 bool TableIterator::operator==(const TableIterator& itr) const {
   if (table_heap_ == itr.table_heap_ && row_->GetRowId() == itr.row_->GetRowId())
@@ -26,34 +32,45 @@ const Row& TableIterator::operator*() { return *row_; }
 Row* TableIterator::operator->() { return row_; }
 
 TableIterator& TableIterator::operator++() {
+  BufferPoolManager* buffer_pool_manager = table_heap_->buffer_pool_manager_;
   // 1. Try to get next tuple
   RowId cur_rid = row_->GetRowId();
-  RowId* next_rid = new RowId();
-  TablePage* page = reinterpret_cast<TablePage*>(table_heap_->buffer_pool_manager_->FetchPage(cur_rid.GetPageId()));
-  page->WLatch();
-  page->GetNextTupleRid(cur_rid, next_rid);
-  page->WUnlatch();
-  table_heap_->buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-
-  // 2. If that page is iterate over, fetch next page, unpin this page
-  if (next_rid->GetPageId() == INVALID_PAGE_ID) {
-    auto next_page_id = page->GetNextPageId();
+  RowId next_rid;
+  TablePage* page = reinterpret_cast<TablePage*>(buffer_pool_manager->FetchPage(cur_rid.GetPageId()));
+  page->RLatch();
+  page->GetNextTupleRid(cur_rid, &next_rid);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(cur_rid.GetPageId(), false);
+
+  // 2. If that page is iterate over, move on to the next page that has a tuple
+  while (next_rid.GetPageId() == INVALID_PAGE_ID) {
     // If no more page, point to invalid row, then return
-    if (next_page_id == INVALID_FRAME_ID) {
+    if (next_page_id == INVALID_PAGE_ID) {
       row_->SetRowId(INVALID_ROWID);
       return *this;
     }
-    auto next_page = reinterpret_cast<TablePage*>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
-    next_page->WLatch();
-    next_page->GetFirstTupleRid(next_rid);
-    next_page->WUnlatch();
-    table_heap_->buffer_pool_manager_->UnpinPage(next_page->GetTablePageId(), true);
+    ReadAheadFrom(next_page_id);
+    auto next_page = reinterpret_cast<TablePage*>(buffer_pool_manager->FetchPage(next_page_id));
+    next_page->RLatch();
+    next_page->GetFirstTupleRid(&next_rid);
+    page_id_t following_page_id = next_page->GetNextPageId();
+    next_page->RUnlatch();
+    buffer_pool_manager->UnpinPage(next_page_id, false);
+    next_page_id = following_page_id;
   }
 
-  row_->SetRowId(*next_rid);
+  row_->SetRowId(next_rid);
   return *this;
 }
 
+void TableIterator::ReadAheadFrom(page_id_t page_id) {
+  int page_index = table_heap_->free_space_map_.GetPageIndex(page_id);
+  if (page_index >= 0) {
+    read_ahead_.Access(page_index);
+  }
+}
+
 TableIterator TableIterator::operator++(int) {
   TableIterator ret_val = *this;
   ++(*this);
@@ -1,9 +1,17 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/instance.h"
+#include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/basic_comparator.h"
+#include "storage/table_heap.h"
 
 TEST(BufferPoolManagerTest, BinaryDataTest) {
   const std::string db_name = "bpm_test.db";
@@ -70,4 +78,131 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+TEST(BufferPoolManagerTest, DISABLED_InsertThroughputBenchmark) {
+  const std::string db_name = "bpm_insert_bench.db";
+  const int n = 20000;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[32];
+  memset(characters, 'a', sizeof(characters));
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 32, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "table heap inserts per second: " << static_cast<int64_t>(n) * 1000000 / (elapsed.count() + 1)
+            << std::endl;
+
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator);
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  start = std::chrono::steady_clock::now();
+  for (int key : keys) {
+    ASSERT_TRUE(tree.Insert(key, key));
+  }
+  elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "b+ tree inserts per second: " << static_cast<int64_t>(n) * 1000000 / (elapsed.count() + 1)
+            << std::endl;
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BufferPoolManagerTest, BackgroundFlushTest) {
+  const std::string db_name = "bpm_flush_test.db";
+  const size_t buffer_pool_size = 20;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->SetDirtyWatermarks(0.2, 0.5);
+
+  // Scenario: unpinning dirty pages only marks them, nothing reaches the disk yet.
+  page_id_t page_id;
+  char buf[PAGE_SIZE];
+  for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+    auto page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetDirtyCount());
+  disk_manager->ReadPage(0, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  // Scenario: crossing the high watermark wakes the flusher, which writes back down to the low watermark.
+  for (size_t i = 0; i < buffer_pool_size / 4; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    snprintf(bpm->FetchPage(page_id)->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+    bpm->UnpinPage(page_id, true);
+  }
+  for (int i = 0; i < 50 && bpm->GetDirtyCount() > buffer_pool_size / 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  EXPECT_LE(bpm->GetDirtyCount(), buffer_pool_size / 5);
+  // pages are written in page id order, so the lowest ones are on disk now
+  disk_manager->ReadPage(0, buf);
+  EXPECT_EQ(0, strcmp("page 0", buf));
+
+  // Scenario: dirty pages survive eviction and shutdown.
+  for (size_t i = 0; i < buffer_pool_size * 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    snprintf(bpm->FetchPage(page_id)->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+    bpm->UnpinPage(page_id, true);
+  }
+  delete bpm;
+  for (page_id_t i = 0; i <= page_id; i++) {
+    char expected[PAGE_SIZE];
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    disk_manager->ReadPage(i, buf);
+    EXPECT_EQ(0, strcmp(expected, buf));
+  }
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, DeletePinnedPageTest) {
+  const std::string db_name = "bpm_delete_test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+
+  page_id_t page_id;
+  Page *page = bpm->NewPage(page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), PAGE_SIZE, "deleted");
+  // Scenario: a page deleted while pinned stays readable and allocated until its last unpin.
+  EXPECT_FALSE(bpm->DeletePage(page_id));
+  EXPECT_FALSE(bpm->IsPageFree(page_id));
+  ASSERT_EQ(page, bpm->FetchPage(page_id));
+  EXPECT_EQ(0, strcmp("deleted", page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_FALSE(bpm->IsPageFree(page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  EXPECT_TRUE(bpm->IsPageFree(page_id));
+  EXPECT_FALSE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: the page id and the frame are handed out again.
+  page_id_t new_page_id;
+  page = bpm->NewPage(new_page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(page_id, new_page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(new_page_id, false));
+  EXPECT_TRUE(bpm->DeletePage(new_page_id));
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+TEST(ClockReplacerTest, SampleTest) {
+  ClockReplacer clock_replacer(7);
+
+  // Scenario: unpin six elements, i.e. add them to the replacer.
+  clock_replacer.Unpin(1);
+  clock_replacer.Unpin(2);
+  clock_replacer.Unpin(3);
+  clock_replacer.Unpin(4);
+  clock_replacer.Unpin(5);
+  clock_replacer.Unpin(6);
+  clock_replacer.Unpin(1);
+  EXPECT_EQ(6, clock_replacer.Size());
+
+  // Scenario: get three victims from the clock.
+  int value;
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: pin elements in the replacer.
+  // Note that 3 has already been victimized, so pinning 3 should have no effect.
+  clock_replacer.Pin(3);
+  clock_replacer.Pin(4);
+  EXPECT_EQ(2, clock_replacer.Size());
+
+  // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
+  clock_replacer.Unpin(4);
+
+  // Scenario: continue looking for victims. We expect these victims.
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  EXPECT_EQ(0, clock_replacer.Size());
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+}
+
+TEST(ClockReplacerTest, BufferPoolManagerTest) {
+  const std::string db_name = "clock_bpm_test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(10, disk_manager, ReplacerType::kClock);
+  page_id_t page_id;
+  for (int i = 0; i < 10; i++) {
+    auto page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  for (page_id_t i = 0; i < 10; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  for (int i = 0; i < 10; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  char expected[PAGE_SIZE];
+  for (page_id_t i = 0; i < 10; i++) {
+    auto page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(expected, page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+namespace {
+/**
+ * @return nanoseconds per Victim/Pin/Unpin call over a round of unpin all, random pin/unpin, victim all
+ */
+double ReplacerRoundCost(Replacer *replacer, size_t num_frames) {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<frame_id_t> dist(0, static_cast<frame_id_t>(num_frames) - 1);
+  std::vector<frame_id_t> random_frames(num_frames);
+  for (auto &frame_id : random_frames) {
+    frame_id = dist(rng);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer->Unpin(static_cast<frame_id_t>(i));
+  }
+  for (auto frame_id : random_frames) {
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  frame_id_t victim;
+  while (replacer->Victim(&victim)) {
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(elapsed.count()) / (num_frames * 4);
+}
+}  // namespace
+
+TEST(ClockReplacerTest, DISABLED_ReplacerCostBenchmark) {
+  for (size_t num_frames : {1000, 10000, 100000, 1000000}) {
+    auto lru_replacer = std::make_unique<LRUReplacer>(num_frames);
+    auto clock_replacer = std::make_unique<ClockReplacer>(num_frames);
+    double lru_cost = ReplacerRoundCost(lru_replacer.get(), num_frames);
+    double clock_cost = ReplacerRoundCost(clock_replacer.get(), num_frames);
+    LOG(INFO) << "frames: " << num_frames << ", lru: " << lru_cost << "ns/op, clock: " << clock_cost << "ns/op"
+              << std::endl;
+    EXPECT_EQ(0, lru_replacer->Size());
+    EXPECT_EQ(0, clock_replacer->Size());
+  }
+}
@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/lru_k_replacer.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frame 1 is accessed twice, frames 2 and 3 only once.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Unpin(3);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+
+  // Scenario: frames with less than K accesses go first, in order of their first access.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: frames 4 and 5 are accessed as 4, 5, 5, 4, so 4 has the larger backward 2-distance.
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Unpin(4);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: a pinned frame is never victimized.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+}
+
+TEST(LRUKReplacerTest, ReusedFrameTest) {
+  LRUKReplacer lru_k_replacer(4, 2);
+  int value;
+
+  // Scenario: frame 3 is accessed and stays pinned, then frame 2 is accessed twice and victimized.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+
+  // Scenario: frame 2 is handed back without a new access. It must not keep the accesses of its previous page,
+  // so it goes before frame 3, accessed before them.
+  lru_k_replacer.Unpin(3);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+
+  // Scenario: a removed frame is never victimized and forgets its accesses as well.
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Remove(0);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+namespace {
+/**
+ * Point lookups on a small hot set (think B+ tree internal pages) interleaved with a full scan of a large table.
+ * @return hit rate of the point lookups
+ */
+double MixedWorkloadHitRate(ReplacerType replacer_type, double *overall_hit_rate) {
+  const std::string db_name = "lru_k_bench.db";
+  const size_t pool_size = 64;
+  const page_id_t hot_pages = 48;
+  const page_id_t scan_pages = 1024;
+  const int steps = 20000;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(pool_size, disk_manager, replacer_type);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < hot_pages + scan_pages; i++) {
+    EXPECT_NE(nullptr, bpm->NewPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+  size_t base_hits = bpm->GetHitCount();
+  size_t base_misses = bpm->GetMissCount();
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> hot_dist(0, hot_pages - 1);
+  size_t lookup_hits = 0;
+  page_id_t scan_cursor = 0;
+  for (int i = 0; i < steps; i++) {
+    for (int j = 0; j < 2; j++) {
+      size_t hits = bpm->GetHitCount();
+      page_id_t hot_page = hot_dist(rng);
+      EXPECT_NE(nullptr, bpm->FetchPage(hot_page));
+      bpm->UnpinPage(hot_page, false);
+      lookup_hits += bpm->GetHitCount() - hits;
+    }
+    page_id_t scan_page = hot_pages + scan_cursor;
+    scan_cursor = (scan_cursor + 1) % scan_pages;
+    EXPECT_NE(nullptr, bpm->FetchPage(scan_page));
+    bpm->UnpinPage(scan_page, false);
+  }
+  size_t hits = bpm->GetHitCount() - base_hits;
+  size_t misses = bpm->GetMissCount() - base_misses;
+  *overall_hit_rate = static_cast<double>(hits) / (hits + misses);
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+  return static_cast<double>(lookup_hits) / (steps * 2);
+}
+}  // namespace
+
+TEST(LRUKReplacerTest, MixedWorkloadHitRateTest) {
+  double lru_overall, lru_k_overall;
+  double lru_lookup = MixedWorkloadHitRate(ReplacerType::kLRU, &lru_overall);
+  double lru_k_lookup = MixedWorkloadHitRate(ReplacerType::kLRUK, &lru_k_overall);
+  LOG(INFO) << "LRU   hit rate: overall " << lru_overall << ", point lookups " << lru_lookup << std::endl;
+  LOG(INFO) << "LRU-2 hit rate: overall " << lru_k_overall << ", point lookups " << lru_k_lookup << std::endl;
+  EXPECT_GT(lru_k_lookup, lru_lookup);
+  EXPECT_GT(lru_k_overall, lru_overall);
+}
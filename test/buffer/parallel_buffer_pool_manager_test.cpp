@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "parallel_bpm_test.db";
+  const size_t num_instances = 4;
+  const size_t pool_size = 5;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  BufferPoolManager *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Scenario: pages are spread over the instances, so the whole pool can be filled.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    auto page = bpm->NewPage(page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id_temp);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+  }
+  // Scenario: every instance is full now.
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id_temp));
+  EXPECT_FALSE(bpm->CheckAllUnpinned());
+
+  // Scenario: after unpinning all pages, each instance has room again.
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: pages written through any instance can be read back after eviction.
+  for (size_t i = 0; i < num_instances * pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  char expected[PAGE_SIZE];
+  for (page_id_t i = 0; i < static_cast<page_id_t>(num_instances * pool_size); ++i) {
+    auto page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(expected, page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, ConcurrentFetchUnpinTest) {
+  const std::string db_name = "parallel_bpm_concurrent_test.db";
+  const size_t num_instances = 4;
+  const size_t pool_size = 8;
+  const page_id_t num_pages = 64;
+  const int num_threads = 4;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  BufferPoolManager *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    auto page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: twice as many pages as frames, pages are evicted and read back while other threads fetch.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([bpm, t]() {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      char expected[PAGE_SIZE];
+      for (int i = 0; i < 2000; i++) {
+        page_id_t id = dist(rng);
+        Page *page = bpm->FetchPage(id);
+        ASSERT_NE(nullptr, page);
+        snprintf(expected, PAGE_SIZE, "page %d", id);
+        EXPECT_EQ(0, strcmp(expected, page->GetData()));
+        bpm->UnpinPage(id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(ParallelBufferPoolManagerTest, DISABLED_FetchUnpinThroughputBenchmark) {
+  const std::string db_name = "parallel_bpm_bench.db";
+  const size_t total_frames = 1024;
+  const page_id_t num_pages = 512;
+  const int num_threads = 8;
+  const int ops_per_thread = 50000;
+
+  for (size_t num_instances : {1, 2, 4, 8, 16}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    BufferPoolManager *bpm = num_instances == 1
+                                 ? new BufferPoolManager(total_frames, disk_manager)
+                                 : new ParallelBufferPoolManager(num_instances, total_frames / num_instances,
+                                                                 disk_manager);
+    page_id_t page_id;
+    for (page_id_t i = 0; i < num_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      bpm->UnpinPage(page_id, false);
+    }
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([bpm, t]() {
+        std::mt19937 rng(t);
+        std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+        for (int i = 0; i < ops_per_thread; i++) {
+          page_id_t id = dist(rng);
+          Page *page = bpm->FetchPage(id);
+          ASSERT_NE(nullptr, page);
+          bpm->UnpinPage(id, false);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << "instances: " << num_instances << ", threads: " << num_threads << ", fetch/unpin per second: "
+              << static_cast<uint64_t>(num_threads) * ops_per_thread * 1000000 / (elapsed.count() + 1) << std::endl;
+    EXPECT_TRUE(bpm->CheckAllUnpinned());
+    delete bpm;
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+}
@@ -135,4 +135,37 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogIndexDuplicateKeyTest) {
+  SimpleMemHeap heap;
+  auto db = new DBStorageEngine(db_file_name, true);
+  auto &catalog = db->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateTable("table-1", schema.get(), &txn, table_info));
+  // rows written around the catalog, so id is not unique although the column says so
+  for (int i = 0; i < 100; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i == 99 ? 7 : i),
+            Field(TypeId::kTypeChar, const_cast<char *>("minisql"), 7, true)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  for (auto index_type : {IndexType::kBPlusTree, IndexType::kHash}) {
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_KEY_ALREADY_EXIST, catalog->CreateIndex("table-1", "index-1", {"id"}, &txn, index_info, index_type));
+    ASSERT_TRUE(index_info == nullptr);
+    ASSERT_EQ(DB_INDEX_NOT_FOUND, catalog->GetIndex("table-1", "index-1", index_info));
+  }
+  // the failed builds are not registered, an index on another column still builds
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog->CreateIndex("table-1", "index-2", {"name"}, &txn, index_info));
+  ASSERT_EQ(DB_SUCCESS, catalog->GetIndex("table-1", "index-2", index_info));
+  delete db;
+}
@@ -0,0 +1,254 @@
+#include <string>
+
+#include "common/instance.h"
+#include "executor/executors.h"
+#include "executor/vectorized_executors.h"
+#include "gtest/gtest.h"
+
+static string db_file_name = "executors_test.db";
+
+/**
+ * Table (id int unique, name char(64), account float) with a B+ tree index on id
+ */
+class ExecutorsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    db_ = new DBStorageEngine(db_file_name, true);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, true),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 64, 1, true, false),
+            ALLOC_COLUMN(heap_)("account", TypeId::kTypeFloat, 2, true, false)
+    };
+    schema_ = std::make_shared<Schema>(columns);
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("account", schema_.get(), &txn_, table_info_));
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateIndex("account", "id_index", {"id"}, &txn_, index_info_));
+  }
+
+  void TearDown() override {
+    delete db_;
+    remove(db_file_name.c_str());
+  }
+
+  static std::vector<Field> MakeFields(int id, const std::string &name) {
+    std::vector<Field> fields;
+    fields.push_back(Field(TypeId::kTypeInt, id));
+    fields.push_back(Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true));
+    fields.push_back(Field(TypeId::kTypeFloat, float(id % 100)));
+    return fields;
+  }
+
+  void InsertRows(int n) {
+    std::vector<std::vector<Field>> values;
+    for (int i = 0; i < n; i++) {
+      values.push_back(MakeFields(i, "name-" + std::to_string(i)));
+    }
+    InsertExecutor insert(table_info_, {index_info_}, std::move(values), &txn_);
+    insert.Open();
+    int inserted = 0;
+    while (insert.Next() != nullptr) {
+      inserted++;
+    }
+    insert.Close();
+    ASSERT_FALSE(insert.Failed());
+    ASSERT_EQ(n, inserted);
+  }
+
+  static int Drain(AbstractExecutor *executor) {
+    int count = 0;
+    executor->Open();
+    while (executor->Next() != nullptr) {
+      count++;
+    }
+    executor->Close();
+    return count;
+  }
+
+  SimpleMemHeap heap_;
+  std::shared_ptr<Schema> schema_;
+  Transaction txn_;
+  DBStorageEngine *db_{nullptr};
+  TableInfo *table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+};
+
+TEST_F(ExecutorsTest, ScanFilterProjectionTest) {
+  const int n = 5000;
+  InsertRows(n);
+  SeqScanExecutor scan(table_info_, &txn_);
+  ASSERT_EQ(n, Drain(&scan));
+
+  // account < 10 and id >= 1000
+  Predicate *predicate = Predicate::And(
+          Predicate::Compare(2, Predicate::CompareOp::kLess, Field(TypeId::kTypeFloat, 10.0f)),
+          Predicate::Compare(0, Predicate::CompareOp::kGreaterEqual, Field(TypeId::kTypeInt, 1000)));
+  ProjectionExecutor plan(new FilterExecutor(new SeqScanExecutor(table_info_, &txn_), predicate), {1, 0});
+  plan.Open();
+  int count = 0;
+  for (Row *row = plan.Next(); row != nullptr; row = plan.Next()) {
+    ASSERT_EQ(2, row->GetFieldCount());
+    int id = row->GetField(1)->GetData() == nullptr ? -1 : atoi(row->GetField(1)->GetData());
+    ASSERT_TRUE(id >= 1000 && id % 100 < 10);
+    std::string name = "name-" + std::to_string(id);
+    ASSERT_EQ(name, std::string(row->GetField(0)->GetData(), row->GetField(0)->GetLength()));
+    count++;
+  }
+  plan.Close();
+  ASSERT_EQ((n - 1000) / 10, count);
+
+  // the same predicate run twice, Open() restarts the scan
+  ASSERT_EQ(count, Drain(&plan));
+}
+
+TEST_F(ExecutorsTest, IndexScanTest) {
+  const int n = 2000;
+  InsertRows(n);
+  IndexScanExecutor point(table_info_, index_info_, Field(TypeId::kTypeInt, 42), &txn_);
+  point.Open();
+  Row *row = point.Next();
+  ASSERT_TRUE(row != nullptr);
+  ASSERT_EQ(CmpBool::kTrue, row->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 42)));
+  ASSERT_TRUE(point.Next() == nullptr);
+  point.Close();
+
+  IndexScanExecutor missing(table_info_, index_info_, Field(TypeId::kTypeInt, n), &txn_);
+  ASSERT_EQ(0, Drain(&missing));
+
+  Field lo(TypeId::kTypeInt, 100), hi(TypeId::kTypeInt, 200);
+  IndexScanExecutor range(table_info_, index_info_, &lo, false, &hi, true, &txn_);
+  ASSERT_EQ(100, Drain(&range));
+  IndexScanExecutor open_range(table_info_, index_info_, &lo, true, nullptr, false, &txn_);
+  ASSERT_EQ(n - 100, Drain(&open_range));
+}
+
+TEST_F(ExecutorsTest, VectorizedIndexScanTest) {
+  const int n = 3000;
+  InsertRows(n);
+  // id in [100, 2500), split over several batches, in index order
+  Field lo(TypeId::kTypeInt, 100), hi(TypeId::kTypeInt, 2500);
+  VectorizedIndexScanExecutor scan(new IndexScanExecutor(table_info_, index_info_, &lo, true, &hi, false, &txn_),
+                                   &txn_);
+  for (int round = 0; round < 2; round++) {
+    scan.Open();
+    int expected = 100;
+    for (RowBatch *batch = scan.Next(); batch != nullptr; batch = scan.Next()) {
+      ASSERT_LE(batch->GetSize(), VECTOR_SIZE);
+      for (auto i : batch->GetSelection()) {
+        ASSERT_EQ(expected, batch->GetColumn(0).GetInts()[i]);
+        ASSERT_EQ("name-" + std::to_string(expected), batch->GetColumn(1).GetString(i));
+        ASSERT_EQ(float(expected % 100), batch->GetColumn(2).GetFloats()[i]);
+        expected++;
+      }
+    }
+    scan.Close();
+    ASSERT_EQ(2500, expected);
+  }
+}
+
+TEST_F(ExecutorsTest, InsertConflictTest) {
+  InsertRows(10);
+  std::vector<std::vector<Field>> values;
+  values.push_back(MakeFields(10, "new"));
+  values.push_back(MakeFields(3, "duplicate"));
+  values.push_back(MakeFields(11, "never"));
+  InsertExecutor insert(table_info_, {index_info_}, std::move(values), &txn_);
+  ASSERT_EQ(1, Drain(&insert));
+  ASSERT_TRUE(insert.Failed());
+  SeqScanExecutor scan(table_info_, &txn_);
+  ASSERT_EQ(11, Drain(&scan));
+}
+
+TEST_F(ExecutorsTest, UpdateDeleteTest) {
+  const int n = 3000;
+  InsertRows(n);
+
+  // every row grows, rows that no longer fit in their page move to later pages and must not be updated twice
+  std::string long_name(60, 'x');
+  std::vector<Field> values;
+  values.push_back(Field(TypeId::kTypeChar, const_cast<char *>(long_name.c_str()), long_name.size(), true));
+  UpdateExecutor update(table_info_, {index_info_}, new SeqScanExecutor(table_info_, &txn_), {1}, std::move(values),
+                        &txn_);
+  ASSERT_EQ(n, Drain(&update));
+  ASSERT_FALSE(update.Failed());
+
+  SeqScanExecutor scan(table_info_, &txn_);
+  scan.Open();
+  int count = 0;
+  for (Row *row = scan.Next(); row != nullptr; row = scan.Next()) {
+    ASSERT_EQ(long_name, std::string(row->GetField(1)->GetData(), row->GetField(1)->GetLength()));
+    count++;
+  }
+  scan.Close();
+  ASSERT_EQ(n, count);
+  // the index follows moved rows
+  for (int i = 0; i < n; i += 97) {
+    IndexScanExecutor point(table_info_, index_info_, Field(TypeId::kTypeInt, i), &txn_);
+    ASSERT_EQ(1, Drain(&point));
+  }
+
+  // updating id 1 to an existing id violates the unique index
+  std::vector<Field> ids;
+  ids.push_back(Field(TypeId::kTypeInt, 2));
+  UpdateExecutor conflict(table_info_, {index_info_},
+                          new IndexScanExecutor(table_info_, index_info_, Field(TypeId::kTypeInt, 1), &txn_), {0},
+                          std::move(ids), &txn_);
+  ASSERT_EQ(0, Drain(&conflict));
+  ASSERT_TRUE(conflict.Failed());
+
+  // delete id < 1000
+  Predicate *predicate = Predicate::Compare(0, Predicate::CompareOp::kLess, Field(TypeId::kTypeInt, 1000));
+  DeleteExecutor delete_executor(table_info_, {index_info_},
+                                  new FilterExecutor(new SeqScanExecutor(table_info_, &txn_), predicate), &txn_);
+  ASSERT_EQ(1000, Drain(&delete_executor));
+  ASSERT_EQ(n - 1000, Drain(&scan));
+  IndexScanExecutor deleted(table_info_, index_info_, Field(TypeId::kTypeInt, 500), &txn_);
+  ASSERT_EQ(0, Drain(&deleted));
+  IndexScanExecutor kept(table_info_, index_info_, Field(TypeId::kTypeInt, 1500), &txn_);
+  ASSERT_EQ(1, Drain(&kept));
+}
+
+TEST(ExecutorsReadAheadTest, SeqScanReadAheadTest) {
+  // a small pool, so that most of the table is not cached when a scan starts
+  const std::string db_name = "executors_read_ahead_test.db";
+  auto *db = new DBStorageEngine(db_name, true, 64);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->CreateTable("t", schema.get(), &txn, table_info));
+  const int n = 20000;
+  std::string name(64, 'x');
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  BufferPoolManager *bpm = db->bpm_;
+
+  size_t hits = bpm->GetPrefetchHitCount();
+  SeqScanExecutor scan(table_info, &txn);
+  scan.Open();
+  int count = 0;
+  while (scan.Next() != nullptr) {
+    count++;
+  }
+  scan.Close();
+  ASSERT_EQ(n, count);
+  EXPECT_GT(bpm->GetPrefetchHitCount(), hits);
+
+  hits = bpm->GetPrefetchHitCount();
+  VectorizedSeqScanExecutor vectorized_scan(table_info, &txn);
+  vectorized_scan.Open();
+  count = 0;
+  for (RowBatch *batch = vectorized_scan.Next(); batch != nullptr; batch = vectorized_scan.Next()) {
+    count += batch->GetSize();
+  }
+  vectorized_scan.Close();
+  ASSERT_EQ(n, count);
+  EXPECT_GT(bpm->GetPrefetchHitCount(), hits);
+
+  delete db;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,137 @@
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "executor/predicate_kernels.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+static const Predicate::CompareOp kOps[] = {Predicate::CompareOp::kEqual, Predicate::CompareOp::kNotEqual,
+                                            Predicate::CompareOp::kLess, Predicate::CompareOp::kLessEqual,
+                                            Predicate::CompareOp::kGreater, Predicate::CompareOp::kGreaterEqual};
+
+static const char *kOpNames[] = {"=", "<>", "<", "<=", ">", ">="};
+
+static const char *kLevelNames[] = {"scalar", "sse", "avx2"};
+
+template<typename T>
+static bool Compare(Predicate::CompareOp op, T a, T b) {
+  switch (op) {
+    case Predicate::CompareOp::kEqual:
+      return a == b;
+    case Predicate::CompareOp::kNotEqual:
+      return a != b;
+    case Predicate::CompareOp::kLess:
+      return a < b;
+    case Predicate::CompareOp::kLessEqual:
+      return a <= b;
+    case Predicate::CompareOp::kGreater:
+      return a > b;
+    case Predicate::CompareOp::kGreaterEqual:
+      return a >= b;
+  }
+  return false;
+}
+
+/**
+ * Checks every kernel of every instruction set this CPU supports against the scalar operators, on lengths
+ * around the 8 lane and 64 bit word boundaries
+ */
+TEST(PredicateKernelsTest, CompareTest) {
+  std::mt19937 rng(0);
+  const uint32_t max_n = VECTOR_SIZE + 71;
+  std::vector<int32_t> ints(max_n);
+  std::vector<float> floats(max_n);
+  for (uint32_t i = 0; i < max_n; i++) {
+    ints[i] = static_cast<int32_t>(rng() % 64) - 32;
+    floats[i] = i % 37 == 0 ? NAN : static_cast<float>(rng() % 64) / 2 - 16;
+  }
+  // values at both ends of the int range compare correctly with signed compares
+  ints[5] = INT32_MIN;
+  ints[6] = INT32_MAX;
+  const uint32_t lengths[] = {0, 1, 7, 8, 9, 63, 64, 65, 200, VECTOR_SIZE, max_n};
+  for (int level = 0; level <= static_cast<int>(PredicateKernels::DetectLevel()); level++) {
+    const auto &kernels = PredicateKernels::Get(static_cast<SimdLevel>(level));
+    for (auto op : kOps) {
+      for (auto n : lengths) {
+        std::vector<uint64_t> bitmap((n + 63) / 64 + 1, ~uint64_t(0));
+        kernels.GetIntKernel(op)(ints.data(), n, 3, bitmap.data());
+        for (uint32_t i = 0; i < n; i++) {
+          ASSERT_EQ(Compare(op, ints[i], 3), (bitmap[i / 64] >> (i % 64)) & 1)
+                  << kLevelNames[level] << " int " << kOpNames[static_cast<int>(op)] << " n=" << n << " i=" << i;
+        }
+        if (n % 64 != 0) {
+          ASSERT_EQ(0, bitmap[n / 64] >> (n % 64));
+        }
+        // one word past the bitmap is left alone
+        ASSERT_EQ(~uint64_t(0), bitmap.back());
+
+        std::fill(bitmap.begin(), bitmap.end(), ~uint64_t(0));
+        kernels.GetFloatKernel(op)(floats.data(), n, 0.5f, bitmap.data());
+        for (uint32_t i = 0; i < n; i++) {
+          ASSERT_EQ(Compare(op, floats[i], 0.5f), (bitmap[i / 64] >> (i % 64)) & 1)
+                  << kLevelNames[level] << " float " << kOpNames[static_cast<int>(op)] << " n=" << n << " i=" << i;
+        }
+        if (n % 64 != 0) {
+          ASSERT_EQ(0, bitmap[n / 64] >> (n % 64));
+        }
+        ASSERT_EQ(~uint64_t(0), bitmap.back());
+      }
+    }
+  }
+}
+
+TEST(PredicateKernelsTest, NullTest) {
+  const uint32_t n = 200;
+  std::vector<uint64_t> nulls((n + 63) / 64, 0);
+  for (uint32_t i = 0; i < n; i += 3) {
+    nulls[i / 64] |= uint64_t(1) << (i % 64);
+  }
+  std::vector<uint64_t> is_null(nulls.size()), not_null(nulls.size());
+  PredicateKernels::IsNull(nulls.data(), n, is_null.data());
+  PredicateKernels::NotNull(nulls.data(), n, not_null.data());
+  for (uint32_t i = 0; i < n; i++) {
+    ASSERT_EQ(i % 3 == 0, (is_null[i / 64] >> (i % 64)) & 1);
+    ASSERT_EQ(i % 3 != 0, (not_null[i / 64] >> (i % 64)) & 1);
+  }
+  ASSERT_EQ(0, not_null.back() >> (n % 64));
+}
+
+/**
+ * Every comparison on both types, for every instruction set this CPU supports, over batches of VECTOR_SIZE values
+ */
+TEST(PredicateKernelsTest, DISABLED_CompareBenchmark) {
+  std::mt19937 rng(0);
+  std::vector<int32_t> ints(VECTOR_SIZE);
+  std::vector<float> floats(VECTOR_SIZE);
+  for (uint32_t i = 0; i < VECTOR_SIZE; i++) {
+    ints[i] = static_cast<int32_t>(rng() % 1000);
+    floats[i] = static_cast<float>(rng() % 1000) / 10;
+  }
+  std::vector<uint64_t> bitmap(VECTOR_SIZE / 64);
+  const int rounds = 20000;
+  for (int level = 0; level <= static_cast<int>(PredicateKernels::DetectLevel()); level++) {
+    const auto &kernels = PredicateKernels::Get(static_cast<SimdLevel>(level));
+    for (auto op : kOps) {
+      uint64_t checksum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < rounds; round++) {
+        kernels.GetIntKernel(op)(ints.data(), VECTOR_SIZE, 500, bitmap.data());
+        checksum += bitmap[round % bitmap.size()];
+      }
+      auto int_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+      start = std::chrono::steady_clock::now();
+      for (int round = 0; round < rounds; round++) {
+        kernels.GetFloatKernel(op)(floats.data(), VECTOR_SIZE, 50.0f, bitmap.data());
+        checksum += bitmap[round % bitmap.size()];
+      }
+      auto float_elapsed =
+              std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+      LOG(INFO) << kLevelNames[level] << " " << kOpNames[static_cast<int>(op)] << ": int32 "
+                << double(int_elapsed.count()) / (rounds * VECTOR_SIZE) << "ns/value, float "
+                << double(float_elapsed.count()) / (rounds * VECTOR_SIZE) << "ns/value (" << checksum % 10 << ")"
+                << std::endl;
+    }
+  }
+}
@@ -0,0 +1,214 @@
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "executor/executors.h"
+#include "executor/vectorized_executors.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+static string db_file_name = "vectorized_executors_test.db";
+
+/**
+ * Table (id int, name char(16) null, account float null), where name and account are null for every 7th and
+ * 11th row
+ */
+class VectorizedExecutorsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    db_ = new DBStorageEngine(db_file_name, true);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 16, 1, true, false),
+            ALLOC_COLUMN(heap_)("account", TypeId::kTypeFloat, 2, true, false)
+    };
+    schema_ = std::make_shared<Schema>(columns);
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("account", schema_.get(), &txn_, table_info_));
+  }
+
+  void TearDown() override {
+    delete db_;
+    remove(db_file_name.c_str());
+  }
+
+  void InsertRows(int n) {
+    std::mt19937 rng(0);
+    char name[16];
+    for (int i = 0; i < n; i++) {
+      snprintf(name, sizeof(name), "name%d", int(rng() % 1000));
+      std::vector<Field> fields;
+      fields.push_back(Field(TypeId::kTypeInt, int(rng() % 100000)));
+      fields.push_back(i % 7 == 0 ? Field(TypeId::kTypeChar)
+                                  : Field(TypeId::kTypeChar, name, strlen(name), true));
+      fields.push_back(i % 11 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, float(rng() % 1000) / 10));
+      Row row(fields);
+      ASSERT_TRUE(table_info_->GetTableHeap()->InsertTuple(row, &txn_));
+    }
+  }
+
+  std::vector<int64_t> RowAtATime(Predicate *predicate) {
+    std::vector<int64_t> rids;
+    FilterExecutor plan(new SeqScanExecutor(table_info_, &txn_), predicate);
+    plan.Open();
+    for (Row *row = plan.Next(); row != nullptr; row = plan.Next()) {
+      rids.push_back(row->GetRowId().Get());
+    }
+    plan.Close();
+    return rids;
+  }
+
+  std::vector<int64_t> Vectorized(Predicate *predicate) {
+    std::vector<int64_t> rids;
+    VectorizedFilterExecutor plan(new VectorizedSeqScanExecutor(table_info_, &txn_), predicate);
+    plan.Open();
+    for (RowBatch *batch = plan.Next(); batch != nullptr; batch = plan.Next()) {
+      EXPECT_FALSE(batch->GetSelection().empty());
+      for (auto i : batch->GetSelection()) {
+        rids.push_back(batch->GetRowId(i).Get());
+      }
+    }
+    plan.Close();
+    return rids;
+  }
+
+  SimpleMemHeap heap_;
+  std::shared_ptr<Schema> schema_;
+  Transaction txn_;
+  DBStorageEngine *db_{nullptr};
+  TableInfo *table_info_{nullptr};
+};
+
+TEST_F(VectorizedExecutorsTest, ColumnVectorTest) {
+  InsertRows(3000);
+  VectorizedSeqScanExecutor scan(table_info_, &txn_);
+  SeqScanExecutor row_scan(table_info_, &txn_);
+  scan.Open();
+  row_scan.Open();
+  uint32_t total = 0;
+  for (RowBatch *batch = scan.Next(); batch != nullptr; batch = scan.Next()) {
+    // only the last batch may be short
+    if (total + batch->GetSize() < 3000) {
+      ASSERT_GE(batch->GetSize(), VECTOR_SIZE);
+    }
+    ASSERT_EQ(batch->GetSize(), batch->GetSelection().size());
+    for (uint32_t i = 0; i < batch->GetSize(); i++) {
+      Row *row = row_scan.Next();
+      ASSERT_TRUE(row != nullptr);
+      ASSERT_EQ(row->GetRowId().Get(), batch->GetRowId(i).Get());
+      ASSERT_EQ(i, batch->GetSelection()[i]);
+      ASSERT_EQ(atoi(row->GetField(0)->GetData()), batch->GetColumn(0).GetInts()[i]);
+      ASSERT_EQ(row->GetField(1)->IsNull(), batch->GetColumn(1).IsNull(i));
+      if (!row->GetField(1)->IsNull()) {
+        ASSERT_EQ(std::string(row->GetField(1)->GetData(), row->GetField(1)->GetLength()),
+                  batch->GetColumn(1).GetString(i));
+      }
+      ASSERT_EQ(row->GetField(2)->IsNull(), batch->GetColumn(2).IsNull(i));
+    }
+    total += batch->GetSize();
+  }
+  ASSERT_TRUE(row_scan.Next() == nullptr);
+  ASSERT_EQ(3000, total);
+}
+
+TEST_F(VectorizedExecutorsTest, FilterTest) {
+  InsertRows(5000);
+  char name[] = "name500";
+  Field id(TypeId::kTypeInt, 50000), account(TypeId::kTypeFloat, 25.0f);
+  Field chars(TypeId::kTypeChar, name, strlen(name), true);
+  std::vector<std::function<Predicate *()>> predicates;
+  const Predicate::CompareOp ops[] = {Predicate::CompareOp::kEqual, Predicate::CompareOp::kNotEqual,
+                                      Predicate::CompareOp::kLess, Predicate::CompareOp::kLessEqual,
+                                      Predicate::CompareOp::kGreater, Predicate::CompareOp::kGreaterEqual};
+  for (auto op : ops) {
+    predicates.emplace_back([&, op] { return Predicate::Compare(0, op, id); });
+    predicates.emplace_back([&, op] { return Predicate::Compare(1, op, chars); });
+    predicates.emplace_back([&, op] { return Predicate::Compare(2, op, account); });
+  }
+  predicates.emplace_back([] { return Predicate::IsNull(1); });
+  predicates.emplace_back([] { return Predicate::NotNull(2); });
+  predicates.emplace_back([&] { return Predicate::Compare(2, Predicate::CompareOp::kLess, Field(TypeId::kTypeFloat)); });
+  predicates.emplace_back([&] {
+    return Predicate::Or(Predicate::And(Predicate::Compare(0, Predicate::CompareOp::kLess, id),
+                                        Predicate::Compare(2, Predicate::CompareOp::kGreaterEqual, account)),
+                         Predicate::IsNull(2));
+  });
+  for (size_t i = 0; i < predicates.size(); i++) {
+    std::vector<int64_t> expected = RowAtATime(predicates[i]());
+    std::vector<int64_t> actual = Vectorized(predicates[i]());
+    ASSERT_EQ(expected, actual) << "predicate " << i;
+  }
+}
+
+TEST_F(VectorizedExecutorsTest, DISABLED_ScanFilterBenchmark) {
+  const int n = 1000000;
+  InsertRows(n);
+  // about 5% of the rows: id < 50000 and account >= 90
+  Field id(TypeId::kTypeInt, 50000), account(TypeId::kTypeFloat, 90.0f);
+  auto make_predicate = [&] {
+    return Predicate::And(Predicate::Compare(0, Predicate::CompareOp::kLess, id),
+                          Predicate::Compare(2, Predicate::CompareOp::kGreaterEqual, account));
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  size_t row_count = RowAtATime(make_predicate()).size();
+  auto row_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  start = std::chrono::steady_clock::now();
+  size_t vector_count = Vectorized(make_predicate()).size();
+  auto vector_elapsed =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  ASSERT_EQ(row_count, vector_count);
+  LOG(INFO) << "scan + filter of " << n << " rows, " << row_count << " selected: row at a time "
+            << row_elapsed.count() << "ms, vectorized " << vector_elapsed.count() << "ms" << std::endl;
+
+  // the filter alone, over rows and batches already in memory
+  std::vector<Row *> rows;
+  std::vector<RowBatch *> batches;
+  SeqScanExecutor row_scan(table_info_, &txn_);
+  row_scan.Open();
+  for (int i = 0; i < 100000; i++) {
+    rows.push_back(new Row(*row_scan.Next()));
+  }
+  row_scan.Close();
+  VectorizedSeqScanExecutor scan(table_info_, &txn_);
+  scan.Open();
+  for (uint32_t count = 0; count < rows.size();) {
+    batches.push_back(new RowBatch(*scan.Next()));
+    count += batches.back()->GetSize();
+  }
+  scan.Close();
+  Predicate *predicate = make_predicate();
+  const int rounds = 20;
+  size_t selected = 0;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (auto row : rows) {
+      selected += predicate->Evaluate(*row);
+    }
+  }
+  auto row_filter = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  std::vector<uint32_t> result;
+  size_t batch_rows = 0;
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (auto batch : batches) {
+      const auto &selection = batch->GetSelection();
+      result.resize(selection.size());
+      selected += predicate->Select(*batch, selection.data(), selection.size(), result.data());
+      batch_rows += selection.size();
+    }
+  }
+  auto vector_filter =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "filter only: row at a time " << row_filter.count() / (rounds * rows.size())
+            << "ns/row, vectorized " << double(vector_filter.count()) / batch_rows << "ns/row" << std::endl;
+  ASSERT_GT(selected, 0);
+  delete predicate;
+  for (auto row : rows) {
+    delete row;
+  }
+  for (auto batch : batches) {
+    delete batch;
+  }
+}
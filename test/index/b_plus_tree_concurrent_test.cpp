@@ -0,0 +1,162 @@
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/basic_comparator.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bp_tree_concurrent_test.db";
+
+using IntBPlusTree = BPlusTree<int, int, BasicComparator<int>>;
+
+/**
+ * Every thread inserts its own share of the keys in random order.
+ */
+TEST(BPlusTreeConcurrentTests, InsertTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntBPlusTree tree(0, engine.bpm_, comparator, 8, 8);
+  const int num_threads = 8;
+  const int n = 8000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t] {
+      std::vector<int> keys;
+      for (int key = t; key < n; key += num_threads) {
+        keys.push_back(key);
+      }
+      ShuffleArray(keys);
+      for (auto key : keys) {
+        ASSERT_TRUE(tree.Insert(key, key * 10));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<int> result;
+  for (int key = 0; key < n; key++) {
+    ASSERT_TRUE(tree.GetValue(key, result));
+    ASSERT_EQ(key * 10, result.back());
+  }
+  int expected = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expected++) {
+    ASSERT_EQ(expected, (*iter).first);
+  }
+  ASSERT_EQ(n, expected);
+  ASSERT_TRUE(tree.Check());
+}
+
+/**
+ * Writers remove the odd keys and insert new even keys while readers look up
+ * the keys that never change and scanners walk the leaves.
+ */
+TEST(BPlusTreeConcurrentTests, MixedTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntBPlusTree tree(0, engine.bpm_, comparator, 8, 8);
+  const int num_writers = 4;
+  const int n = 8000;
+  for (int key = 0; key < n; key++) {
+    tree.Insert(key, key);
+  }
+  std::atomic<int> writers_running{num_writers};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_writers; t++) {
+    threads.emplace_back([&tree, &writers_running, t] {
+      for (int key = 2 * t + 1; key < n; key += 2 * num_writers) {
+        tree.Remove(key);
+        ASSERT_TRUE(tree.Insert(n + key - 1, key));
+      }
+      writers_running--;
+    });
+  }
+  // readers: the even keys below n are never modified
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&tree, &writers_running] {
+      std::mt19937 rng(std::random_device{}());
+      std::vector<int> result;
+      while (writers_running > 0) {
+        int key = static_cast<int>(rng() % (n / 2)) * 2;
+        ASSERT_TRUE(tree.GetValue(key, result));
+        ASSERT_EQ(key, result.back());
+      }
+    });
+  }
+  // scanners: keys are always in strictly ascending order
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&tree, &writers_running] {
+      while (writers_running > 0) {
+        int last = -1;
+        for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+          ASSERT_LT(last, (*iter).first);
+          last = (*iter).first;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<int> result;
+  for (int key = 0; key < n; key++) {
+    ASSERT_EQ(key % 2 == 0, tree.GetValue(key, result));
+    ASSERT_TRUE(tree.GetValue(n + key - key % 2, result));
+  }
+  int count = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(0, (*iter).first % 2);
+    count++;
+  }
+  ASSERT_EQ(n, count);
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeConcurrentTests, DISABLED_ThroughputBenchmark) {
+  const int total_ops = 64000;
+  const int key_range = 20000;
+  for (int num_threads : {1, 2, 4, 8, 16, 32}) {
+    DBStorageEngine engine(db_name, true, DEFAULT_BUFFER_POOL_SIZE, 8);
+    BasicComparator<int> comparator;
+    IntBPlusTree tree(0, engine.bpm_, comparator);
+    for (int key = 0; key < key_range; key += 2) {
+      tree.Insert(key, key);
+    }
+    // half lookups, a quarter inserts, a quarter removes over uniformly random keys
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&tree, num_threads, t] {
+        std::mt19937 rng(t);
+        std::vector<int> result;
+        for (int i = 0; i < total_ops / num_threads; i++) {
+          int key = static_cast<int>(rng() % key_range);
+          switch (rng() % 4) {
+            case 0:
+              tree.Insert(key, key);
+              break;
+            case 1:
+              tree.Remove(key);
+              break;
+            default:
+              tree.GetValue(key, result);
+              result.clear();
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << num_threads << " threads: " << total_ops * 1000 / std::max<int64_t>(elapsed.count(), 1)
+              << " ops/ms" << std::endl;
+    ASSERT_TRUE(tree.Check());
+  }
+}
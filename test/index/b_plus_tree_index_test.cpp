@@ -1,9 +1,14 @@
+#include <chrono>
+#include <random>
 #include <string>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree_index.h"
+#include "index/fixed_key.h"
 #include "index/generic_key.h"
+#include "storage/table_heap.h"
+#include "utils/utils.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
 
@@ -34,6 +39,65 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   ASSERT_EQ(0, comparator(k1, k2));
 }
 
+TEST(BPlusTreeTests, GenericKeyOrderTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 0, true, true),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  const TableSchema key_schema(columns);
+  GenericComparator<32> comparator(const_cast<TableSchema *>(&key_schema));
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> int_dist(-1000, 1000);
+  std::uniform_real_distribution<float> float_dist(-10, 10);
+  const char *names[] = {"", "a", "ab", "abc", "b", "ba"};
+  auto random_fields = [&] {
+    const char *name = names[rng() % 6];
+    std::vector<Field> fields{
+            Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true),
+            rng() % 10 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, int_dist(rng)),
+            Field(TypeId::kTypeFloat, rng() % 10 == 0 ? 0.0f : float_dist(rng))
+    };
+    return fields;
+  };
+  // field by field comparison, null sorts first
+  auto compare_fields = [](std::vector<Field> &lhs, std::vector<Field> &rhs) {
+    for (size_t i = 0; i < lhs.size(); i++) {
+      if (lhs[i].IsNull() || rhs[i].IsNull()) {
+        if (lhs[i].IsNull() != rhs[i].IsNull()) {
+          return lhs[i].IsNull() ? -1 : 1;
+        }
+        continue;
+      }
+      if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::kTrue) return -1;
+      if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::kTrue) return 1;
+    }
+    return 0;
+  };
+  for (int i = 0; i < 2000; i++) {
+    auto lhs_fields = random_fields();
+    auto rhs_fields = random_fields();
+    Row lhs_row(lhs_fields);
+    Row rhs_row(rhs_fields);
+    INDEX_KEY_TYPE lhs, rhs;
+    lhs.SerializeFromKey(lhs_row, const_cast<TableSchema *>(&key_schema));
+    rhs.SerializeFromKey(rhs_row, const_cast<TableSchema *>(&key_schema));
+    int expected = compare_fields(lhs_fields, rhs_fields);
+    int actual = comparator(lhs, rhs);
+    ASSERT_EQ(expected, actual < 0 ? -1 : (actual > 0 ? 1 : 0));
+    // keys decode back to the same fields
+    Row decoded(INVALID_ROWID);
+    lhs.DeserializeToKey(decoded, const_cast<TableSchema *>(&key_schema));
+    std::vector<Field> decoded_fields;
+    for (auto field : decoded.GetFields()) {
+      decoded_fields.push_back(*field);
+    }
+    ASSERT_EQ(0, compare_fields(lhs_fields, decoded_fields));
+  }
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   using INDEX_KEY_TYPE = GenericKey<32>;
   using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
@@ -78,4 +142,618 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, DISABLED_BPlusTreeIndexLookupBenchmark) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  const int n = 20000;
+  char name[16];
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int i : keys) {
+    snprintf(name, sizeof(name), "name%d", i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i, 0), nullptr));
+  }
+  std::vector<RowId> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int i : keys) {
+    snprintf(name, sizeof(name), "name%d", i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(row, result, nullptr));
+    ASSERT_EQ(i, result[0].GetPageId());
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "lookup of (int, char) keys: " << elapsed.count() / n << "ns/lookup" << std::endl;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexScanRangeTest) {
+  using INDEX_KEY_TYPE = GenericKey<8>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<8>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, true)};
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  // even keys in [-1000, 1000), and a NULL key
+  for (int i = -1000; i < 1000; i += 2) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i + 1000, 0), nullptr));
+  }
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  Row null_row(null_fields);
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(null_row, RowId(5000, 0), nullptr));
+
+  auto scan = [&](const int *lo, bool lo_inclusive, const int *hi, bool hi_inclusive) {
+    std::vector<Field> lo_fields{Field(TypeId::kTypeInt, lo ? *lo : 0)};
+    std::vector<Field> hi_fields{Field(TypeId::kTypeInt, hi ? *hi : 0)};
+    Row lo_row(lo_fields), hi_row(hi_fields);
+    std::vector<RowId> result;
+    EXPECT_EQ(DB_SUCCESS, index->ScanRange(lo ? &lo_row : nullptr, lo_inclusive, hi ? &hi_row : nullptr,
+                                           hi_inclusive, result, nullptr));
+    std::vector<int> keys;
+    for (auto rid : result) {
+      keys.push_back(rid.GetPageId() - 1000);
+    }
+    return keys;
+  };
+  auto expected = [](int first, int last) {
+    std::vector<int> keys;
+    for (int i = first; i <= last; i += 2) {
+      keys.push_back(i);
+    }
+    return keys;
+  };
+  int lo = 10, hi = 20;
+  ASSERT_EQ(expected(10, 20), scan(&lo, true, &hi, true));
+  ASSERT_EQ(expected(12, 18), scan(&lo, false, &hi, false));
+  // bounds between keys
+  lo = 11, hi = 19;
+  ASSERT_EQ(expected(12, 18), scan(&lo, false, &hi, true));
+  ASSERT_EQ(expected(12, 18), scan(&lo, true, &hi, false));
+  // no lower bound skips NULL, no upper bound runs to the end
+  hi = -990;
+  ASSERT_EQ(expected(-1000, -990), scan(nullptr, false, &hi, true));
+  lo = 990;
+  ASSERT_EQ(expected(990, 998), scan(&lo, true, nullptr, false));
+  ASSERT_EQ(expected(-1000, 998), scan(nullptr, false, nullptr, false));
+  // empty ranges
+  lo = 998;
+  ASSERT_TRUE(scan(&lo, false, nullptr, false).empty());
+  lo = 20, hi = 10;
+  ASSERT_TRUE(scan(&lo, true, &hi, true).empty());
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexDuplicateKeyTest) {
+  using INDEX_KEY_TYPE = GenericKey<16>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<16>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+                                   ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 1, true, false)};
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> unique_key_map{0};
+  std::vector<uint32_t> key_map{1};
+  auto *unique_index = ALLOC(heap, BP_TREE_INDEX)(0, Schema::ShallowCopySchema(&table_schema, unique_key_map, &heap),
+                                                  engine.bpm_);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(1, Schema::ShallowCopySchema(&table_schema, key_map, &heap), engine.bpm_);
+  ASSERT_TRUE(unique_index->IsUnique());
+  ASSERT_FALSE(index->IsUnique());
+  auto key_of = [](int value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    return Row(fields);
+  };
+  // 1000 rows over 10 ages, inserted in random order
+  const int n = 1000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  ShuffleArray(ids);
+  for (int id : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(id % 10), RowId(id, 0), nullptr));
+  }
+  ASSERT_EQ(DB_SUCCESS, unique_index->InsertEntry(key_of(1), RowId(1, 0), nullptr));
+  ASSERT_EQ(DB_FAILED, unique_index->InsertEntry(key_of(1), RowId(2, 0), nullptr));
+  // every row of a key, in RowId order
+  for (int age = 0; age < 10; age++) {
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(age), result, nullptr));
+    ASSERT_EQ(n / 10, result.size());
+    for (size_t i = 0; i < result.size(); i++) {
+      ASSERT_EQ(static_cast<int>(i * 10) + age, result[i].GetPageId());
+    }
+  }
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(key_of(10), result, nullptr));
+  // range bounds include or exclude all the duplicates of the bound
+  Row lo = key_of(3), hi = key_of(5);
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&lo, true, &hi, true, result, nullptr));
+  ASSERT_EQ(3 * n / 10, result.size());
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&lo, false, &hi, false, result, nullptr));
+  ASSERT_EQ(n / 10, result.size());
+  for (auto rid : result) {
+    ASSERT_EQ(4, rid.GetPageId() % 10);
+  }
+  // removing a row only removes its own entry
+  for (int id = 0; id < n; id++) {
+    if (id / 10 % 2 == 0) {
+      ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key_of(id % 10), RowId(id, 0), nullptr));
+    }
+  }
+  for (int age = 0; age < 10; age++) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(age), result, nullptr));
+    ASSERT_EQ(n / 20, result.size());
+    for (auto rid : result) {
+      ASSERT_EQ(1, rid.GetPageId() / 10 % 2);
+    }
+  }
+}
+
+TEST(BPlusTreeTests, DISABLED_BPlusTreeIndexScanRangeBenchmark) {
+  using INDEX_KEY_TYPE = GenericKey<8>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<8>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &table_schema, nullptr, nullptr, nullptr, &heap);
+  const int n = 200000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  char name[16];
+  for (int id : ids) {
+    snprintf(name, sizeof(name), "name%d", id);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key, row.GetRowId(), nullptr));
+  }
+  // 1% of the rows: lo <= id < hi
+  const int lo = n / 2, hi = lo + n / 100;
+  Field lo_field(TypeId::kTypeInt, lo), hi_field(TypeId::kTypeInt, hi);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<RowId> scanned;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    Row row(iter->GetRowId());
+    table_heap->GetTuple(&row, nullptr);
+    const Field *id = row.GetField(0);
+    if (id->CompareGreaterThanEquals(lo_field) == kTrue && id->CompareLessThan(hi_field) == kTrue) {
+      scanned.push_back(iter->GetRowId());
+    }
+  }
+  auto scan_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<Field> lo_key_fields{Field(TypeId::kTypeInt, lo)};
+  std::vector<Field> hi_key_fields{Field(TypeId::kTypeInt, hi)};
+  Row lo_key(lo_key_fields), hi_key(hi_key_fields);
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&lo_key, true, &hi_key, false, result, nullptr));
+  for (auto rid : result) {
+    Row row(rid);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+  }
+  auto index_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  ASSERT_EQ(static_cast<size_t>(hi - lo), result.size());
+  std::sort(scanned.begin(), scanned.end(), [](RowId a, RowId b) { return a.Get() < b.Get(); });
+  std::sort(result.begin(), result.end(), [](RowId a, RowId b) { return a.Get() < b.Get(); });
+  ASSERT_EQ(scanned, result);
+  LOG(INFO) << "1% range of " << n << " rows: table scan " << scan_elapsed.count() << "us, index range scan "
+            << index_elapsed.count() << "us" << std::endl;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexBulkLoadTest) {
+  using INDEX_KEY_TYPE = GenericKey<16>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<16>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &table_schema, nullptr, nullptr, nullptr, &heap);
+  const int n = 20000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i / 2;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  char name[16];
+  for (int id : ids) {
+    snprintf(name, sizeof(name), "name%d", id);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  // the default implementation inserts row by row
+  auto *inserted = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  ASSERT_EQ(DB_SUCCESS, inserted->Index::BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+  auto *loaded = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_);
+  ASSERT_EQ(DB_SUCCESS, loaded->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+  ASSERT_EQ(DB_FAILED, loaded->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+
+  // both hold the same entries in the same order
+  auto inserted_iter = inserted->GetBeginIterator();
+  auto loaded_iter = loaded->GetBeginIterator();
+  int count = 0;
+  for (; loaded_iter != loaded->GetEndIterator(); ++loaded_iter, ++inserted_iter, count++) {
+    ASSERT_TRUE(inserted_iter != inserted->GetEndIterator());
+    ASSERT_EQ((*inserted_iter).second, (*loaded_iter).second);
+  }
+  ASSERT_TRUE(inserted_iter == inserted->GetEndIterator());
+  ASSERT_EQ(n, count);
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, n / 4)};
+  Row key(key_fields);
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, loaded->ScanKey(key, result, nullptr));
+  ASSERT_EQ(2, result.size());
+
+  // parallel builds produce the same index
+  index_id_t index_id = 2;
+  for (size_t num_threads : {2, 4}) {
+    auto *parallel = ALLOC(heap, BP_TREE_INDEX)(index_id++, index_schema, engine.bpm_);
+    ASSERT_EQ(DB_SUCCESS, parallel->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, num_threads, nullptr));
+    auto parallel_iter = parallel->GetBeginIterator();
+    for (auto iter = loaded->GetBeginIterator(); iter != loaded->GetEndIterator(); ++iter, ++parallel_iter) {
+      ASSERT_TRUE(parallel_iter != parallel->GetEndIterator());
+      ASSERT_EQ((*iter).second, (*parallel_iter).second);
+    }
+    ASSERT_TRUE(parallel_iter == parallel->GetEndIterator());
+    ASSERT_EQ(loaded->GetPageCount(), parallel->GetPageCount());
+  }
+}
+
+TEST(BPlusTreeTests, DISABLED_BPlusTreeIndexBulkLoadBenchmark) {
+  using INDEX_KEY_TYPE = GenericKey<16>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<16>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)};
+  TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &table_schema, nullptr, nullptr, nullptr, &heap);
+  const int n = 200000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i / 2;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  char name[16];
+  for (int id : ids) {
+    snprintf(name, sizeof(name), "name%d", id);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  auto *inserted = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto start = std::chrono::steady_clock::now();
+  // the default implementation inserts row by row
+  ASSERT_EQ(DB_SUCCESS, inserted->Index::BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+  auto insert_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  auto *loaded = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_);
+  start = std::chrono::steady_clock::now();
+  ASSERT_EQ(DB_SUCCESS, loaded->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+  auto load_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "index build over " << n << " rows: inserts " << insert_elapsed.count() << "us "
+            << inserted->GetPageCount() << " pages, bulk load " << load_elapsed.count() << "us "
+            << loaded->GetPageCount() << " pages" << std::endl;
+
+  index_id_t index_id = 2;
+  for (size_t num_threads : {2, 4, 8, 16}) {
+    auto *parallel = ALLOC(heap, BP_TREE_INDEX)(index_id++, index_schema, engine.bpm_);
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(DB_SUCCESS, parallel->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, num_threads, nullptr));
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << "bulk load with " << num_threads << " threads: " << elapsed.count() << "us" << std::endl;
+  }
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexFixedKeyTest) {
+  using INT_INDEX = BPlusTreeIndex<FixedKey<int32_t>, RowId, FixedComparator<int32_t>>;
+  using FLOAT_INDEX = BPlusTreeIndex<FixedKey<float_t>, RowId, FixedComparator<float_t>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+                                   ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 1, false, true)};
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> int_key_map{0};
+  std::vector<uint32_t> float_key_map{1};
+  auto *int_schema = Schema::ShallowCopySchema(&table_schema, int_key_map, &heap);
+  auto *float_schema = Schema::ShallowCopySchema(&table_schema, float_key_map, &heap);
+  auto *int_index = ALLOC(heap, INT_INDEX)(0, int_schema, engine.bpm_);
+  auto *float_index = ALLOC(heap, FLOAT_INDEX)(1, float_schema, engine.bpm_);
+  ASSERT_TRUE(int_index->IsUnique());
+  std::vector<int> keys;
+  for (int i = -1000; i < 1000; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int i : keys) {
+    std::vector<Field> int_fields{Field(TypeId::kTypeInt, i)};
+    std::vector<Field> float_fields{Field(TypeId::kTypeFloat, i / 4.0f)};
+    Row int_row(int_fields), float_row(float_fields);
+    ASSERT_EQ(DB_SUCCESS, int_index->InsertEntry(int_row, RowId(i + 1000, 0), nullptr));
+    ASSERT_EQ(DB_SUCCESS, float_index->InsertEntry(float_row, RowId(i + 1000, 0), nullptr));
+  }
+  // keys are unique
+  std::vector<Field> dup_fields{Field(TypeId::kTypeInt, 5)};
+  Row dup_row(dup_fields);
+  ASSERT_EQ(DB_FAILED, int_index->InsertEntry(dup_row, RowId(1, 1), nullptr));
+  // -0.0 finds 0.0
+  std::vector<Field> zero_fields{Field(TypeId::kTypeFloat, -0.0f)};
+  Row zero_row(zero_fields);
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, float_index->ScanKey(zero_row, result, nullptr));
+  ASSERT_EQ(1, result.size());
+  ASSERT_EQ(1000, result[0].GetPageId());
+
+  // negative keys sort before positive ones
+  std::vector<Field> lo_fields{Field(TypeId::kTypeInt, -3)};
+  std::vector<Field> hi_fields{Field(TypeId::kTypeInt, 2)};
+  Row lo_row(lo_fields), hi_row(hi_fields);
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, int_index->ScanRange(&lo_row, false, &hi_row, true, result, nullptr));
+  std::vector<int> found;
+  for (auto rid : result) {
+    found.push_back(rid.GetPageId() - 1000);
+  }
+  ASSERT_EQ((std::vector<int>{-2, -1, 0, 1, 2}), found);
+  std::vector<Field> float_hi_fields{Field(TypeId::kTypeFloat, -249.5f)};
+  Row float_hi_row(float_hi_fields);
+  result.clear();
+  ASSERT_EQ(DB_SUCCESS, float_index->ScanRange(nullptr, false, &float_hi_row, false, result, nullptr));
+  ASSERT_EQ(2, result.size());
+  ASSERT_EQ(0, result[0].GetPageId());
+  ASSERT_EQ(1, result[1].GetPageId());
+
+  // iterate in order and decode the keys back
+  int expected = -1000;
+  for (auto iter = int_index->GetBeginIterator(); iter != int_index->GetEndIterator(); ++iter, expected++) {
+    Row decoded(INVALID_ROWID);
+    (*iter).first.DeserializeToKey(decoded, int_schema);
+    ASSERT_EQ(kTrue, decoded.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, expected)));
+  }
+  ASSERT_EQ(1000, expected);
+}
+
+/**
+ * Insert and lookup of a single unique int column, keyed on the native value, on the generic key the column now
+ * gets, and on the GenericKey<32> it used to get when the key size counted a RowId suffix for unique keys
+ */
+template<typename KeyType, typename KeyComparator>
+static void BenchmarkIntKeyIndex(const std::string &name, const std::vector<int> &keys) {
+  using BP_TREE_INDEX = BPlusTreeIndex<KeyType, RowId, KeyComparator>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true)};
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto start = std::chrono::steady_clock::now();
+  for (int i : keys) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row, RowId(i, 0), nullptr));
+  }
+  auto insert_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  std::vector<RowId> result;
+  start = std::chrono::steady_clock::now();
+  for (int i : keys) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(row, result, nullptr));
+    ASSERT_EQ(i, result[0].GetPageId());
+  }
+  auto lookup_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  // GenericKey leaves are prefix compressed, the entries per page are measured
+  LOG(INFO) << name << ": " << keys.size() / index->GetPageCount() << " entries/page, " << index->GetPageCount()
+            << " pages, "
+            << insert_elapsed.count() / keys.size() << "ns/insert, " << lookup_elapsed.count() / keys.size()
+            << "ns/lookup" << std::endl;
+}
+
+TEST(BPlusTreeTests, DISABLED_BPlusTreeIndexFixedKeyBenchmark) {
+  const int n = 100000;
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  BenchmarkIntKeyIndex<FixedKey<int32_t>, FixedComparator<int32_t>>("FixedKey<int32_t>", keys);
+  BenchmarkIntKeyIndex<GenericKey<8>, GenericComparator<8>>("GenericKey<8>", keys);
+  BenchmarkIntKeyIndex<GenericKey<32>, GenericComparator<32>>("GenericKey<32>", keys);
+}
+
+/**
+ * Urls sharing long prefixes, in a unique index of GenericKey<64>
+ */
+static std::string MakeUrl(int id) {
+  char url[64];
+  snprintf(url, sizeof(url), "https://www.example.com/users/%08d/profile", id);
+  return url;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexPrefixCompressionTest) {
+  using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("url", TypeId::kTypeChar, 48, 0, false, true)};
+  TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  const int n = 20000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i * 3;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  auto make_row = [](int id, std::string &url) {
+    url = MakeUrl(id);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(url.c_str()), url.size(), true)};
+    return Row(fields);
+  };
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  std::string url;
+  for (int id : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_row(id, url), RowId(id, 0), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_row(ids[0], url), RowId(ids[0], 1), nullptr));
+  // a fixed width leaf holds 55 entries of GenericKey<64>
+  size_t fixed_leaf_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, RowId>) - 1;
+  ASSERT_LT(index->GetPageCount(), n / fixed_leaf_size);
+  std::vector<RowId> result;
+  for (int id : ids) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_row(id, url), result, nullptr));
+    ASSERT_EQ(id, result[0].GetPageId());
+  }
+  // keys between the stored ones, before and after all of them are not found
+  for (int id : {-1, 1, 3 * n / 2 + 1, 3 * n}) {
+    ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(make_row(id, url), result, nullptr));
+  }
+
+  // removing most of the keys redistributes and merges the leaves
+  for (int i = 0; i < n; i++) {
+    if (i % 4 != 0) {
+      ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(make_row(ids[i], url), RowId(ids[i], 0), nullptr));
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    result.clear();
+    ASSERT_EQ(i % 4 == 0 ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(make_row(ids[i], url), result, nullptr));
+  }
+  std::vector<int> kept;
+  for (int i = 0; i < n; i += 4) {
+    kept.push_back(ids[i]);
+  }
+  std::sort(kept.begin(), kept.end());
+  size_t count = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter, count++) {
+    ASSERT_EQ(kept[count], (*iter).second.GetPageId());
+  }
+  ASSERT_EQ(kept.size(), count);
+
+  // bulk loading fills the leaves by bytes, and the tree keeps working after it
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &table_schema, nullptr, nullptr, nullptr, &heap);
+  for (int id : ids) {
+    Row row = make_row(id, url);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  for (double fill_factor : {0.5, 1.0}) {
+    auto *loaded = ALLOC(heap, BP_TREE_INDEX)(fill_factor < 1 ? 1 : 2, index_schema, engine.bpm_);
+    ASSERT_EQ(DB_SUCCESS, loaded->BulkLoad(table_heap, index_key_map, fill_factor, 1, nullptr));
+    std::vector<int> sorted_ids(ids);
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    count = 0;
+    for (auto iter = loaded->GetBeginIterator(); iter != loaded->GetEndIterator(); ++iter, count++) {
+      GenericKey<64> key;
+      key.SerializeFromKey(make_row(sorted_ids[count], url), index_schema);
+      ASSERT_EQ(0, memcmp(key.data, (*iter).first.data, sizeof(key.data)));
+    }
+    ASSERT_EQ(sorted_ids.size(), count);
+    for (int i = 0; i < n; i++) {
+      std::string between;
+      ASSERT_EQ(DB_SUCCESS, loaded->InsertEntry(make_row(ids[i] + 1, between), RowId(ids[i] + 1, 0), nullptr));
+      if (i % 2 == 0) {
+        ASSERT_EQ(DB_SUCCESS, loaded->RemoveEntry(make_row(ids[i], url), RowId(ids[i], 0), nullptr));
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      result.clear();
+      ASSERT_EQ(i % 2 == 0 ? DB_KEY_NOT_FOUND : DB_SUCCESS, loaded->ScanKey(make_row(ids[i], url), result, nullptr));
+      ASSERT_EQ(DB_SUCCESS, loaded->ScanKey(make_row(ids[i] + 1, url), result, nullptr));
+    }
+  }
+}
+
+TEST(BPlusTreeTests, DISABLED_BPlusTreeIndexPrefixCompressionBenchmark) {
+  using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("url", TypeId::kTypeChar, 48, 0, false, true)};
+  TableSchema table_schema(columns);
+  std::vector<uint32_t> index_key_map{0};
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &table_schema, nullptr, nullptr, nullptr, &heap);
+  const int n = 100000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  std::vector<Row> keys;
+  std::vector<std::string> urls;
+  for (int id : ids) {
+    urls.push_back(MakeUrl(id));
+  }
+  for (auto &url : urls) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(url.c_str()), url.size(), true)};
+    keys.emplace_back(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(keys.back(), nullptr));
+  }
+  auto *inserted = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, inserted->InsertEntry(keys[i], RowId(ids[i], 0), nullptr));
+  }
+  auto *loaded = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_);
+  ASSERT_EQ(DB_SUCCESS, loaded->BulkLoad(table_heap, index_key_map, DEFAULT_INDEX_FILL_FACTOR, 1, nullptr));
+  std::vector<RowId> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, loaded->ScanKey(keys[i], result, nullptr));
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  size_t fixed_leaf_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, RowId>) - 1;
+  LOG(INFO) << n << " urls in GenericKey<64>: fixed width leaves hold " << fixed_leaf_size << " entries, "
+            << "inserted " << inserted->GetPageCount() << " pages (" << n / inserted->GetPageCount()
+            << " entries/page), bulk loaded " << loaded->GetPageCount() << " pages (" << n / loaded->GetPageCount()
+            << " entries/page), " << elapsed.count() / n << "ns/lookup" << std::endl;
+}
@@ -60,4 +60,71 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  using IntBPlusTree = BPlusTree<int, int, BasicComparator<int>>;
+  int index_id = 0;
+  for (int n : {0, 1, 5, 100, 5000}) {
+    for (double fill_factor : {0.5, 0.9, 1.0}) {
+      IntBPlusTree tree(index_id++, engine.bpm_, comparator, 8, 8);
+      int next_key = 0;
+      ASSERT_TRUE(tree.BulkLoad(n, [&](std::pair<int, int> &entry) {
+        entry = {next_key * 2, next_key};
+        return ++next_key <= n;
+      }, fill_factor));
+      ASSERT_EQ(n == 0, tree.IsEmpty());
+      ASSERT_TRUE(tree.Check());
+      // the leaves are linked in key order
+      int expected = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expected++) {
+        ASSERT_EQ(expected * 2, (*iter).first);
+        ASSERT_EQ(expected, (*iter).second);
+      }
+      ASSERT_EQ(n, expected);
+      // the tree keeps working with inserts into the gaps and removes
+      std::vector<int> result;
+      for (int i = 0; i < n; i++) {
+        ASSERT_TRUE(tree.GetValue(i * 2, result));
+        ASSERT_EQ(i, result.back());
+        ASSERT_TRUE(tree.Insert(i * 2 + 1, i));
+      }
+      for (int i = 0; i < 2 * n; i += 3) {
+        tree.Remove(i);
+      }
+      for (int i = 0; i < 2 * n; i++) {
+        ASSERT_EQ(i % 3 != 0, tree.GetValue(i, result));
+      }
+      ASSERT_TRUE(tree.Check());
+    }
+  }
+  // a smaller fill factor leaves more room in more pages
+  IntBPlusTree loose(index_id++, engine.bpm_, comparator, 8, 8);
+  IntBPlusTree dense(index_id++, engine.bpm_, comparator, 8, 8);
+  int next_key = 0;
+  ASSERT_TRUE(loose.BulkLoad(1000, [&](std::pair<int, int> &entry) {
+    entry = {next_key, next_key};
+    return ++next_key <= 1000;
+  }, 0.5));
+  next_key = 0;
+  ASSERT_TRUE(dense.BulkLoad(1000, [&](std::pair<int, int> &entry) {
+    entry = {next_key, next_key};
+    return ++next_key <= 1000;
+  }, 1.0));
+  ASSERT_GT(loose.GetPageCount(), dense.GetPageCount());
+  // fails on a tree that is not empty, or on keys out of order
+  ASSERT_FALSE(dense.BulkLoad(1, [](std::pair<int, int> &entry) {
+    entry = {0, 0};
+    return true;
+  }));
+  IntBPlusTree unordered(index_id++, engine.bpm_, comparator, 8, 8);
+  next_key = 0;
+  ASSERT_FALSE(unordered.BulkLoad(100, [&](std::pair<int, int> &entry) {
+    entry = {next_key == 50 ? 0 : next_key, next_key};
+    return ++next_key <= 100;
+  }));
+  ASSERT_TRUE(unordered.IsEmpty());
+  ASSERT_TRUE(unordered.Check());
+}
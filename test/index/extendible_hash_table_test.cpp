@@ -0,0 +1,191 @@
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
+#include "index/extendible_hash_table.h"
+#include "index/generic_key.h"
+#include "index/hash_index.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "extendible_hash_table_test.db";
+
+TEST(ExtendibleHashTableTests, SampleTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // tiny buckets to split and merge often
+  ExtendibleHashTable<int, int, BasicComparator<int>> table(0, engine.bpm_, comparator, 2, 9, 4);
+  const int n = 500;
+  vector<int> keys;
+  vector<int> delete_seq;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+    delete_seq.push_back(i);
+  }
+  ShuffleArray(keys);
+  ShuffleArray(delete_seq);
+  ASSERT_TRUE(table.IsEmpty());
+  for (int key : keys) {
+    ASSERT_TRUE(table.Insert(key, key * 2));
+  }
+  ASSERT_FALSE(table.IsEmpty());
+  ASSERT_TRUE(table.Check());
+  // keys are unique
+  ASSERT_FALSE(table.Insert(keys[0], 0));
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(table.GetValue(i, ans));
+    ASSERT_EQ(1, ans.size());
+    ASSERT_EQ(i * 2, ans[0]);
+  }
+  ASSERT_FALSE(table.GetValue(n, ans));
+  // Delete half keys
+  for (int i = 0; i < n / 2; i++) {
+    ASSERT_TRUE(table.Remove(delete_seq[i]));
+  }
+  ASSERT_FALSE(table.Remove(delete_seq[0]));
+  ASSERT_TRUE(table.Check());
+  for (int i = 0; i < n / 2; i++) {
+    ASSERT_FALSE(table.GetValue(delete_seq[i], ans));
+  }
+  for (int i = n / 2; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(table.GetValue(delete_seq[i], ans));
+    ASSERT_EQ(delete_seq[i] * 2, ans[0]);
+  }
+  // empty buckets merge back, and insert again
+  for (int i = n / 2; i < n; i++) {
+    ASSERT_TRUE(table.Remove(delete_seq[i]));
+  }
+  ASSERT_TRUE(table.Check());
+  for (int key : keys) {
+    ASSERT_TRUE(table.Insert(key, key));
+  }
+  ASSERT_TRUE(table.Check());
+  table.Destroy();
+  ASSERT_TRUE(table.IsEmpty());
+  ASSERT_FALSE(table.GetValue(keys[0], ans));
+  ASSERT_TRUE(table.Check());
+}
+
+TEST(ExtendibleHashTableTests, FullTableTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // a single directory of at most 4 buckets of 2 entries
+  ExtendibleHashTable<int, int, BasicComparator<int>> table(0, engine.bpm_, comparator, 0, 2, 2);
+  std::vector<int> inserted;
+  for (int i = 0; i < 100; i++) {
+    if (table.Insert(i, i)) {
+      inserted.push_back(i);
+    }
+  }
+  ASSERT_LE(inserted.size(), 8);
+  ASSERT_GE(inserted.size(), 2);
+  ASSERT_TRUE(table.Check());
+  vector<int> ans;
+  for (int key : inserted) {
+    ASSERT_TRUE(table.GetValue(key, ans));
+  }
+  table.Destroy();
+  ASSERT_TRUE(table.Check());
+}
+
+TEST(ExtendibleHashTableTests, HashIndexTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using HASH_INDEX = HashIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *hash_index = ALLOC(heap, HASH_INDEX)(0, index_schema, engine.bpm_);
+  const int n = 2000;
+  char name[16];
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  auto make_row = [&name](int i) {
+    snprintf(name, sizeof(name), "name%d", i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    return Row(fields);
+  };
+  for (int i : keys) {
+    ASSERT_EQ(DB_SUCCESS, hash_index->InsertEntry(make_row(i), RowId(i, 0), nullptr));
+  }
+  ASSERT_TRUE(hash_index->Check());
+  std::vector<RowId> result;
+  // a hash index has no order to scan a range in
+  ASSERT_EQ(DB_FAILED, hash_index->ScanRange(nullptr, true, nullptr, true, result, nullptr));
+  for (int i : keys) {
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, hash_index->ScanKey(make_row(i), result, nullptr));
+    ASSERT_EQ(i, result[0].GetPageId());
+  }
+  // removed keys are gone
+  for (int i = 0; i < n; i += 2) {
+    ASSERT_EQ(DB_SUCCESS, hash_index->RemoveEntry(make_row(i), RowId(i, 0), nullptr));
+    result.clear();
+    ASSERT_EQ(DB_KEY_NOT_FOUND, hash_index->ScanKey(make_row(i), result, nullptr));
+  }
+  ASSERT_TRUE(hash_index->Check());
+  hash_index->Destroy();
+}
+
+TEST(ExtendibleHashTableTests, DISABLED_HashIndexLookupBenchmark) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  using HASH_INDEX = HashIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, true),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *tree_index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto *hash_index = ALLOC(heap, HASH_INDEX)(1, index_schema, engine.bpm_);
+  const int n = 20000;
+  char name[16];
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int i : keys) {
+    snprintf(name, sizeof(name), "name%d", i % 100);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, tree_index->InsertEntry(row, RowId(i, 0), nullptr));
+    ASSERT_EQ(DB_SUCCESS, hash_index->InsertEntry(row, RowId(i, 0), nullptr));
+  }
+  std::vector<RowId> result;
+  for (Index *index : std::vector<Index *>{tree_index, hash_index}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i : keys) {
+      snprintf(name, sizeof(name), "name%d", i % 100);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, strlen(name), true)};
+      Row row(fields);
+      result.clear();
+      ASSERT_EQ(DB_SUCCESS, index->ScanKey(row, result, nullptr));
+      ASSERT_EQ(i, result[0].GetPageId());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << (index == tree_index ? "b+ tree" : "hash") << " lookup of (int, char) keys: " << elapsed.count() / n
+              << "ns/lookup" << std::endl;
+  }
+  hash_index->Destroy();
+}
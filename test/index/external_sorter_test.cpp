@@ -0,0 +1,34 @@
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "index/external_sorter.h"
+
+TEST(ExternalSorterTest, SortTest) {
+  auto less = [](const int &lhs, const int &rhs) { return lhs < rhs; };
+  std::mt19937 rng(0);
+  // fits in memory, spills a few runs, spills many runs
+  for (size_t buffer_size : {size_t(1) << 20, sizeof(int) * 1000, sizeof(int) * 7}) {
+    ExternalSorter<int, decltype(less)> sorter(less, buffer_size);
+    std::vector<int> expected;
+    for (int i = 0; i < 10000; i++) {
+      int value = static_cast<int>(rng() % 5000);
+      sorter.Add(value);
+      expected.push_back(value);
+    }
+    sorter.Sort();
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected.size(), sorter.GetCount());
+    ASSERT_EQ(buffer_size == size_t(1) << 20, sorter.GetRunCount() == 0);
+    int value;
+    for (int expected_value : expected) {
+      ASSERT_TRUE(sorter.Next(value));
+      ASSERT_EQ(expected_value, value);
+    }
+    ASSERT_FALSE(sorter.Next(value));
+  }
+  ExternalSorter<int, decltype(less)> empty(less);
+  empty.Sort();
+  int value;
+  ASSERT_FALSE(empty.Next(value));
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/rowid.h"
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "page/b_plus_tree_key_search.h"
+
+template<typename T, typename V>
+static void CheckFixedKeySearch(std::mt19937 &rng) {
+  using Entry = std::pair<FixedKey<T>, V>;
+  using Search = KeySearch<FixedKey<T>, FixedComparator<T>>;
+  FixedComparator<T> comparator(nullptr);
+  std::uniform_int_distribution<int> dist(-50, 50);
+  for (int n = 0; n < 200; n++) {
+    // duplicates, so lower and upper bound differ
+    std::vector<T> values(n);
+    for (auto &value : values) {
+      value = static_cast<T>(dist(rng)) / 2;
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<Entry> entries(n);
+    for (int i = 0; i < n; i++) {
+      entries[i].first.value = values[i];
+    }
+    for (int probe = -52; probe <= 52; probe++) {
+      FixedKey<T> key{static_cast<T>(probe) / 2};
+      int begin = n > 0 ? static_cast<int>(rng() % n) : 0;
+      int lower = std::lower_bound(values.begin() + begin, values.end(), key.value) - values.begin();
+      int upper = std::upper_bound(values.begin() + begin, values.end(), key.value) - values.begin();
+      ASSERT_EQ(lower, Search::LowerBound(entries.data(), begin, n, key, comparator));
+      ASSERT_EQ(upper, Search::UpperBound(entries.data(), begin, n, key, comparator));
+      ASSERT_EQ(lower, (BinaryKeySearch<FixedKey<T>, FixedComparator<T>>::LowerBound(entries.data(), begin, n, key,
+                                                                                     comparator)));
+    }
+  }
+}
+
+TEST(PageTests, FixedKeySearchTest) {
+  std::mt19937 rng(0);
+  // leaf and internal page entries
+  CheckFixedKeySearch<int32_t, RowId>(rng);
+  CheckFixedKeySearch<int32_t, page_id_t>(rng);
+  CheckFixedKeySearch<float_t, RowId>(rng);
+  CheckFixedKeySearch<float_t, page_id_t>(rng);
+}
+
+/**
+ * Lookup of random keys in a page of n int keys, by binary search through the comparator and by the fixed key search
+ */
+template<typename V>
+static void BenchmarkKeySearch(int n) {
+  using Entry = std::pair<FixedKey<int32_t>, V>;
+  FixedComparator<int32_t> comparator(nullptr);
+  std::vector<Entry> entries(n);
+  for (int i = 0; i < n; i++) {
+    entries[i].first.value = i * 2;
+  }
+  const int lookups = 1000000;
+  std::vector<FixedKey<int32_t>> keys(lookups);
+  std::mt19937 rng(0);
+  for (auto &key : keys) {
+    key.value = static_cast<int32_t>(rng() % (2 * n));
+  }
+  int64_t checksum[2] = {0, 0};
+  int64_t elapsed[2];
+  for (int kind = 0; kind < 2; kind++) {
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &key : keys) {
+      checksum[kind] += kind == 0 ? BinaryKeySearch<FixedKey<int32_t>, FixedComparator<int32_t>>::LowerBound(
+                                            entries.data(), 0, n, key, comparator)
+                                  : FixedKeySearch<int32_t>::LowerBound(entries.data(), 0, n, key, comparator);
+    }
+    elapsed[kind] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+            .count();
+  }
+  ASSERT_EQ(checksum[0], checksum[1]);
+  LOG(INFO) << "search in " << n << " keys of " << sizeof(Entry) << " byte entries: binary "
+            << elapsed[0] * 1000 / lookups << "ps, fixed key " << elapsed[1] * 1000 / lookups << "ps" << std::endl;
+}
+
+TEST(PageTests, DISABLED_KeySearchBenchmark) {
+  for (int n : {8, 32, 64, 128, 338}) {
+    BenchmarkKeySearch<RowId>(n);
+  }
+  for (int n : {8, 32, 64, 128, 510}) {
+    BenchmarkKeySearch<page_id_t>(n);
+  }
+}
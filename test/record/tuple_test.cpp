@@ -1,10 +1,12 @@
 #include <cstring>
+#include <string>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {
@@ -117,4 +119,178 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+static std::vector<Field> MakeRowFields(int mask) {
+  return {
+          mask & 1 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, -mask),
+          mask & 2 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, chars[mask % 3], strlen(chars[mask % 3]), false),
+          mask & 4 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, mask * 1.5f),
+          mask & 8 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, chars[1], strlen(chars[1]), false)
+  };
+}
+
+/**
+ * Writes fields in the legacy row format, as pages written before the compact format hold them
+ */
+static uint32_t SerializeLegacy(const std::vector<Field> &fields, Schema *schema, char *buf) {
+  uint32_t count = fields.size();
+  MACH_WRITE_TO(RowId, buf, INVALID_ROWID);
+  MACH_WRITE_UINT32(buf + sizeof(RowId), count);
+  uint32_t offset = sizeof(RowId) + sizeof(uint32_t) + count * sizeof(bool);
+  for (uint32_t i = 0; i < count; i++) {
+    MACH_WRITE_TO(bool, buf + sizeof(RowId) + sizeof(uint32_t) + i, fields[i].IsNull());
+    buf[offset++] = "123"[schema->GetColumn(i)->GetType() - TypeId::kTypeInt];
+    offset += fields[i].SerializeTo(buf + offset);
+  }
+  return offset;
+}
+
+static void CheckTuple(TablePage &table_page, Schema *schema, const RowId &rid, const std::vector<Field> &fields) {
+  Row row(rid);
+  ASSERT_TRUE(table_page.GetTuple(&row, schema, nullptr, nullptr));
+  ASSERT_EQ(rid, row.GetRowId());
+  uint32_t size;
+  RowFormat format;
+  const char *data = table_page.GetTupleData(rid, &size, &format);
+  ASSERT_TRUE(data != nullptr);
+  RowView view(data, size, format, schema, rid);
+  Row materialized(INVALID_ROWID);
+  view.Materialize(&materialized);
+  ASSERT_EQ(rid, materialized.GetRowId());
+  ASSERT_EQ(fields.size(), view.GetFieldCount());
+  ASSERT_EQ(fields.size(), row.GetFieldCount());
+  ASSERT_EQ(fields.size(), materialized.GetFieldCount());
+  for (uint32_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(fields[i].IsNull(), row.GetField(i)->IsNull());
+    ASSERT_EQ(fields[i].IsNull(), materialized.GetField(i)->IsNull());
+    ASSERT_EQ(fields[i].IsNull(), view.IsNull(i));
+    if (fields[i].IsNull()) {
+      continue;
+    }
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(i)->CompareEquals(fields[i]));
+    ASSERT_EQ(CmpBool::kTrue, materialized.GetField(i)->CompareEquals(fields[i]));
+    switch (schema->GetColumn(i)->GetType()) {
+      case TypeId::kTypeInt:
+        ASSERT_EQ(CmpBool::kTrue, Field(TypeId::kTypeInt, view.GetInt(i)).CompareEquals(fields[i]));
+        break;
+      case TypeId::kTypeFloat:
+        ASSERT_EQ(CmpBool::kTrue, Field(TypeId::kTypeFloat, view.GetFloat(i)).CompareEquals(fields[i]));
+        break;
+      default:
+        ASSERT_EQ(std::string(fields[i].GetData(), fields[i].GetLength()), view.GetChars(i));
+        break;
+    }
+  }
+}
+
+class RowFormatTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, true, false),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 64, 1, true, false),
+            ALLOC_COLUMN(heap_)("account", TypeId::kTypeFloat, 2, true, false),
+            ALLOC_COLUMN(heap_)("city", TypeId::kTypeChar, 16, 3, true, false)
+    };
+    schema_ = std::make_shared<Schema>(columns);
+    table_page_.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  }
+
+  SimpleMemHeap heap_;
+  std::shared_ptr<Schema> schema_;
+  TablePage table_page_;
+};
+
+TEST_F(RowFormatTest, RowViewTest) {
+  // every combination of null columns, so each field follows both null and non null fields
+  std::vector<RowId> rids;
+  for (int mask = 0; mask < 16; mask++) {
+    std::vector<Field> fields = MakeRowFields(mask);
+    Row row(fields);
+    ASSERT_TRUE(table_page_.InsertTuple(row, schema_.get(), nullptr, nullptr, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  for (int mask = 0; mask < 16; mask++) {
+    CheckTuple(table_page_, schema_.get(), rids[mask], MakeRowFields(mask));
+  }
+  ASSERT_TRUE(table_page_.MarkDelete(rids[0], nullptr, nullptr, nullptr));
+  table_page_.ApplyDelete(rids[0], nullptr, nullptr);
+  uint32_t size;
+  RowFormat format;
+  ASSERT_TRUE(table_page_.GetTupleData(rids[0], &size, &format) == nullptr);
+}
+
+TEST_F(RowFormatTest, CompactFormatTest) {
+  // null bitmap (1) + id and account (4 + 4) + two char end offsets (2 + 2) + chars
+  ASSERT_EQ(13, schema_->GetFixedSize());
+  ASSERT_EQ(1, schema_->GetFieldOffset(0));
+  ASSERT_EQ(5, schema_->GetFieldOffset(2));
+  ASSERT_EQ(9, schema_->GetFieldOffset(1));
+  ASSERT_EQ(11, schema_->GetFieldOffset(3));
+  char buf[PAGE_SIZE];
+  for (int mask = 0; mask < 16; mask++) {
+    std::vector<Field> fields = MakeRowFields(mask);
+    Row row(fields);
+    uint32_t size = row.GetSerializedSize(schema_.get());
+    ASSERT_EQ(size, row.SerializeTo(buf, schema_.get()));
+    ASSERT_LT(size, SerializeLegacy(fields, schema_.get(), buf + size));
+    Row other(INVALID_ROWID);
+    ASSERT_EQ(size, other.DeserializeFrom(buf, schema_.get()));
+    for (uint32_t i = 0; i < fields.size(); i++) {
+      ASSERT_EQ(fields[i].IsNull(), other.GetField(i)->IsNull());
+      if (!fields[i].IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, other.GetField(i)->CompareEquals(fields[i]));
+      }
+    }
+  }
+}
+
+/**
+ * A page written in the legacy format stays readable, and rows inserted or updated in it afterwards use the
+ * compact format next to the legacy ones
+ */
+TEST_F(RowFormatTest, LegacyPageTest) {
+  // lay out the page by hand: slot count at 20, then (offset, size) pairs from 24, tuples from the page end
+  char *data = table_page_.GetData();
+  uint32_t free_space = PAGE_SIZE;
+  for (uint32_t mask = 0; mask < 16; mask++) {
+    char buf[PAGE_SIZE];
+    uint32_t size = SerializeLegacy(MakeRowFields(mask), schema_.get(), buf);
+    free_space -= size;
+    memcpy(data + free_space, buf, size);
+    MACH_WRITE_UINT32(data + 24 + 8 * mask, free_space);
+    MACH_WRITE_UINT32(data + 28 + 8 * mask, size);
+  }
+  MACH_WRITE_UINT32(data + 16, free_space);
+  MACH_WRITE_UINT32(data + 20, 16);
+  for (uint32_t mask = 0; mask < 16; mask++) {
+    CheckTuple(table_page_, schema_.get(), RowId(0, mask), MakeRowFields(mask));
+  }
+
+  // update legacy tuples in place, they are rewritten in the compact format
+  for (uint32_t mask = 0; mask < 16; mask += 3) {
+    std::vector<Field> fields = MakeRowFields(15 - mask);
+    Row new_row(fields);
+    Row old_row(RowId(0, mask));
+    ASSERT_EQ(UpdateTablePageStatus::completed,
+              table_page_.UpdateTuple(new_row, &old_row, schema_.get(), nullptr, nullptr, nullptr));
+    uint32_t size;
+    RowFormat format;
+    ASSERT_TRUE(table_page_.GetTupleData(RowId(0, mask), &size, &format) != nullptr);
+    ASSERT_EQ(RowFormat::kCompact, format);
+  }
+  std::vector<Field> fields = MakeRowFields(6);
+  Row row(fields);
+  ASSERT_TRUE(table_page_.InsertTuple(row, schema_.get(), nullptr, nullptr, nullptr));
+  ASSERT_EQ(RowId(0, 16), row.GetRowId());
+  ASSERT_TRUE(table_page_.MarkDelete(RowId(0, 4), nullptr, nullptr, nullptr));
+  table_page_.ApplyDelete(RowId(0, 4), nullptr, nullptr);
+
+  for (uint32_t mask = 0; mask < 16; mask++) {
+    if (mask != 4) {
+      CheckTuple(table_page_, schema_.get(), RowId(0, mask), MakeRowFields(mask % 3 == 0 ? 15 - mask : mask));
+    }
+  }
+  CheckTuple(table_page_, schema_.get(), RowId(0, 16), MakeRowFields(6));
+}
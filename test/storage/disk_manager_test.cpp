@@ -1,4 +1,11 @@
+#include <chrono>
+#include <deque>
+#include <future>
+#include <random>
+#include <sys/stat.h>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "storage/disk_manager.h"
@@ -73,5 +80,286 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE - 5, meta_page->GetAllocatedPages());
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
+  // freed pages are handed out again before the file grows
+  const page_id_t extent_size = DiskManager::BITMAP_SIZE;
+  std::unordered_set<page_id_t> freed{0, extent_size - 1, extent_size, extent_size + 1, extent_size + 2};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(1, freed.erase(disk_mgr->AllocatePage()));
+  }
+  EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE, meta_page->GetAllocatedPages());
+  EXPECT_EQ(extent_nums, meta_page->GetExtentNums());
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, BackendCompatibilityTest) {
+  std::string db_name = "disk_backend_test.db";
+  remove(db_name.c_str());
+  const int num_pages = 64;
+  char data[PAGE_SIZE];
+  auto *disk_mgr = new DiskManager(db_name, DiskBackend::kPosix);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id = disk_mgr->AllocatePage();
+    ASSERT_EQ(i, page_id);
+    memset(data, 0, PAGE_SIZE);
+    snprintf(data, PAGE_SIZE, "page %d", page_id);
+    disk_mgr->WritePage(page_id, data);
+  }
+  // a page past the end of the file reads as zeros
+  disk_mgr->ReadPage(num_pages + 100, data);
+  EXPECT_EQ(0, data[0]);
+  delete disk_mgr;
+
+  // pages written through pread/pwrite are readable by the fstream backend and vice versa
+  disk_mgr = new DiskManager(db_name, DiskBackend::kFStream);
+  auto meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages, meta_page->GetAllocatedPages());
+  char expected[PAGE_SIZE];
+  for (page_id_t i = 0; i < num_pages; i++) {
+    disk_mgr->ReadPage(i, data);
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_STREQ(expected, data);
+  }
+  snprintf(data, PAGE_SIZE, "rewritten");
+  disk_mgr->WritePage(0, data);
+  delete disk_mgr;
+
+  disk_mgr = new DiskManager(db_name, DiskBackend::kPosix);
+  disk_mgr->ReadPage(0, data);
+  EXPECT_STREQ("rewritten", data);
+  EXPECT_EQ(num_pages, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+namespace {
+/**
+ * Write a meta page claiming the first num_full_extents extents are full, as if the database had grown that far.
+ * Their bitmap pages are never read since the meta page says there is nothing to allocate, so the file stays sparse.
+ */
+void CreateGrownDatabase(const std::string &db_name, uint32_t num_full_extents) {
+  remove(db_name.c_str());
+  char meta_data[PAGE_SIZE];
+  memset(meta_data, 0, PAGE_SIZE);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data);
+  meta_page->num_extents_ = num_full_extents;
+  meta_page->num_allocated_pages_ = num_full_extents * DiskManager::BITMAP_SIZE;
+  for (uint32_t i = 0; i < num_full_extents; i++) {
+    meta_page->extent_used_page_[i] = DiskManager::BITMAP_SIZE;
+  }
+  std::ofstream file(db_name, std::ios::binary | std::ios::out);
+  file.write(meta_data, PAGE_SIZE);
+}
+
+/**
+ * Allocate a page past the full extents, write it and check it survives a restart
+ */
+void CheckGrownDatabase(const std::string &db_name, uint32_t num_full_extents, size_t min_file_size) {
+  CreateGrownDatabase(db_name, num_full_extents);
+  auto *disk_mgr = new DiskManager(db_name);
+  page_id_t page_id = disk_mgr->AllocatePage();
+  ASSERT_EQ(num_full_extents * DiskManager::BITMAP_SIZE, page_id);
+  char data[PAGE_SIZE];
+  memset(data, 0, PAGE_SIZE);
+  snprintf(data, PAGE_SIZE, "page %d", page_id);
+  disk_mgr->WritePage(page_id, data);
+  delete disk_mgr;
+
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  LOG(INFO) << "logical file size: " << stat_buf.st_size / (1024 * 1024 * 1024) << "GB, on disk: "
+            << stat_buf.st_blocks * 512 / 1024 << "KB" << std::endl;
+  EXPECT_GT(static_cast<size_t>(stat_buf.st_size), min_file_size);
+
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_full_extents + 1, meta_page->GetExtentNums());
+  EXPECT_EQ(num_full_extents * DiskManager::BITMAP_SIZE + 1, meta_page->GetAllocatedPages());
+  char read_data[PAGE_SIZE];
+  disk_mgr->ReadPage(page_id, read_data);
+  EXPECT_STREQ(data, read_data);
+  EXPECT_FALSE(disk_mgr->IsPageFree(page_id));
+  EXPECT_EQ(page_id + 1, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(page_id);
+  EXPECT_TRUE(disk_mgr->IsPageFree(page_id));
+  EXPECT_EQ(page_id, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * @return microseconds per page for sequential writes, random reads and random reads from several threads
+ */
+void DiskIOCost(DiskBackend backend, int num_pages, double *write_cost, double *read_cost,
+                double *parallel_read_cost) {
+  std::string db_name = "disk_io_bench.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name, backend);
+  char data[PAGE_SIZE];
+  memset(data, 'x', PAGE_SIZE);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < num_pages; i++) {
+    page_ids.push_back(disk_mgr->AllocatePage());
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : page_ids) {
+    disk_mgr->WritePage(page_id, data);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  *write_cost = static_cast<double>(elapsed.count()) / num_pages;
+  disk_mgr->Sync();
+
+  std::mt19937 rng(0);
+  std::shuffle(page_ids.begin(), page_ids.end(), rng);
+  start = std::chrono::steady_clock::now();
+  for (auto page_id : page_ids) {
+    disk_mgr->ReadPage(page_id, data);
+  }
+  elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  *read_cost = static_cast<double>(elapsed.count()) / num_pages;
+
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  start = std::chrono::steady_clock::now();
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      char buf[PAGE_SIZE];
+      for (size_t i = t; i < page_ids.size(); i += num_threads) {
+        disk_mgr->ReadPage(page_ids[i], buf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  *parallel_read_cost = static_cast<double>(elapsed.count()) / num_pages;
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+}  // namespace
+
+TEST(DiskManagerTest, SparseFileGrowthTest) {
+  const size_t GB = 1024UL * 1024 * 1024;
+  // 420 extents of 4KB pages are past 50GB
+  CheckGrownDatabase("disk_sparse_test.db", 420, 50 * GB);
+  // the first meta page is full, extents go on in the next group
+  CheckGrownDatabase("disk_sparse_test.db", DiskFileMetaPage::EXTENTS_PER_META_PAGE, 125 * GB);
+}
+
+TEST(DiskManagerTest, DISABLED_PageAllocationBenchmark) {
+  std::string db_name = "disk_alloc_bench.db";
+  remove(db_name.c_str());
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE * 2;
+  auto *disk_mgr = new DiskManager(db_name);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  double allocate_cost = static_cast<double>(elapsed.count()) / num_pages;
+  // free every other page, then allocate them again
+  start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < num_pages; i += 2) {
+    disk_mgr->DeAllocatePage(i);
+  }
+  for (uint32_t i = 0; i < num_pages; i += 2) {
+    disk_mgr->AllocatePage();
+  }
+  elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  double reuse_cost = static_cast<double>(elapsed.count()) / num_pages;
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages, meta_page->GetAllocatedPages());
+  LOG(INFO) << "allocate: " << allocate_cost << "ns/page, deallocate and reallocate: " << reuse_cost << "ns/page"
+            << std::endl;
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, DISABLED_DiskIOBenchmark) {
+  const int num_pages = 8192;
+  double write_cost, read_cost, parallel_read_cost;
+  DiskIOCost(DiskBackend::kFStream, num_pages, &write_cost, &read_cost, &parallel_read_cost);
+  LOG(INFO) << "fstream     write: " << write_cost << "us/page, read: " << read_cost
+            << "us/page, 4 thread read: " << parallel_read_cost << "us/page" << std::endl;
+  DiskIOCost(DiskBackend::kPosix, num_pages, &write_cost, &read_cost, &parallel_read_cost);
+  LOG(INFO) << "pread/pwrite write: " << write_cost << "us/page, read: " << read_cost
+            << "us/page, 4 thread read: " << parallel_read_cost << "us/page" << std::endl;
+}
+
+TEST(DiskManagerTest, AsyncReadWriteTest) {
+  std::string db_name = "disk_async_test.db";
+  remove(db_name.c_str());
+  const int num_pages = 256;
+  auto *disk_mgr = new DiskManager(db_name);
+  LOG(INFO) << "asynchronous I/O engine: " << disk_mgr->GetAsyncIOName() << std::endl;
+  std::vector<char> data(num_pages * PAGE_SIZE);
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    snprintf(data.data() + i * PAGE_SIZE, PAGE_SIZE, "page %d", i);
+    futures.push_back(disk_mgr->WritePageAsync(i, data.data() + i * PAGE_SIZE));
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+  futures.clear();
+  std::vector<char> read_data(num_pages * PAGE_SIZE, 'x');
+  for (int i = num_pages - 1; i >= 0; i--) {
+    futures.push_back(disk_mgr->ReadPageAsync(i, read_data.data() + i * PAGE_SIZE));
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+  EXPECT_EQ(0, memcmp(data.data(), read_data.data(), data.size()));
+  // a page past the end of the file reads as zeros
+  char page[PAGE_SIZE];
+  memset(page, 'x', PAGE_SIZE);
+  disk_mgr->ReadPageAsync(num_pages + 100, page).wait();
+  EXPECT_EQ(0, page[0]);
+  EXPECT_EQ(0, page[PAGE_SIZE - 1]);
+  delete disk_mgr;
+
+  disk_mgr = new DiskManager(db_name);
+  disk_mgr->ReadPage(num_pages - 1, page);
+  EXPECT_STREQ(data.data() + (num_pages - 1) * PAGE_SIZE, page);
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, DISABLED_AsyncReadIOPSBenchmark) {
+  std::string db_name = "disk_async_bench.db";
+  remove(db_name.c_str());
+  const int num_pages = 8192;
+  const int num_reads = 16384;
+  auto *disk_mgr = new DiskManager(db_name);
+  char page[PAGE_SIZE];
+  memset(page, 'x', PAGE_SIZE);
+  for (int i = 0; i < num_pages; i++) {
+    disk_mgr->WritePage(disk_mgr->AllocatePage(), page);
+  }
+  disk_mgr->Sync();
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+  for (size_t queue_depth : {1, 8, 32}) {
+    std::vector<char> buffers(queue_depth * PAGE_SIZE);
+    std::deque<std::future<void>> in_flight;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reads; i++) {
+      // keep queue_depth requests in flight, each slot reuses its buffer
+      if (in_flight.size() == queue_depth) {
+        in_flight.front().wait();
+        in_flight.pop_front();
+      }
+      char *buf = buffers.data() + (i % queue_depth) * PAGE_SIZE;
+      in_flight.push_back(disk_mgr->ReadPageAsync(dist(rng), buf));
+    }
+    for (auto &future : in_flight) {
+      future.wait();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << disk_mgr->GetAsyncIOName() << " queue depth " << queue_depth << ": "
+              << static_cast<double>(num_reads) * 1000000 / elapsed.count() << " IOPS" << std::endl;
+  }
+  delete disk_mgr;
   remove(db_name.c_str());
 }
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -100,4 +102,172 @@ TEST(TableHeapTest, TableHeapSampleTest) {
     }
     LOG(INFO) << std::endl;
   }
-}
\ No newline at end of file
+}
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[32];
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    RandomUtils::RandomString(characters, 32);
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 32, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  engine.bpm_->CheckAllUnpinned();
+  const FreeSpaceMap &fsm = table_heap->GetFreeSpaceMap();
+  auto heap_pages = fsm.GetHeapPages();
+  ASSERT_EQ(table_heap->GetFirstPageId(), heap_pages.front());
+  ASSERT_EQ(rids.back().GetPageId(), heap_pages.back());
+  // every page but the last is (nearly) full
+  for (size_t i = 0; i + 1 < heap_pages.size(); i++) {
+    ASSERT_LT(fsm.GetFreeBytes(heap_pages[i]), 64U);
+  }
+  // free the whole first page, the next insert goes back there
+  for (auto &rid : rids) {
+    if (rid.GetPageId() == table_heap->GetFirstPageId()) {
+      table_heap->ApplyDelete(rid, nullptr);
+    }
+  }
+  ASSERT_GT(fsm.GetFreeBytes(table_heap->GetFirstPageId()), 3000U);
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, characters, 32, true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  ASSERT_EQ(table_heap->GetFirstPageId(), row.GetRowId().GetPageId());
+  // reload the heap from its persisted free space map
+  TableHeap *reloaded = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(),
+                                          table_heap->GetFreeSpaceMapPageId(), schema.get(), nullptr, nullptr, &heap);
+  ASSERT_EQ(heap_pages, reloaded->GetFreeSpaceMap().GetHeapPages());
+  for (auto page_id : heap_pages) {
+    ASSERT_NEAR(fsm.GetFreeBytes(page_id), reloaded->GetFreeSpaceMap().GetFreeBytes(page_id), 128);
+  }
+  engine.bpm_->CheckAllUnpinned();
+}
+
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int num_threads = 4;
+  const int rows_per_thread = 5000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  // Scenario: threads insert and delete at once, so they race on the free space map and on the heap chain tail.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      char characters[32];
+      RandomUtils::RandomString(characters, 32);
+      for (int i = 0; i < rows_per_thread; i++) {
+        Fields fields{Field(TypeId::kTypeInt, t * rows_per_thread + i), Field(TypeId::kTypeChar, characters, 32, true)};
+        Row row(fields);
+        ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+        if (i % 4 == 0) {
+          table_heap->ApplyDelete(row.GetRowId(), nullptr);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  engine.bpm_->CheckAllUnpinned();
+  // every row is reachable through the heap chain, and the chain is the page list of the free space map
+  std::vector<bool> found(num_threads * rows_per_thread, false);
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    Row row(it->GetRowId());
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    int id = atoi(row.GetField(0)->GetData());
+    ASSERT_FALSE(found[id]);
+    found[id] = true;
+  }
+  for (int id = 0; id < num_threads * rows_per_thread; id++) {
+    ASSERT_EQ(id % rows_per_thread % 4 != 0, found[id]);
+  }
+  std::vector<page_id_t> chain;
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    auto page = reinterpret_cast<TablePage *>(engine.bpm_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    engine.bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_EQ(chain, table_heap->GetFreeSpaceMap().GetHeapPages());
+  engine.bpm_->CheckAllUnpinned();
+}
+
+TEST(TableHeapTest, DISABLED_InsertLatencyBenchmark) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  // raise to 10M rows for a full run
+  const int max_rows = 100000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[32];
+  RandomUtils::RandomString(characters, 32);
+  int inserted = 0;
+  for (int batch = 1000; batch <= max_rows; batch *= 10) {
+    // time the last 1000 inserts before reaching each checkpoint
+    for (; inserted < batch - 1000; inserted++) {
+      Fields fields{Field(TypeId::kTypeInt, inserted), Field(TypeId::kTypeChar, characters, 32, true),
+                    Field(TypeId::kTypeFloat, 1.f)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (; inserted < batch; inserted++) {
+      Fields fields{Field(TypeId::kTypeInt, inserted), Field(TypeId::kTypeChar, characters, 32, true),
+                    Field(TypeId::kTypeFloat, 1.f)};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    LOG(INFO) << "rows: " << batch << ", heap pages: " << table_heap->GetFreeSpaceMap().GetHeapPages().size()
+              << ", insert latency: " << elapsed.count() / 1000 << "ns" << std::endl;
+  }
+  engine.bpm_->CheckAllUnpinned();
+}
+
+TEST(TableHeapTest, ReadAheadTest) {
+  // a small pool, so that most of the table is not cached when the scan starts
+  DBStorageEngine engine(db_file_name, true, 64);
+  SimpleMemHeap heap;
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[32];
+  RandomUtils::RandomString(characters, 32);
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 32, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  size_t misses = engine.bpm_->GetMissCount();
+  int count = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    Row row(it->GetRowId());
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, count)));
+    count++;
+  }
+  ASSERT_EQ(row_nums, count);
+  LOG(INFO) << "heap pages: " << table_heap->GetFreeSpaceMap().GetHeapPages().size()
+            << ", synchronous misses: " << engine.bpm_->GetMissCount() - misses
+            << ", read ahead hits: " << engine.bpm_->GetPrefetchHitCount()
+            << ", read ahead misses: " << engine.bpm_->GetPrefetchMissCount() << std::endl;
+  EXPECT_GT(engine.bpm_->GetPrefetchHitCount(), 0U);
+  engine.bpm_->CheckAllUnpinned();
+}